@@ -24,6 +24,8 @@ using service_t = sal::net::async::service_t;
 
 auto address = sal::net::ip::make_address("0.0.0.0");
 size_t thread_count = std::thread::hardware_concurrency();
+size_t batch_size = 0;
+size_t pool_growth = 0;
 
 size_t udp_header_size = address.is_v4() ? 28 : 48;
 constexpr size_t receives_per_thread = 20;
@@ -115,6 +117,50 @@ struct io_stats_t
 };
 
 
+class receive_batch_t
+{
+public:
+
+  receive_batch_t (socket_t &socket)
+    : socket_(socket)
+  {
+    io_.reserve(batch_size);
+  }
+
+
+  void start_receive_from (sal::net::async::io_ptr &&io)
+  {
+    if (!batch_size)
+    {
+      socket_.start_receive_from(std::move(io));
+      return;
+    }
+
+    io_.emplace_back(std::move(io));
+    if (io_.size() == batch_size)
+    {
+      flush();
+    }
+  }
+
+
+  void flush ()
+  {
+    if (!io_.empty())
+    {
+      socket_.start_receive_from_batch(io_.data(), io_.size());
+      io_.clear();
+    }
+  }
+
+
+private:
+
+  socket_t &socket_;
+  std::vector<sal::net::async::io_ptr> io_{};
+};
+
+
 class relay_t
 {
 public:
@@ -165,15 +211,25 @@ private:
 
   static void handle_completions (relay_t &relay) noexcept;
 
+  void on_completion (
+    sal::net::async::io_ptr &&io,
+    sal::net::async::completion_queue_t &queue,
+    receive_batch_t &client_receives,
+    receive_batch_t &peer_receives
+  );
+
   void on_client_receive (
     sal::net::async::io_ptr &&io,
     const socket_t::receive_from_t *receive_from,
-    sal::net::async::completion_queue_t &queue
+    sal::net::async::completion_queue_t &queue,
+    receive_batch_t &client_receives,
+    receive_batch_t &peer_receives
   );
 
   void on_peer_receive (
     sal::net::async::io_ptr &&io,
-    const socket_t::receive_from_t *receive_from
+    const socket_t::receive_from_t *receive_from,
+    receive_batch_t &peer_receives
   );
 
   void set_port_sharing_options (socket_t &socket)
@@ -194,26 +250,43 @@ void relay_t::start ()
     threads_.emplace_back(&relay_t::handle_completions, std::ref(*this));
   }
 
-  // continuous number of receives on 3478
+  // continuous number of receives on 3478: with pool, library keeps them
+  // outstanding, otherwise these are restarted manually
   auto client_receive_count = threads_.size() * receives_per_thread;
-  while (client_receive_count--)
+  if (pool_growth)
   {
-    client_.start_receive_from(service_.make_io());
+    client_.start_receive_from_pool(service_.make_io(),
+      client_receive_count,
+      pool_growth * client_receive_count
+    );
+  }
+  else
+  {
+    receive_batch_t client_receives{client_};
+    while (client_receive_count--)
+    {
+      client_receives.start_receive_from(service_.make_io());
+    }
+    client_receives.flush();
   }
 
   // initial number of receives on 3479
   // with each new session, add one more (on_client_receive)
+  receive_batch_t peer_receives{peer_};
   auto initial_peer_receive_count = receives_per_thread;
   while (initial_peer_receive_count--)
   {
-    peer_.start_receive_from(service_.make_io());
+    peer_receives.start_receive_from(service_.make_io());
   }
+  peer_receives.flush();
 }
 
 
 void relay_t::on_client_receive (sal::net::async::io_ptr &&io,
   const socket_t::receive_from_t *receive_from,
-  sal::net::async::completion_queue_t &queue)
+  sal::net::async::completion_queue_t &queue,
+  receive_batch_t &client_receives,
+  receive_batch_t &peer_receives)
 {
   if (receive_from->transferred == sizeof(session_map::key_type))
   {
@@ -230,16 +303,20 @@ void relay_t::on_client_receive (sal::net::async::io_ptr &&io,
     ++io_stats_.sessions;
 
     // start new receive_from for each new session
-    peer_.start_receive_from(queue.make_io());
+    peer_receives.start_receive_from(queue.make_io());
   }
 
-  // restart completed receive_from
-  client_.start_receive_from(std::move(io));
+  // restart completed receive_from (pooled ones are replaced by library)
+  if (!pool_growth)
+  {
+    client_receives.start_receive_from(std::move(io));
+  }
 }
 
 
 void relay_t::on_peer_receive (sal::net::async::io_ptr &&io,
-  const socket_t::receive_from_t *receive_from)
+  const socket_t::receive_from_t *receive_from,
+  receive_batch_t &peer_receives)
 {
   if (receive_from->transferred >= sizeof(session_map::key_type))
   {
@@ -259,7 +336,59 @@ void relay_t::on_peer_receive (sal::net::async::io_ptr &&io,
   }
 
   // unknown data arrived at peer port, ignore and start new receive_from()
-  peer_.start_receive_from(std::move(io));
+  peer_receives.start_receive_from(std::move(io));
+}
+
+
+void relay_t::on_completion (sal::net::async::io_ptr &&io,
+  sal::net::async::completion_queue_t &queue,
+  receive_batch_t &client_receives,
+  receive_batch_t &peer_receives)
+{
+  std::error_code error;
+
+  if (auto receive_from = io->get_if<socket_t::receive_from_t>(error))
+  {
+    auto &io_stats = io_stats_.received;
+
+    if (!error)
+    {
+      ++io_stats.packets;
+      io_stats.bytes += receive_from->transferred + udp_header_size;
+    }
+    else
+    {
+      ++io_stats.errors;
+    }
+
+    if (io->socket_context<socket_t>() == &peer_)
+    {
+      on_peer_receive(std::move(io), receive_from, peer_receives);
+    }
+    else
+    {
+      on_client_receive(std::move(io), receive_from, queue,
+        client_receives,
+        peer_receives
+      );
+    }
+  }
+  else if (auto send = io->get_if<socket_t::send_t>(error))
+  {
+    auto &io_stats = io_stats_.sent;
+    if (!error)
+    {
+      ++io_stats.packets;
+      io_stats.bytes += send->transferred + udp_header_size;
+    }
+    else
+    {
+      ++io_stats.errors;
+    }
+
+    io->reset();
+    peer_receives.start_receive_from(std::move(io));
+  }
 }
 
 
@@ -267,57 +396,48 @@ void relay_t::handle_completions (relay_t &relay) noexcept
 {
   auto &service = relay.service_;
   sal::net::async::completion_queue_t queue(service);
-  std::error_code error;
 
-  for (auto io = queue.try_get();  /**/;  io = queue.try_get())
+  // with batch_size > 0, restarted receives are collected and started
+  // together when batch is full or there are no more completions
+  receive_batch_t client_receives{relay.client_}, peer_receives{relay.peer_};
+
+  if (!batch_size)
   {
-    if (io)
+    for (auto io = queue.try_get();  /**/;  io = queue.try_get())
     {
-      if (auto receive_from = io->get_if<socket_t::receive_from_t>(error))
+      if (io)
       {
-        auto &io_stats = relay.io_stats_.received;
-
-        if (!error)
-        {
-          ++io_stats.packets;
-          io_stats.bytes += receive_from->transferred + udp_header_size;
-        }
-        else
-        {
-          ++io_stats.errors;
-          error.clear();
-        }
-
-        if (io->socket_context<socket_t>() == &relay.peer_)
-        {
-          relay.on_peer_receive(std::move(io), receive_from);
-        }
-        else
-        {
-          relay.on_client_receive(std::move(io), receive_from, queue);
-        }
+        relay.on_completion(std::move(io), queue,
+          client_receives,
+          peer_receives
+        );
       }
-      else if (auto send = io->get_if<socket_t::send_t>(error))
+      else
       {
-        auto &io_stats = relay.io_stats_.sent;
-        if (!error)
-        {
-          ++io_stats.packets;
-          io_stats.bytes += send->transferred + udp_header_size;
-        }
-        else
-        {
-          ++io_stats.errors;
-          error.clear();
-        }
-
-        io->reset();
-        relay.peer_.start_receive_from(std::move(io));
+        queue.wait();
       }
     }
-    else
+  }
+
+  // with batching, completions are also taken from queue in batches
+  sal::net::async::io_ptr completed[64];
+  for (;;)
+  {
+    auto count = queue.try_get_many(completed);
+    if (!count)
     {
+      client_receives.flush();
+      peer_receives.flush();
       queue.wait();
+      continue;
+    }
+
+    for (auto &io: sal::span_t<sal::net::async::io_ptr>{completed, count})
+    {
+      relay.on_completion(std::move(io), queue,
+        client_receives,
+        peer_receives
+      );
     }
   }
 }
@@ -342,6 +462,22 @@ void setup_and_print_options (
   );
   sal_throw_if(thread_count < 1);
   std::cout << thread_count << '\n';
+
+  std::cout << std::setw(align) << "batch: ";
+  batch_size = std::stoul(
+    options.back_or_default("batch", {arguments})
+  );
+  sal_throw_if(batch_size > receives_per_thread);
+  std::cout << (batch_size ? std::to_string(batch_size) : "disabled") << '\n';
+
+  std::cout << std::setw(align) << "pool: ";
+  pool_growth = std::stoul(
+    options.back_or_default("pool", {arguments})
+  );
+  sal_throw_if(pool_growth && batch_size);
+  std::cout
+    << (pool_growth ? "up to " + std::to_string(pool_growth) + 'x' : "disabled")
+    << '\n';
 }
 
 
@@ -369,6 +505,19 @@ option_set_t options ()
         " (default " + std::to_string(thread_count) + ')'
       )
     )
+    .add({"b", "batch"},
+      requires_argument("INT", batch_size),
+      help("restart receives in batches of INT operations and take"
+        " completions from queue in batches (default 0, i.e. one by one)"
+      )
+    )
+    .add({"p", "pool"},
+      requires_argument("INT", pool_growth),
+      help("keep client receives outstanding using receive pool that grows"
+        " up to INT times initial depth (default 0, i.e. disabled;"
+        " can't be used with batch)"
+      )
+    )
   ;
   return desc;
 }
@@ -135,6 +135,9 @@ long bio_t::ctrl (BIO *, int cmd, long, void *) noexcept
 {
   switch (cmd)
   {
+    case BIO_CTRL_FLUSH:
+      return 1;
+
     case BIO_CTRL_PENDING:
     case BIO_CTRL_WPENDING:
       return 0;
@@ -150,7 +153,9 @@ long bio_t::ctrl (BIO *, int cmd, long, void *) noexcept
 #endif
   }
 
-  return 1;
+  // unsupported command: claiming success for queries with out-parameters
+  // (i.e. BIO_CTRL_GET_KTLS_SEND) makes OpenSSL bypass record layer
+  return 0;
 }
 
 
@@ -35,6 +35,10 @@ namespace crypto {
  * application can call encrypt() to generate secret text from plain text and
  * decrypt() for reverse operation.
  *
+ * With TLSv1.3, client side is connected before server and server may
+ * follow with post-handshake messages (i.e. session tickets). These are
+ * handled by decrypt() without generating application data.
+ *
  * \see https://en.wikipedia.org/wiki/Transport_Layer_Security
  */
 class channel_t
@@ -170,6 +170,21 @@ struct buffer_t final
 };
 
 
+// feed post-handshake messages to connected \a channel, these must not
+// generate any application data
+void post_handshake (sal::crypto::channel_t &channel,
+  const std::vector<uint8_t> &data)
+{
+  SCOPED_TRACE("post_handshake");
+  if (!data.empty())
+  {
+    buffer_t<4096> plain{"plain"};
+    EXPECT_EQ(data.size(), channel.decrypt(data, plain));
+    EXPECT_TRUE(plain.data.empty());
+  }
+}
+
+
 void handshake (sal::crypto::channel_t &client,
   sal::crypto::channel_t &server,
   bool require_connected = true)
@@ -186,6 +201,14 @@ void handshake (sal::crypto::channel_t &client,
     server.handshake(client_buf.data, server_buf);
     client_buf.data.clear();
 
+    if (client.is_connected())
+    {
+      // TLSv1.3: client finishes first, server may follow with
+      // post-handshake messages (session tickets)
+      post_handshake(client, server_buf.data);
+      break;
+    }
+
     client.handshake(server_buf.data, client_buf);
     server_buf.data.clear();
   }
@@ -304,6 +327,12 @@ TYPED_TEST(crypto_channel, handshake_chunked_receive)
     chunked_feed(server, client_buf, server_buf, TestFixture::datagram);
     client_buf.data.clear();
 
+    if (client.is_connected())
+    {
+      post_handshake(client, server_buf.data);
+      break;
+    }
+
     chunked_feed(client, server_buf, client_buf, TestFixture::datagram);
     server_buf.data.clear();
   }
@@ -402,6 +431,13 @@ TYPED_TEST(crypto_channel, handshake_alloc_not_sufficient)
     server.handshake(client_buf.data, server_buf);
     client_buf.data.clear();
 
+    if (client.is_connected())
+    {
+      post_handshake(client, server_buf.data);
+      server_buf.data.clear();
+      break;
+    }
+
     client.handshake(server_buf.data, client_buf);
     server_buf.data.clear();
   }
@@ -539,6 +575,33 @@ TYPED_TEST(crypto_channel, server_encrypt_message)
 }
 
 
+TYPED_TEST(crypto_channel, encrypt_message_record)
+{
+  auto [client, server] = this->make_channel_pair();
+  handshake(client, server);
+
+  // buffer manager BIO does not support kernel offload, output must be
+  // application data record even if OpenSSL queries for it
+  buffer_t<4096> secret{"secret"};
+  client.encrypt(this->case_name, secret);
+  ASSERT_LT(3U, secret.data.size());
+  EXPECT_EQ(23, secret.data[0]);
+  if constexpr (TestFixture::datagram)
+  {
+    EXPECT_EQ(0xfe, secret.data[1]);
+  }
+  else
+  {
+    EXPECT_EQ(0x03, secret.data[1]);
+  }
+
+  buffer_t<4096> plain{"plain"};
+  server.decrypt(secret.data, plain);
+  std::string message(plain.data.begin(), plain.data.end());
+  EXPECT_EQ(this->case_name, message);
+}
+
+
 TYPED_TEST(crypto_channel, encrypt_not_connected)
 {
   auto [client, server] = this->make_channel_pair();
@@ -776,14 +839,22 @@ TYPED_TEST(crypto_channel, coalesced_server_finished_and_message)
     server_buf.data.clear();
   }
 
-  ASSERT_FALSE(client.is_connected());
   ASSERT_TRUE(server.is_connected());
   EXPECT_FALSE(server_buf.data.empty());
 
   // server_buf still has server_finished, append secret
   server.encrypt(this->case_name, server_buf);
 
-  if constexpr (openssl_version && TestFixture::datagram)
+  if (client.is_connected())
+  {
+    // TLSv1.3: client finished first, server_buf has post-handshake
+    // messages (session tickets) coalesced with secret
+    auto used = client.decrypt(server_buf.data, client_buf);
+    EXPECT_EQ(server_buf.data.size(), used);
+    std::string message(client_buf.data.begin(), client_buf.data.end());
+    EXPECT_EQ(this->case_name, message);
+  }
+  else if constexpr (openssl_version && TestFixture::datagram)
   {
     // OpenSSL DTLS correctly consumes everything (i.e. server finished and
     // message) leaving message buffered in SSL engine
@@ -1027,6 +1098,23 @@ TYPED_TEST(crypto_channel, peer_name_not_trusted)
 }
 
 
+// after server rejects client certificate
+template <typename Fixture>
+void expect_client_not_connected (const sal::crypto::channel_t &client)
+{
+  if constexpr (!openssl_version || Fixture::datagram)
+  {
+    EXPECT_FALSE(client.is_connected());
+  }
+  else
+  {
+    // TLSv1.3: client finishes before server checks client certificate,
+    // failure is reported by alert to connected client
+    (void)client;
+  }
+}
+
+
 TYPED_TEST(crypto_channel, mutual_auth_success)
 {
   auto client_factory = TestFixture::client_factory(
@@ -1109,7 +1197,7 @@ TYPED_TEST(crypto_channel, mutual_auth_server_fail)
   }
   EXPECT_LT(original_chain_fail_count, chain_fail_count);
 
-  EXPECT_FALSE(client.is_connected());
+  expect_client_not_connected<TestFixture>(client);
   EXPECT_FALSE(server.is_connected());
 }
 
@@ -1138,7 +1226,7 @@ TYPED_TEST(crypto_channel, mutual_auth_no_client_cert)
     SUCCEED();
   }
 
-  EXPECT_FALSE(client.is_connected());
+  expect_client_not_connected<TestFixture>(client);
   EXPECT_FALSE(server.is_connected());
 }
 
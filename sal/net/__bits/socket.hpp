@@ -5,6 +5,9 @@
 
 #if __sal_os_macos || __sal_os_linux // {{{1
   #include <sys/socket.h>
+  #if __sal_os_linux
+    #include <netinet/udp.h>
+  #endif
 #elif __sal_os_windows // {{{1
   #include <winsock2.h>
   #include <ws2tcpip.h>
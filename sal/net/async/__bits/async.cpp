@@ -1,5 +1,10 @@
 #include <sal/net/async/__bits/async.hpp>
 #include <sal/error.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <limits>
+#include <thread>
+#include <vector>
 
 #if __sal_os_linux || __sal_os_macos
   #include <cstring>
@@ -7,7 +12,19 @@
 #endif
 
 #if __sal_os_linux
+  #include <sal/net/ip/address.hpp>
+  #include <linux/errqueue.h>
+  #include <fcntl.h>
+  #include <netinet/in.h>
+  #include <sched.h>
+  #include <linux/mempolicy.h>
   #include <sys/epoll.h>
+  #include <sys/eventfd.h>
+  #include <sys/mman.h>
+  #include <sys/syscall.h>
+  #if __sal_io_uring
+    #include <linux/io_uring.h>
+  #endif
 #elif __sal_os_macos
   #include <sys/event.h>
   #include <sys/time.h>
@@ -21,6 +38,184 @@ __sal_begin
 namespace net::async::__bits {
 
 
+namespace {
+
+// threads waiting for other thread to finish with handler: drainer to
+// release it's role (cancel_pending()) or service to cancel owner's expired
+// operations (clear_deadlines()). Waits are rare, one set serves all and
+// notifiers check handoff_waiters before touching lock.
+std::mutex handoff_mutex{};
+std::condition_variable handoff_cv{};
+std::atomic<uint32_t> handoff_waiters{};
+
+
+// predicate state must be changed and read with seq_cst ordering
+template <typename Predicate>
+void handoff_wait (Predicate done) noexcept
+{
+  handoff_waiters.fetch_add(1, std::memory_order_seq_cst);
+  {
+    std::unique_lock lock(handoff_mutex);
+    handoff_cv.wait(lock, done);
+  }
+  handoff_waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+
+inline void handoff_notify () noexcept
+{
+  if (handoff_waiters.load(std::memory_order_seq_cst))
+  {
+    // waiter checks it's predicate under lock, it is either not checked
+    // yet or already waits
+    {
+      std::lock_guard lock(handoff_mutex);
+    }
+    handoff_cv.notify_all();
+  }
+}
+
+} // namespace
+
+
+#if __sal_os_linux || __sal_os_macos
+
+namespace {
+
+// fill iov with [begin(),end()) of io and it's scatter/gather chain,
+// returning number of used entries (at most io_t::max_chain_size)
+size_t make_iov (const io_t *io, ::iovec *iov) noexcept
+{
+  size_t count = 0;
+  for (const io_base_t *it = io;  it;  it = it->chain_next)
+  {
+    iov[count].iov_base = it->begin;
+    iov[count].iov_len = it->end - it->begin;
+    ++count;
+  }
+  return count;
+}
+
+
+//
+// pending operations are finished by single drainer thread at time without
+// locking: thread that raises pending.requests from 0 becomes drainer and
+// keeps draining until no other thread has requested draining meanwhile.
+// Other threads only push operations into pending.incoming or post reactor
+// readiness into pending.events and leave work to current drainer.
+//
+
+constexpr uint64_t events_ready = uint64_t{1} << 63;
+
+
+inline void post_events (handler_t::pending_t &pending,
+  uint16_t flags,
+  uint32_t events) noexcept
+{
+  if (flags || events)
+  {
+    pending.events.fetch_or(
+      events_ready | uint64_t{flags} << 32 | events,
+      std::memory_order_release
+    );
+  }
+}
+
+
+// pending operation has to wait for readiness
+inline void count_would_block (handler_t &handler) noexcept
+{
+  handler.would_block.fetch_add(1, std::memory_order_relaxed);
+  if (auto queue = thread_queue;  queue && queue->service == handler.service)
+  {
+    completion_queue_t::count(queue->would_block);
+  }
+}
+
+
+// return true if pending list was drained by this or other thread or false
+// if operations still wait for readiness. Finish is invoked by drainer as
+// finish(flags, events) to finish list operations in order and it returns
+// true if whole list was finished.
+template <typename Finish>
+bool drain_pending (handler_t::pending_t &pending, Finish finish) noexcept
+{
+  if (pending.requests.fetch_add(1, std::memory_order_acq_rel))
+  {
+    // current drainer picks up request
+    return false;
+  }
+
+  uint32_t requests = 1;
+  auto drained = false;
+  do
+  {
+    if (pending.list.empty())
+    {
+      // nothing waits for readiness, new operations can be tried at once
+      pending.blocked = false;
+    }
+
+    while (auto io = static_cast<io_t *>(pending.incoming.try_pop()))
+    {
+      pending.list.push(io);
+    }
+
+    uint16_t flags = 0;
+    uint32_t events = 0;
+    if (auto ready = pending.events.exchange(0, std::memory_order_acquire))
+    {
+      // operations blocked at head are retried on readiness only
+      flags = static_cast<uint16_t>(ready >> 32);
+      events = static_cast<uint32_t>(ready);
+      pending.blocked = false;
+    }
+
+    if (!pending.blocked && !pending.list.empty())
+    {
+      pending.blocked = !finish(flags, events);
+    }
+
+    drained = !pending.blocked;
+  }
+  while (!pending.requests.compare_exchange_weak(requests, 0,
+      std::memory_order_seq_cst,
+      std::memory_order_acquire));
+
+  handoff_notify();
+  return drained;
+}
+
+
+inline void complete (io_t *io, io_t::completed_list_t *queue) noexcept
+{
+  if (queue)
+  {
+    io->completed(*queue);
+  }
+  else
+  {
+    io->completed();
+  }
+}
+
+} // namespace
+
+#endif
+
+
+namespace {
+
+// canceled pooled receives are not replaced anymore
+inline void stop_receive_pool (handler_t &handler) noexcept
+{
+  handler.receive_pool.depth.store(0, std::memory_order_relaxed);
+  handler.receive_pool.posted.store(0, std::memory_order_relaxed);
+}
+
+} // namespace
+
+
 #if __sal_os_windows //{{{1
 
 
@@ -30,12 +225,17 @@ using net::__bits::winsock;
 constexpr DWORD acceptex_address_size = sizeof(sockaddr_storage) + 16;
 
 
-inline WSABUF make_buf (io_t *io) noexcept
+// fill buf[] from io and it's chained io_t, return number of used entries
+inline DWORD make_bufs (io_t *io, WSABUF *buf) noexcept
 {
-  WSABUF result;
-  result.buf = reinterpret_cast<CHAR *>(io->begin);
-  result.len = static_cast<ULONG>(io->end - io->begin);
-  return result;
+  DWORD count = 0;
+  for (io_base_t *it = io;  it;  it = it->chain_next)
+  {
+    buf[count].buf = reinterpret_cast<CHAR *>(it->begin);
+    buf[count].len = static_cast<ULONG>(it->end - it->begin);
+    ++count;
+  }
+  return count;
 }
 
 
@@ -86,6 +286,7 @@ bool finish (io_t *io) noexcept
   switch (auto e = ::WSAGetLastError())
   {
     case WSAENOTSOCK:
+    case WSA_OPERATION_ABORTED:
       io->status = std::make_error_code(std::errc::operation_canceled);
       break;
 
@@ -184,17 +385,20 @@ service_t::~service_t () noexcept
 }
 
 
-bool completion_queue_t::wait (const std::chrono::milliseconds &timeout,
+bool completion_queue_t::wait_io (const std::chrono::milliseconds &timeout,
   std::error_code &error) noexcept
 {
-  constexpr DWORD max_events = 256;
-  ::OVERLAPPED_ENTRY events[max_events];
+  ::OVERLAPPED_ENTRY stack_events[default_max_events];
+  auto events = max_events > default_max_events
+    ? reinterpret_cast<::OVERLAPPED_ENTRY *>(event_buffer.get())
+    : stack_events
+  ;
   ULONG events_count;
 
   auto succeeded = ::GetQueuedCompletionStatusEx(
     service->iocp,
     events,
-    max_events,
+    static_cast<ULONG>(max_events),
     &events_count,
     static_cast<DWORD>(timeout.count()),
     false
@@ -202,9 +406,17 @@ bool completion_queue_t::wait (const std::chrono::milliseconds &timeout,
 
   if (succeeded)
   {
-    for (auto event = &events[0];  event != &events[0] + events_count;  ++event)
+    count(this->events, events_count);
+    for (auto event = events;  event != events + events_count;  ++event)
     {
       auto io = reinterpret_cast<io_t *>(event->lpOverlapped);
+      if (!io)
+      {
+        // posted wakeup, io is already in queue
+        reinterpret_cast<wakeup_t *>(event->lpCompletionKey)
+          ->signaled.store(false, std::memory_order_relaxed);
+        continue;
+      }
       (*io->on_finish)(io);
       io->completed(completed_list);
     }
@@ -224,7 +436,66 @@ bool completion_queue_t::wait (const std::chrono::milliseconds &timeout,
 }
 
 
+completion_queue_t::completion_queue_t (service_ptr service, bool)
+  : completion_queue_t(service)
+{
+  // IOCP already dispatches completions to waiting threads in LIFO order,
+  // there is no separate per-queue reactor
+}
+
+
+void completion_queue_t::pin_thread (size_t cpu, std::error_code &error)
+  noexcept
+{
+  if (cpu >= sizeof(DWORD_PTR) * 8)
+  {
+    error = std::make_error_code(std::errc::invalid_argument);
+  }
+  else if (::SetThreadAffinityMask(::GetCurrentThread(), DWORD_PTR{1} << cpu))
+  {
+    error.clear();
+  }
+  else
+  {
+    error.assign(::GetLastError(), std::system_category());
+  }
+}
+
+
+bool completion_queue_t::poll_io (std::error_code &error) noexcept
+{
+  return wait_io(std::chrono::milliseconds::zero(), error);
+}
+
+
+void completion_queue_t::set_max_events (size_t count)
+{
+  std::unique_ptr<std::byte[]> buffer{};
+  if (count > default_max_events)
+  {
+    buffer.reset(new std::byte[count * sizeof(::OVERLAPPED_ENTRY)]);
+  }
+  event_buffer = std::move(buffer);
+  max_events = count;
+}
+
+
+namespace {
+
+inline void notify (service_t &service, wakeup_t &wakeup) noexcept
+{
+  (void)::PostQueuedCompletionStatus(service.iocp,
+    0,
+    reinterpret_cast<ULONG_PTR>(&wakeup),
+    nullptr
+  );
+}
+
+} // namespace
+
+
 handler_t::handler_t (service_ptr service,
+    completion_queue_t *,
     socket_t &socket,
     std::error_code &error) noexcept
   : service(service)
@@ -245,18 +516,33 @@ handler_t::handler_t (service_ptr service,
 
 handler_t::~handler_t () noexcept
 {
+  if (has_deadlines.load(std::memory_order_relaxed))
+  {
+    service->clear_deadlines(this);
+  }
   socket.handle = socket.invalid;
 }
 
 
-void handler_t::start_receive_from (io_t *io,
+namespace {
+
+bool finish_receive_from_pooled (io_t *io) noexcept
+{
+  auto result = finish(io);
+  io->owner->replenish_receive_pool(io);
+  return result;
+}
+
+
+void start_receive_from (handler_t &handler,
+  io_t *io,
   void *remote_endpoint,
   size_t remote_endpoint_capacity,
   size_t *transferred,
   message_flags_t *flags) noexcept
 {
-  io->owner = this;
-  io->on_finish = finish;
+  io->owner = &handler;
+  handler.count_started();
   io->transferred = transferred;
   io->flags = flags;
 
@@ -264,11 +550,12 @@ void handler_t::start_receive_from (io_t *io,
     static_cast<INT>(remote_endpoint_capacity);
 
   DWORD received;
-  auto buf = make_buf(io);
+  WSABUF buf[io_t::max_chain_size];
+  auto buf_count = make_bufs(io, buf);
   auto result = ::WSARecvFrom(
-    socket.handle,
-    &buf,
-    1,
+    handler.socket.handle,
+    buf,
+    buf_count,
     &received,
     io->flags,
     static_cast<sockaddr *>(remote_endpoint),
@@ -285,22 +572,60 @@ void handler_t::start_receive_from (io_t *io,
   io_result_handle(io, result);
 }
 
+} // namespace
+
+
+void handler_t::start_receive_from (io_t *io,
+  void *remote_endpoint,
+  size_t remote_endpoint_capacity,
+  size_t *transferred,
+  message_flags_t *flags) noexcept
+{
+  io->on_finish = finish;
+  start_receive_from(*this,
+    io,
+    remote_endpoint,
+    remote_endpoint_capacity,
+    transferred,
+    flags
+  );
+}
+
+
+void handler_t::start_pooled_receive_from (io_t *io,
+  void *remote_endpoint,
+  size_t remote_endpoint_capacity,
+  size_t *transferred,
+  message_flags_t *flags) noexcept
+{
+  io->on_finish = finish_receive_from_pooled;
+  start_receive_from(*this,
+    io,
+    remote_endpoint,
+    remote_endpoint_capacity,
+    transferred,
+    flags
+  );
+}
+
 
 void handler_t::start_receive (io_t *io,
   size_t *transferred,
   message_flags_t *flags) noexcept
 {
   io->owner = this;
+  count_started();
   io->on_finish = finish_receive;
   io->transferred = transferred;
   io->flags = flags;
 
   DWORD received;
-  auto buf = make_buf(io);
+  WSABUF buf[io_t::max_chain_size];
+  auto buf_count = make_bufs(io, buf);
   auto result = ::WSARecv(
     socket.handle,
-    &buf,
-    1,
+    buf,
+    buf_count,
     &received,
     io->flags,
     &io->overlapped,
@@ -328,16 +653,18 @@ void handler_t::start_send_to (io_t *io,
   message_flags_t flags) noexcept
 {
   io->owner = this;
+  count_started();
   io->on_finish = finish;
   io->transferred = transferred;
   io->flags = &io->pending.send_to.flags;
 
   DWORD sent;
-  auto buf = make_buf(io);
+  WSABUF buf[io_t::max_chain_size];
+  auto buf_count = make_bufs(io, buf);
   auto result = ::WSASendTo(
     socket.handle,
-    &buf,
-    1,
+    buf,
+    buf_count,
     &sent,
     flags,
     static_cast<const sockaddr *>(remote_endpoint),
@@ -360,16 +687,18 @@ void handler_t::start_send (io_t *io,
   message_flags_t flags) noexcept
 {
   io->owner = this;
+  count_started();
   io->on_finish = finish;
   io->transferred = transferred;
   io->flags = &io->pending.send.flags;
 
   DWORD sent;
-  auto buf = make_buf(io);
+  WSABUF buf[io_t::max_chain_size];
+  auto buf_count = make_bufs(io, buf);
   auto result = ::WSASend(
     socket.handle,
-    &buf,
-    1,
+    buf,
+    buf_count,
     &sent,
     flags,
     &io->overlapped,
@@ -390,6 +719,7 @@ void handler_t::start_accept (io_t *io,
   socket_t::handle_t *socket_handle) noexcept
 {
   io->owner = this;
+  count_started();
   io->on_finish = finish_accept;
   io->transferred = &io->pending.accept.unused_transferred;
   io->flags = &io->pending.accept.unused_flags;
@@ -410,7 +740,7 @@ void handler_t::start_accept (io_t *io,
   auto success = winsock.AcceptEx(
     socket.handle,
     *io->pending.accept.socket_handle,
-    io->data,
+    io->data(),
     0,
     0,
     acceptex_address_size,
@@ -439,6 +769,7 @@ void handler_t::start_connect (io_t *io,
   size_t remote_endpoint_size) noexcept
 {
   io->owner = this;
+  count_started();
   io->on_finish = finish_connect;
   io->transferred = &io->pending.connect.unused_transferred;
   io->flags = &io->pending.connect.unused_flags;
@@ -469,6 +800,60 @@ void handler_t::start_connect (io_t *io,
 }
 
 
+void handler_t::start_receive_from_batch (io_t **io, size_t count) noexcept
+{
+  for (auto it = io;  it != io + count;  ++it)
+  {
+    auto &pending = (*it)->pending.receive_from;
+    start_receive_from(*it,
+      pending.remote_endpoint,
+      pending.remote_endpoint_capacity,
+      (*it)->transferred,
+      (*it)->flags
+    );
+  }
+}
+
+
+void handler_t::start_send_to_batch (io_t **io, size_t count) noexcept
+{
+  for (auto it = io;  it != io + count;  ++it)
+  {
+    auto &pending = (*it)->pending.send_to;
+    start_send_to(*it,
+      &pending.remote_endpoint,
+      pending.remote_endpoint_size,
+      (*it)->transferred,
+      pending.flags
+    );
+  }
+}
+
+
+void handler_t::cancel (const io_t *io) noexcept
+{
+  // aborted operations are completed with WSA_OPERATION_ABORTED
+  (void)::CancelIoEx(reinterpret_cast<HANDLE>(socket.handle),
+    const_cast<OVERLAPPED *>(&io->overlapped)
+  );
+}
+
+
+void handler_t::cancel_all () noexcept
+{
+  stop_receive_pool(*this);
+  (void)::CancelIoEx(reinterpret_cast<HANDLE>(socket.handle), nullptr);
+}
+
+
+bool handler_t::cancel_expired (const io_t *io) noexcept
+{
+  // if io is not pending (anymore), there is nothing to abort
+  cancel(io);
+  return true;
+}
+
+
 #elif __sal_os_linux //{{{1
 
 
@@ -481,23 +866,37 @@ inline int make_queue () noexcept
 }
 
 
-void register_handler (handler_t &handler, std::error_code &error)
-  noexcept
-{
-  handler.await_events = EPOLLET;
+using reactor_event_t = struct ::epoll_event;
 
-  struct ::epoll_event change;
-  change.data.ptr = &handler;
-  change.events = handler.await_events;
 
-  auto result = ::epoll_ctl(
-    handler.service->queue,
-    EPOLL_CTL_ADD,
-    handler.socket.handle,
-    &change
+inline int wait_events (int reactor,
+  reactor_event_t *events,
+  int max_events,
+  const std::chrono::milliseconds &timeout) noexcept
+{
+  return ::epoll_wait(
+    reactor,
+    events,
+    max_events,
+    timeout == timeout.max() ? -1 : timeout.count()
   );
+}
 
-  if (result > -1)
+
+inline bool is_nested_reactor (const reactor_event_t &event) noexcept
+{
+  return event.data.ptr == nullptr;
+}
+
+
+void nest_reactor (int reactor, int nested, std::error_code &error) noexcept
+{
+  // level-triggered: nested stays ready while it has unreported events
+  struct ::epoll_event change;
+  change.data.ptr = nullptr;
+  change.events = EPOLLIN;
+
+  if (::epoll_ctl(reactor, EPOLL_CTL_ADD, nested, &change) > -1)
   {
     error.clear();
   }
@@ -508,599 +907,4747 @@ void register_handler (handler_t &handler, std::error_code &error)
 }
 
 
-bool await_io (handler_t &handler, uint32_t await_events, std::error_code &error)
-  noexcept
+// wakeup events are tagged with lowest bit (handlers are aligned)
+inline bool is_wakeup_event (const reactor_event_t &event) noexcept
 {
-  if (handler.await_events != await_events)
-  {
-    struct ::epoll_event change;
-    change.events = handler.await_events = await_events;
-    change.data.ptr = &handler;
-
-    auto result = ::epoll_ctl(
-      handler.service->queue,
-      EPOLL_CTL_MOD,
-      handler.socket.handle,
-      &change
-    );
+  return event.data.u64 & 1;
+}
 
-    if (result < 0)
-    {
-      error.assign(errno, std::generic_category());
-      return true;
-    }
-  }
 
-  return false;
+inline wakeup_t &wakeup_of (const reactor_event_t &event) noexcept
+{
+  return *reinterpret_cast<wakeup_t *>(event.data.u64 & ~uint64_t{1});
 }
 
 
-inline bool await_read (io_t *io) noexcept
+void register_wakeup (int reactor, wakeup_t &wakeup, std::error_code &error)
+  noexcept
 {
-  if (io->status == std::errc::operation_would_block)
+  wakeup.event = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (wakeup.event == -1)
   {
-    auto &handler = *io->owner;
-    return await_io(handler, handler.await_events | EPOLLIN, io->status);
+    error.assign(errno, std::generic_category());
+    return;
   }
-  return true;
-}
 
+  // edge-triggered: each write is reported once, counter is never read
+  struct ::epoll_event change;
+  change.data.u64 = reinterpret_cast<uintptr_t>(&wakeup) | 1;
+  change.events = EPOLLIN | EPOLLET;
 
-inline bool await_write (io_t *io) noexcept
-{
-  if (io->status == std::errc::operation_would_block
-    || io->status == std::errc::no_buffer_space)
+  if (::epoll_ctl(reactor, EPOLL_CTL_ADD, wakeup.event, &change) > -1)
   {
-    auto &handler = *io->owner;
-    return await_io(handler, handler.await_events | EPOLLOUT, io->status);
+    error.clear();
+  }
+  else
+  {
+    error.assign(errno, std::generic_category());
   }
-  return true;
 }
 
 
-bool drain (handler_t::pending_t &pending,
-  uint32_t events,
-  io_t::completed_list_t &queue) noexcept
+inline void close_wakeup (wakeup_t &wakeup) noexcept
 {
-  std::lock_guard lock(pending.mutex);
-
-  while (auto io = static_cast<io_t *>(pending.list.head()))
+  if (wakeup.event != -1)
   {
-    if ((*io->on_finish)(io, 0, events))
-    {
-      (void)pending.list.try_pop();
-      io->completed(queue);
-    }
-    else
-    {
-      return false;
-    }
+    (void)::close(wakeup.event);
   }
-
-  return true;
 }
 
 
-void drain (struct ::epoll_event &event, io_t::completed_list_t &queue)
+void register_handler (handler_t &handler, std::error_code &error)
   noexcept
 {
-  auto &handler = *static_cast<handler_t *>(event.data.ptr);
-  auto await_events = handler.await_events;
+  handler.await_events = EPOLLET;
 
-  if ((event.events & EPOLLIN)
-    && drain(handler.pending_read, event.events, queue))
-  {
-    await_events &= ~EPOLLIN;
-  }
+  struct ::epoll_event change;
+  change.data.ptr = &handler;
+  change.events = handler.await_events;
+
+  auto result = ::epoll_ctl(
+    handler.reactor,
+    EPOLL_CTL_ADD,
+    handler.socket.handle,
+    &change
+  );
 
-  if ((event.events & EPOLLOUT)
-    && drain(handler.pending_write, event.events, queue))
+  if (result > -1)
   {
-    await_events &= ~EPOLLOUT;
+    error.clear();
   }
-
-  if (handler.await_events != await_events)
+  else
   {
-    std::error_code ignore_error;
-    await_io(handler, await_events, ignore_error);
+    error.assign(errno, std::generic_category());
   }
 }
 
 
-inline bool complete_connection (io_t *io, uint16_t /**/, uint32_t events)
+bool await_io (handler_t &handler, uint32_t await_events, std::error_code &error)
   noexcept
 {
-  if (events & EPOLLERR)
+  if (handler.await_events != await_events)
   {
-    int data;
-    socklen_t size = sizeof(data);
-    auto result = ::getsockopt(
-      io->owner->socket.handle,
-      SOL_SOCKET,
-      SO_ERROR,
-      &data,
-      &size
+    struct ::epoll_event change;
+    change.events = handler.await_events = await_events;
+    change.data.ptr = &handler;
+
+    auto result = ::epoll_ctl(
+      handler.reactor,
+      EPOLL_CTL_MOD,
+      handler.socket.handle,
+      &change
     );
-    if (result == 0)
-    {
-      io->status.assign(data, std::generic_category());
-    }
-    else
+
+    if (result < 0)
     {
-      io->status.assign(errno, std::generic_category());
+      error.assign(errno, std::generic_category());
+      return true;
     }
   }
-  else
+
+  return false;
+}
+
+
+inline bool await_read (io_t *io) noexcept
+{
+  if (io->status == std::errc::operation_would_block)
   {
-    io->status.clear();
+    auto &handler = *io->owner;
+    count_would_block(handler);
+    return await_io(handler, handler.await_events | EPOLLIN, io->status);
   }
-
   return true;
 }
 
 
-} // namespace
-
+inline bool await_write (io_t *io) noexcept
+{
+  if (io->status == std::errc::operation_would_block
+    || io->status == std::errc::no_buffer_space)
+  {
+    auto &handler = *io->owner;
+    count_would_block(handler);
+    return await_io(handler, handler.await_events | EPOLLOUT, io->status);
+  }
+  return true;
+}
 
-#elif __sal_os_macos //{{{1
 
+//
+// Batched receive_from/send_to: consecutive pending operations started with
+// handler_t::start_*_batch() are finished with single recvmmsg()/sendmmsg()
+// call. Each returns number of finished operations from front of io[]
+//
 
-namespace {
+using batch_t = size_t (*)(io_t **io, size_t count) noexcept;
 
 
-inline ::timespec *to_timespec (::timespec *ts,
-  const std::chrono::milliseconds &timeout) noexcept
+size_t receive_from_batch (io_t **io, size_t count) noexcept
 {
-  using namespace std::chrono;
+  ::mmsghdr message[handler_t::max_batch_size];
+  ::iovec iov[handler_t::max_batch_size];
 
-  if (timeout != (milliseconds::max)())
+  for (auto i = 0U;  i != count;  ++i)
   {
-    auto s = duration_cast<seconds>(timeout);
-    ts->tv_nsec = duration_cast<nanoseconds>(timeout - s).count();
-    ts->tv_sec = s.count();
-    return ts;
+    iov[i].iov_base = io[i]->begin;
+    iov[i].iov_len = io[i]->end - io[i]->begin;
+
+    auto &msg = message[i].msg_hdr;
+    msg = {};
+    msg.msg_iov = &iov[i];
+    msg.msg_iovlen = 1;
+    msg.msg_name = io[i]->pending.receive_from.remote_endpoint;
+    msg.msg_namelen = io[i]->pending.receive_from.remote_endpoint_capacity;
   }
-  return nullptr;
-}
 
+  auto received = ::recvmmsg(
+    io[0]->owner->socket.handle,
+    message,
+    count,
+    *io[0]->flags | MSG_NOSIGNAL,
+    nullptr
+  );
 
-inline int make_queue () noexcept
-{
-  return ::kqueue();
-}
+  if (received < 0)
+  {
+    *io[0]->transferred = 0;
+    io[0]->status.assign(errno, std::generic_category());
+    return await_read(io[0]) ? 1 : 0;
+  }
 
+  for (auto i = 0;  i != received;  ++i)
+  {
+    *io[i]->transferred = message[i].msg_len;
+    if (message[i].msg_hdr.msg_flags & MSG_TRUNC)
+    {
+      io[i]->status.assign(EMSGSIZE, std::generic_category());
+    }
+    else
+    {
+      io[i]->status.clear();
+      io[i]->pending.receive_from.remote_endpoint_capacity =
+        message[i].msg_hdr.msg_namelen;
+    }
+  }
 
-inline void register_handler (handler_t &, std::error_code &error) noexcept
-{
-  error.clear();
+  return received;
 }
 
 
-bool await_io (io_t *io, int16_t filter, uint16_t flags) noexcept
+size_t send_to_batch (io_t **io, size_t count) noexcept
 {
-  if (io->status != std::errc::operation_would_block
-    && io->status != std::errc::no_buffer_space)
+  ::mmsghdr message[handler_t::max_batch_size];
+  ::iovec iov[handler_t::max_batch_size];
+
+  for (auto i = 0U;  i != count;  ++i)
   {
-    return true;
+    iov[i].iov_base = io[i]->begin;
+    iov[i].iov_len = io[i]->end - io[i]->begin;
+
+    auto &msg = message[i].msg_hdr;
+    msg = {};
+    msg.msg_iov = &iov[i];
+    msg.msg_iovlen = 1;
+    msg.msg_name = &io[i]->pending.send_to.remote_endpoint;
+    msg.msg_namelen = io[i]->pending.send_to.remote_endpoint_size;
   }
 
-  auto &handler = *io->owner;
-
-  struct ::kevent change;
-  EV_SET(&change,
-    handler.socket.handle,
-    filter,
-    flags,
-    0,
-    0,
-    &handler
+  auto sent = ::sendmmsg(
+    io[0]->owner->socket.handle,
+    message,
+    count,
+    *io[0]->flags | MSG_NOSIGNAL
   );
 
-  auto result = ::kevent(
-    handler.service->queue,
-    &change,
-    1,
-    nullptr,
-    0,
-    nullptr
-  );
+  if (sent < 0)
+  {
+    *io[0]->transferred = 0;
+    io[0]->status.assign(
+      errno != EDESTADDRREQ ? errno : ENOTCONN,
+      std::generic_category()
+    );
+    return await_write(io[0]) ? 1 : 0;
+  }
 
-  if (result > -1)
+  for (auto i = 0;  i != sent;  ++i)
   {
-    return false;
+    *io[i]->transferred = message[i].msg_len;
+    io[i]->status.clear();
   }
 
-  io->status.assign(errno, std::generic_category());
-  return true;
+  return sent;
 }
 
 
-inline bool await_read (io_t *io) noexcept
+bool finish_receive_from_batch (io_t *io, uint16_t, uint32_t) noexcept
 {
-  return await_io(io, EVFILT_READ, EV_ADD | EV_CLEAR);
+  return receive_from_batch(&io, 1) > 0;
 }
 
 
-inline bool await_write (io_t *io) noexcept
+bool finish_send_to_batch (io_t *io, uint16_t, uint32_t) noexcept
 {
-  return await_io(io, EVFILT_WRITE, EV_ADD | EV_CLEAR);
+  return send_to_batch(&io, 1) > 0;
 }
 
 
-void drain (const struct ::kevent &event, io_t::completed_list_t &queue)
-  noexcept
+inline batch_t batch_for (const io_t *io) noexcept
 {
-  handler_t::pending_t *pending_io{};
-  if (event.filter == EVFILT_READ)
+  if (io->on_finish == finish_receive_from_batch)
   {
-    pending_io = &static_cast<handler_t *>(event.udata)->pending_read;
+    return receive_from_batch;
   }
-  else
-  {
-    pending_io = &static_cast<handler_t *>(event.udata)->pending_write;
-  }
-
-  std::lock_guard lock(pending_io->mutex);
-
-  while (auto io = static_cast<io_t *>(pending_io->list.head()))
+  else if (io->on_finish == finish_send_to_batch)
   {
-    if ((*io->on_finish)(io, event.flags, event.fflags))
-    {
-      (void)pending_io->list.try_pop();
-      io->completed(queue);
-    }
-    else
-    {
-      return;
-    }
+    return send_to_batch;
   }
+  return nullptr;
 }
 
 
-inline bool complete_connection (io_t *io, uint16_t flags, uint32_t fflags)
-  noexcept
+size_t make_batch (io_t *head, io_t **io) noexcept
 {
-  if (flags & EV_EOF)
-  {
-    io->status.assign(fflags, std::generic_category());
-  }
-  else
+  // same kind of consecutive operations with same flags
+  size_t count = 0;
+  for (auto it = head;
+    it && count != handler_t::max_batch_size
+      && it->on_finish == head->on_finish
+      && *it->flags == *head->flags;
+    it = static_cast<io_t *>(it->pending_io))
   {
-    io->status.clear();
+    io[count++] = it;
   }
-  return true;
+  return count;
 }
 
 
-} // namespace
-
-
-#endif //}}}1
-
+//
+// MSG_ZEROCOPY: successfully sent io is moved from pending_write to
+// handler_t::zerocopy_list until kernel reports (via socket error queue) it
+// has released io data
+//
 
-#if __sal_os_linux || __sal_os_macos //{{{1
+bool zerocopy_sent (io_t *, uint16_t, uint32_t) noexcept
+{
+  // marker only, never invoked
+  return false;
+}
 
 
-service_t::service_t ()
-  : queue(make_queue())
+inline bool await_zerocopy (io_t *io) noexcept
 {
-  if (queue < 0)
+  if (io->on_finish == zerocopy_sent)
   {
-    std::error_code error;
-    error.assign(errno, std::generic_category());
-    throw_system_error(error, "async::service::make_queue");
+    io->owner->zerocopy_list.push(io);
+    return true;
   }
+  return false;
 }
 
 
-service_t::~service_t () noexcept
+bool finish_send_zerocopy (io_t *io, uint16_t, uint32_t) noexcept
 {
-  (void)::close(queue);
-}
+  auto &handler = *io->owner;
+  auto &pending = io->pending.send_to;
 
+  if (!handler.zerocopy)
+  {
+    int enable = 1;
+    auto result = ::setsockopt(handler.socket.handle,
+      SOL_SOCKET,
+      SO_ZEROCOPY,
+      &enable,
+      sizeof(enable)
+    );
+    handler.zerocopy = result == 0 ? 1 : -1;
+  }
 
-bool completion_queue_t::wait (const std::chrono::milliseconds &timeout,
-  std::error_code &error) noexcept
-{
-  constexpr size_t max_events = 128;
+  auto flags = pending.flags | MSG_NOSIGNAL;
+  if (handler.zerocopy > 0)
+  {
+    // without SO_ZEROCOPY, fall back to regular send
+    flags |= MSG_ZEROCOPY;
+  }
 
-#if __sal_os_linux
+  ::iovec iov;
+  iov.iov_base = io->begin;
+  iov.iov_len = io->end - io->begin;
 
-  struct ::epoll_event events[max_events];
-  auto events_count = ::epoll_wait(
-    service->queue,
-    &events[0],
-    max_events,
-    timeout == timeout.max() ? -1 : timeout.count()
-  );
+  ::msghdr msg{};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  if (pending.remote_endpoint_size)
+  {
+    msg.msg_name = &pending.remote_endpoint;
+    msg.msg_namelen = pending.remote_endpoint_size;
+  }
 
-#elif __sal_os_macos
+  auto size = ::sendmsg(handler.socket.handle, &msg, flags);
+  if (size > -1)
+  {
+    *io->transferred = size;
+    io->status.clear();
+    if (flags & MSG_ZEROCOPY)
+    {
+      // kernel numbers zerocopy sends sequentially per socket
+      pending.zerocopy_id = handler.zerocopy_next_id++;
+      io->on_finish = zerocopy_sent;
+    }
+    return true;
+  }
 
-  ::timespec ts, *timeout_p = to_timespec(&ts, timeout);
-  struct ::kevent events[max_events];
-  auto events_count = ::kevent(
-    service->queue,
-    nullptr,
-    0,
-    &events[0],
-    max_events,
-    timeout_p
+  *io->transferred = 0;
+  io->status.assign(errno == EDESTADDRREQ ? ENOTCONN : errno,
+    std::generic_category()
   );
+  return await_write(io);
+}
 
-#endif
 
-  if (events_count > -1)
+// complete io in list with notifications from socket error queue, returning
+// true if there were any
+bool drain_zerocopy (int socket,
+  io_t::pending_list_t &list,
+  io_t::completed_list_t &queue) noexcept
+{
+  auto notified = false;
+  for (;;)
   {
-    for (auto event = &events[0];  event != &events[0] + events_count;  ++event)
+    alignas(::cmsghdr) std::byte control[
+      CMSG_SPACE(sizeof(::sock_extended_err) + sizeof(sockaddr_storage))
+    ];
+    ::msghdr msg{};
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    if (::recvmsg(socket, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) == -1)
     {
-      drain(*event, completed_list);
+      break;
+    }
+
+    for (auto cmsg = CMSG_FIRSTHDR(&msg);  cmsg;  cmsg = CMSG_NXTHDR(&msg, cmsg))
+    {
+      if (!(cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR)
+        && !(cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR))
+      {
+        continue;
+      }
+
+      ::sock_extended_err error;
+      std::memcpy(&error, CMSG_DATA(cmsg), sizeof(error));
+      if (error.ee_errno != 0 || error.ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+      {
+        continue;
+      }
+
+      // complete sends with id in range [ee_info, ee_data] (ranges may be
+      // reported out of order, keep order of remaining ones)
+      auto first = error.ee_info, count = error.ee_data - error.ee_info;
+      io_t::pending_list_t remaining{};
+      while (auto io = static_cast<io_t *>(list.try_pop()))
+      {
+        if (io->pending.send_to.zerocopy_id - first <= count)
+        {
+          io->completed(queue);
+        }
+        else
+        {
+          remaining.push(io);
+        }
+      }
+      list = std::move(remaining);
+      notified = true;
     }
-    return events_count > 0;
   }
 
-  error.assign(errno, std::generic_category());
-  return false;
+  return notified;
 }
 
 
-handler_t::handler_t (service_ptr service,
-    socket_t &socket,
-    std::error_code &error) noexcept
-  : service(service)
-  , socket(socket.handle)
+bool drain_zerocopy (handler_t &handler, io_t::completed_list_t &queue)
+  noexcept
 {
-  register_handler(*this, error);
+  std::lock_guard lock(handler.zerocopy_mutex);
+  if (handler.zerocopy < 1)
+  {
+    return false;
+  }
+  return drain_zerocopy(handler.socket.handle, handler.zerocopy_list, queue);
 }
 
 
-handler_t::~handler_t () noexcept
+//
+// Zerocopy orphan: when handler is destroyed while kernel still holds data
+// of it's zerocopy sends, socket is kept open (duplicated) and registered
+// with service's reactor until all notifications are received. Events are
+// tagged with second lowest bit (see is_wakeup_event())
+//
+
+inline bool is_zerocopy_orphan_event (const reactor_event_t &event) noexcept
 {
-  socket.handle = socket.invalid;
+  return event.data.u64 & 2;
+}
+
+
+inline zerocopy_orphan_t &zerocopy_orphan_of (const reactor_event_t &event)
+  noexcept
+{
+  return *reinterpret_cast<zerocopy_orphan_t *>(event.data.u64 & ~uint64_t{2});
+}
+
+} // namespace
+
+
+struct zerocopy_orphan_t
+{
+  service_t &service;
+  int socket = -1;
+  io_t::pending_list_t list{};
 
-  auto cancel = [](auto &pending)
+  // links in service_t::zerocopy_orphans
+  zerocopy_orphan_t *prev{}, *next{};
+
+
+  zerocopy_orphan_t (service_t &service) noexcept
+    : service(service)
+  { }
+
+
+  ~zerocopy_orphan_t () noexcept
   {
-    while (auto io = pending.list.try_pop())
+    if (socket != -1)
     {
-      io->status = std::make_error_code(std::errc::operation_canceled);
-      io->owner = nullptr;
-      io->completed();
+      (void)::close(socket);
+    }
+  }
+
+
+  // oneshot: single thread drains it at a time, until re-armed
+  bool arm (int op) noexcept
+  {
+    struct ::epoll_event change;
+    change.events = EPOLLET | EPOLLONESHOT;
+    change.data.u64 = reinterpret_cast<uintptr_t>(this) | 2;
+    return ::epoll_ctl(service.queue, op, socket, &change) > -1;
+  }
+
+
+  void unlink () noexcept
+  {
+    std::lock_guard lock(service.zerocopy_orphans_mutex);
+    (prev ? prev->next : service.zerocopy_orphans) = next;
+    if (next)
+    {
+      next->prev = prev;
+    }
+  }
+
+
+  zerocopy_orphan_t (const zerocopy_orphan_t &) = delete;
+  zerocopy_orphan_t &operator= (const zerocopy_orphan_t &) = delete;
+  zerocopy_orphan_t (zerocopy_orphan_t &&) = delete;
+  zerocopy_orphan_t &operator= (zerocopy_orphan_t &&) = delete;
+};
+
+
+namespace {
+
+// move handler's unreleased zerocopy sends into new orphan, returning false
+// if it can't be created
+bool orphan_zerocopy (handler_t &handler) noexcept
+{
+  std::lock_guard lock(handler.zerocopy_mutex);
+  if (handler.zerocopy_list.empty())
+  {
+    return true;
+  }
+
+  auto orphan = new(std::nothrow) zerocopy_orphan_t(*handler.service);
+  if (!orphan)
+  {
+    return false;
+  }
+  orphan->socket = ::fcntl(handler.socket.handle, F_DUPFD_CLOEXEC, 0);
+  if (orphan->socket == -1)
+  {
+    delete orphan;
+    return false;
+  }
+
+  // duplicate keeps socket's registration for handler alive after handler's
+  // descriptor is closed
+  (void)::epoll_ctl(handler.reactor,
+    EPOLL_CTL_DEL,
+    handler.socket.handle,
+    nullptr
+  );
+
+  while (auto io = handler.zerocopy_list.try_pop())
+  {
+    io->owner = nullptr;
+    orphan->list.push(io);
+  }
+
+  auto &service = *handler.service;
+  {
+    std::lock_guard orphans_lock(service.zerocopy_orphans_mutex);
+    if ((orphan->next = service.zerocopy_orphans))
+    {
+      orphan->next->prev = orphan;
+    }
+    service.zerocopy_orphans = orphan;
+  }
+
+  // on failure, orphan (and it's io) is released with service
+  (void)orphan->arm(EPOLL_CTL_ADD);
+  return true;
+}
+
+
+void drain (zerocopy_orphan_t &orphan, io_t::completed_list_t &queue)
+  noexcept
+{
+  (void)drain_zerocopy(orphan.socket, orphan.list, queue);
+  if (!orphan.list.empty())
+  {
+    // on failure, orphan (and it's io) is released with service
+    (void)orphan.arm(EPOLL_CTL_MOD);
+    return;
+  }
+
+  (void)::epoll_ctl(orphan.service.queue, EPOLL_CTL_DEL, orphan.socket, nullptr);
+  orphan.unlink();
+  delete &orphan;
+}
+
+
+// release orphans of destroyed service (io_t are released with it's pool)
+void release_zerocopy_orphans (service_t &service) noexcept
+{
+  while (auto orphan = service.zerocopy_orphans)
+  {
+    service.zerocopy_orphans = orphan->next;
+    delete orphan;
+  }
+}
+
+
+// finish up to *budget (null - unlimited) pending list operations in order
+// (drainer only), completing finished ones into queue (or into their own
+// completion list if null). Budget is shared by all finish calls of single
+// drain: if it is used up, list is left blocked for caller to re-arm it
+bool finish_pending (handler_t::pending_t &pending,
+  uint32_t events,
+  io_t::completed_list_t *queue,
+  size_t *budget) noexcept
+{
+  while (auto io = static_cast<io_t *>(pending.list.head()))
+  {
+    if (budget && !*budget)
+    {
+      return false;
+    }
+
+    if (auto batch = batch_for(io))
+    {
+      io_t *batch_io[handler_t::max_batch_size];
+      auto finished = batch(batch_io, make_batch(io, batch_io));
+      if (!finished)
+      {
+        return false;
+      }
+      if (budget)
+      {
+        *budget -= (std::min)(*budget, finished);
+      }
+      while (finished--)
+      {
+        complete(static_cast<io_t *>(pending.list.try_pop()), queue);
+      }
+      continue;
+    }
+
+    // zerocopy notification must not be drained between sending and moving
+    // io into zerocopy_list
+    std::unique_lock zerocopy_lock{io->owner->zerocopy_mutex, std::defer_lock};
+    if (io->on_finish == finish_send_zerocopy)
+    {
+      zerocopy_lock.lock();
+    }
+
+    if ((*io->on_finish)(io, 0, events))
+    {
+      (void)pending.list.try_pop();
+      if (!await_zerocopy(io))
+      {
+        complete(io, queue);
+      }
+      if (budget)
+      {
+        --*budget;
+      }
+    }
+    else
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+bool drain (handler_t::pending_t &pending,
+  uint16_t flags,
+  uint32_t events,
+  io_t::completed_list_t *queue,
+  size_t *budget = nullptr) noexcept
+{
+  post_events(pending, flags, events);
+  return drain_pending(pending,
+    [&pending, queue, budget](uint16_t, uint32_t events)
+    {
+      return finish_pending(pending, events, queue, budget);
+    }
+  );
+}
+
+
+// drain handler of event, finishing up to budget (0 - unlimited) operations
+// of each it's pending list. Returns true if budget was used up while
+// operations may still finish (caller re-arms handler, see rearm())
+bool drain (struct ::epoll_event &event,
+  io_t::completed_list_t &queue,
+  size_t budget) noexcept
+{
+  if (is_zerocopy_orphan_event(event))
+  {
+    drain(zerocopy_orphan_of(event), queue);
+    return false;
+  }
+
+  auto &handler = *static_cast<handler_t *>(event.data.ptr);
+  auto await_events = handler.await_events;
+
+  // released zerocopy send buffers may also let blocked sends continue
+  auto writable = (event.events & EPOLLOUT)
+    || ((event.events & EPOLLERR) && drain_zerocopy(handler, queue));
+
+  // each pending list has own budget, list left blocked with budget used up
+  // needs re-arming (and awaiting it's readiness, writes may have been
+  // unblocked by zerocopy completion only)
+  auto rearm = false;
+  auto drain_list = [&](handler_t::pending_t &pending, uint32_t await)
+  {
+    auto list_budget = budget;
+    auto limit = budget ? &list_budget : nullptr;
+    if (drain(pending, 0, event.events, &queue, limit))
+    {
+      await_events &= ~await;
+    }
+    else if (budget && !list_budget)
+    {
+      await_events |= await;
+      rearm = true;
+    }
+  };
+
+  if (event.events & EPOLLIN)
+  {
+    drain_list(handler.pending_read, EPOLLIN);
+  }
+
+  if (writable)
+  {
+    drain_list(handler.pending_write, EPOLLOUT);
+  }
+
+  if (handler.await_events != await_events)
+  {
+    std::error_code ignore_error;
+    await_io(handler, await_events, ignore_error);
+  }
+
+  return rearm;
+}
+
+
+// re-arm readiness of handler that used up it's drain budget: in
+// edge-triggered mode, modify queues new event if fd is still ready. If it
+// fails, handler is drained without budget
+void rearm (struct ::epoll_event &event, io_t::completed_list_t &queue)
+  noexcept
+{
+  auto &handler = *static_cast<handler_t *>(event.data.ptr);
+
+  struct ::epoll_event change;
+  change.events = handler.await_events;
+  change.data.ptr = &handler;
+
+  auto result = ::epoll_ctl(
+    handler.reactor,
+    EPOLL_CTL_MOD,
+    handler.socket.handle,
+    &change
+  );
+
+  if (result < 0)
+  {
+    event.events = handler.await_events & (EPOLLIN | EPOLLOUT);
+    (void)drain(event, queue, 0);
+  }
+}
+
+
+//
+// UDP GRO/GSO: segment size is passed using control messages
+//
+
+// iov has room for io_t::max_chain_size entries if io is chained (data
+// ranges of io and it's scatter/gather chain)
+void make_receive_message (io_t *io, ::msghdr &msg, ::iovec *iov) noexcept
+{
+  auto &pending = io->pending.receive_from;
+
+  msg = {};
+  msg.msg_iov = iov;
+  msg.msg_iovlen = make_iov(io, iov);
+  msg.msg_name = pending.remote_endpoint;
+  msg.msg_namelen = pending.remote_endpoint_capacity;
+  msg.msg_control = pending.control;
+  msg.msg_controllen = sizeof(pending.control);
+}
+
+
+void segmented_receive_result (io_t *io, ::msghdr &msg, size_t size) noexcept
+{
+  auto &pending = io->pending.receive_from;
+
+  *io->transferred = size;
+  *pending.segment_size = size;
+
+  if (msg.msg_flags & MSG_TRUNC)
+  {
+    io->status.assign(EMSGSIZE, std::generic_category());
+    return;
+  }
+
+  io->status.clear();
+  pending.remote_endpoint_capacity = msg.msg_namelen;
+
+  for (auto cmsg = CMSG_FIRSTHDR(&msg);  cmsg;  cmsg = CMSG_NXTHDR(&msg, cmsg))
+  {
+    if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO)
+    {
+      int segment_size;
+      std::memcpy(&segment_size, CMSG_DATA(cmsg), sizeof(segment_size));
+      *pending.segment_size = segment_size;
+      break;
     }
+  }
+}
+
+
+// iov: see make_receive_message()
+void make_segmented_send (io_t *io, ::msghdr &msg, ::iovec *iov) noexcept
+{
+  auto &pending = io->pending.send_to;
+
+  msg = {};
+  msg.msg_iov = iov;
+  msg.msg_iovlen = make_iov(io, iov);
+  msg.msg_name = &pending.remote_endpoint;
+  msg.msg_namelen = pending.remote_endpoint_size;
+  msg.msg_control = pending.control;
+  msg.msg_controllen = sizeof(pending.control);
+}
+
+
+bool finish_receive_from_segmented (io_t *io, uint16_t, uint32_t) noexcept
+{
+  ::msghdr msg;
+  ::iovec iov[io_t::max_chain_size];
+  make_receive_message(io, msg, iov);
+
+  auto size = ::recvmsg(
+    io->owner->socket.handle,
+    &msg,
+    *io->flags | MSG_NOSIGNAL
+  );
+
+  if (size > -1)
+  {
+    segmented_receive_result(io, msg, size);
+  }
+  else
+  {
+    *io->transferred = 0;
+    io->status.assign(errno, std::generic_category());
+  }
+
+  return await_read(io);
+}
+
+
+//
+// start_receive_from_with_info(): ancillary data is enabled on first use,
+// datagrams received before that are reported without it
+//
+
+void enable_receive_info (handler_t &handler) noexcept
+{
+  if (handler.receive_info.exchange(true, std::memory_order_relaxed))
+  {
+    return;
+  }
+
+  // best effort, only pktinfo option for socket's family succeeds
+  auto enable = [&handler](int level, int name)
+  {
+    int value = 1;
+    (void)::setsockopt(handler.socket.handle,
+      level,
+      name,
+      &value,
+      sizeof(value)
+    );
   };
-  cancel(pending_read);
-  cancel(pending_write);
+  enable(SOL_SOCKET, SO_TIMESTAMPNS);
+  enable(IPPROTO_IP, IP_PKTINFO);
+  enable(IPPROTO_IPV6, IPV6_RECVPKTINFO);
+}
+
+
+void receive_info_result (io_t *io, ::msghdr &msg, size_t size) noexcept
+{
+  auto &pending = io->pending.receive_from;
+
+  *io->transferred = size;
+  if (msg.msg_flags & MSG_TRUNC)
+  {
+    io->status.assign(EMSGSIZE, std::generic_category());
+    return;
+  }
+
+  io->status.clear();
+  pending.remote_endpoint_capacity = msg.msg_namelen;
+
+  *pending.interface_index = 0;
+  *pending.timestamp = {};
+  *pending.local_address = {};
+
+  for (auto cmsg = CMSG_FIRSTHDR(&msg);  cmsg;  cmsg = CMSG_NXTHDR(&msg, cmsg))
+  {
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS)
+    {
+      ::timespec ts;
+      std::memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+      *pending.timestamp = std::chrono::system_clock::time_point{
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+          std::chrono::seconds{ts.tv_sec} + std::chrono::nanoseconds{ts.tv_nsec}
+        )
+      };
+    }
+    else if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_PKTINFO)
+    {
+      ::in_pktinfo info;
+      std::memcpy(&info, CMSG_DATA(cmsg), sizeof(info));
+      net::ip::address_v4_t::bytes_t bytes;
+      std::memcpy(bytes.data(), &info.ipi_addr, bytes.size());
+      *pending.interface_index = info.ipi_ifindex;
+      *pending.local_address = net::ip::address_v4_t{bytes};
+    }
+    else if (cmsg->cmsg_level == IPPROTO_IPV6 && cmsg->cmsg_type == IPV6_PKTINFO)
+    {
+      ::in6_pktinfo info;
+      std::memcpy(&info, CMSG_DATA(cmsg), sizeof(info));
+      net::ip::address_v6_t::bytes_t bytes;
+      std::memcpy(bytes.data(), &info.ipi6_addr, bytes.size());
+      *pending.interface_index = info.ipi6_ifindex;
+      *pending.local_address = net::ip::address_v6_t{bytes};
+    }
+  }
+}
+
+
+bool finish_receive_from_with_info (io_t *io, uint16_t, uint32_t) noexcept
+{
+  ::msghdr msg;
+  ::iovec iov[io_t::max_chain_size];
+  make_receive_message(io, msg, iov);
+
+  auto size = ::recvmsg(
+    io->owner->socket.handle,
+    &msg,
+    *io->flags | MSG_NOSIGNAL
+  );
+
+  if (size > -1)
+  {
+    receive_info_result(io, msg, size);
+  }
+  else
+  {
+    *io->transferred = 0;
+    io->status.assign(errno, std::generic_category());
+  }
+
+  return await_read(io);
+}
+
+
+bool finish_send_to_segmented (io_t *io, uint16_t, uint32_t) noexcept
+{
+  ::msghdr msg;
+  ::iovec iov[io_t::max_chain_size];
+  make_segmented_send(io, msg, iov);
+
+  auto size = ::sendmsg(
+    io->owner->socket.handle,
+    &msg,
+    io->pending.send_to.flags | MSG_NOSIGNAL
+  );
+
+  if (size > -1)
+  {
+    *io->transferred = size;
+    io->status.clear();
+  }
+  else
+  {
+    *io->transferred = 0;
+    io->status.assign(errno, std::generic_category());
+  }
+
+  return await_write(io);
+}
+
+
+inline bool complete_connection (io_t *io, uint16_t /**/, uint32_t events)
+  noexcept
+{
+  if (events & EPOLLERR)
+  {
+    int data;
+    socklen_t size = sizeof(data);
+    auto result = ::getsockopt(
+      io->owner->socket.handle,
+      SOL_SOCKET,
+      SO_ERROR,
+      &data,
+      &size
+    );
+    if (result == 0)
+    {
+      io->status.assign(data, std::generic_category());
+    }
+    else
+    {
+      io->status.assign(errno, std::generic_category());
+    }
+  }
+  else
+  {
+    io->status.clear();
+  }
+
+  return true;
+}
+
+
+} // namespace
+
+
+#if __sal_io_uring //{{{1
+
+
+struct io_uring_t
+{
+  static constexpr unsigned entries = 1024;
+
+  ::io_uring_params params{};
+  int fd;
+
+  void *ring = MAP_FAILED;
+  size_t ring_size{};
+
+  ::io_uring_sqe *sqes = static_cast<::io_uring_sqe *>(MAP_FAILED);
+  size_t sqes_size{};
+
+  unsigned *sq_head{}, *sq_tail{}, sq_mask{};
+  unsigned *cq_head{}, *cq_tail{}, cq_mask{};
+  ::io_uring_cqe *cqes{};
+
+  std::mutex sq_mutex{}, cq_mutex{};
+
+  // number of reap() calls (under cq_mutex)
+  uint64_t reaps{};
+
+  // IORING_OP_SENDMSG_ZC is supported (since 6.1)
+  bool sendmsg_zc{};
+
+
+  io_uring_t (std::error_code &error) noexcept;
+  ~io_uring_t () noexcept;
+
+
+  int enter (unsigned to_submit,
+    unsigned min_complete,
+    unsigned flags,
+    const void *arg = nullptr,
+    size_t arg_size = 0) noexcept
+  {
+    return static_cast<int>(
+      ::syscall(__NR_io_uring_enter,
+        fd,
+        to_submit,
+        min_complete,
+        flags,
+        arg,
+        arg_size
+      )
+    );
+  }
+
+
+  unsigned unsubmitted () const noexcept
+  {
+    return __atomic_load_n(sq_tail, __ATOMIC_RELAXED)
+      - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE);
+  }
+
+
+  // queue sqe (flush: submit it to kernel immediately)
+  bool submit (const ::io_uring_sqe &sqe,
+    std::error_code &error,
+    bool flush = false
+  ) noexcept;
+
+
+  // submit queued entries without waiting for completions
+  void flush () noexcept
+  {
+    if (auto count = unsubmitted())
+    {
+      // on failure, entries remain in queue and are submitted with next enter()
+      (void)enter(count, 0, 0);
+    }
+  }
+
+
+  // invoke handler for up to max_entries completions and then finish (both
+  // under cq_mutex)
+  template <typename Handler, typename Finish>
+  size_t reap (size_t max_entries, Handler handler, Finish finish) noexcept
+  {
+    std::lock_guard lock(cq_mutex);
+    ++reaps;
+
+    size_t count = 0;
+    auto head = *cq_head, tail = __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE);
+    if (tail - head > max_entries)
+    {
+      tail = head + static_cast<unsigned>(max_entries);
+    }
+    for (/**/;  head != tail;  ++head)
+    {
+      count += handler(cqes[head & cq_mask]);
+    }
+    __atomic_store_n(cq_head, head, __ATOMIC_RELEASE);
+    finish();
+
+    return count;
+  }
+
+
+  io_uring_t (const io_uring_t &) = delete;
+  io_uring_t &operator= (const io_uring_t &) = delete;
+  io_uring_t (io_uring_t &&) = delete;
+  io_uring_t &operator= (io_uring_t &&) = delete;
+};
+
+
+io_uring_t::io_uring_t (std::error_code &error) noexcept
+  : fd(static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params)))
+{
+  if (fd == -1)
+  {
+    error.assign(errno, std::generic_category());
+    return;
+  }
+
+  // EXT_ARG: 5.11+, wait with timeout without consuming SQ entry
+  constexpr auto required_features = IORING_FEAT_SINGLE_MMAP
+    | IORING_FEAT_NODROP
+    | IORING_FEAT_EXT_ARG
+  ;
+  if ((params.features & required_features) != required_features)
+  {
+    error = std::make_error_code(std::errc::function_not_supported);
+    return;
+  }
+
+  // IORING_OP_SOCKET is not used but it was added in same kernel version
+  // (5.19) as fd-keyed IORING_OP_ASYNC_CANCEL that is used by ~handler_t
+  constexpr uint8_t required_ops[] =
+  {
+    IORING_OP_RECVMSG,
+    IORING_OP_SENDMSG,
+    IORING_OP_SEND,
+    IORING_OP_ACCEPT,
+    IORING_OP_CONNECT,
+    IORING_OP_ASYNC_CANCEL,
+    IORING_OP_SOCKET,
+  };
+  constexpr size_t probe_ops = 256;
+  alignas(::io_uring_probe) std::byte probe_data[
+    sizeof(::io_uring_probe) + probe_ops * sizeof(::io_uring_probe_op)
+  ]{};
+  auto probe = reinterpret_cast<::io_uring_probe *>(probe_data);
+  auto result = ::syscall(__NR_io_uring_register,
+    fd,
+    IORING_REGISTER_PROBE,
+    probe,
+    probe_ops
+  );
+  if (result == -1)
+  {
+    error.assign(errno, std::generic_category());
+    return;
+  }
+  for (auto op: required_ops)
+  {
+    if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED))
+    {
+      error = std::make_error_code(std::errc::function_not_supported);
+      return;
+    }
+  }
+
+  sendmsg_zc = IORING_OP_SENDMSG_ZC <= probe->last_op
+    && (probe->ops[IORING_OP_SENDMSG_ZC].flags & IO_URING_OP_SUPPORTED);
+
+  ring_size = std::max(
+    params.sq_off.array + params.sq_entries * sizeof(unsigned),
+    params.cq_off.cqes + params.cq_entries * sizeof(::io_uring_cqe)
+  );
+  ring = ::mmap(nullptr,
+    ring_size,
+    PROT_READ | PROT_WRITE,
+    MAP_SHARED | MAP_POPULATE,
+    fd,
+    IORING_OFF_SQ_RING
+  );
+  if (ring == MAP_FAILED)
+  {
+    error.assign(errno, std::generic_category());
+    return;
+  }
+
+  sqes_size = params.sq_entries * sizeof(::io_uring_sqe);
+  sqes = static_cast<::io_uring_sqe *>(
+    ::mmap(nullptr,
+      sqes_size,
+      PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE,
+      fd,
+      IORING_OFF_SQES
+    )
+  );
+  if (sqes == MAP_FAILED)
+  {
+    error.assign(errno, std::generic_category());
+    return;
+  }
+
+  auto at = [this](uint32_t offset)
+  {
+    return reinterpret_cast<unsigned *>(static_cast<char *>(ring) + offset);
+  };
+
+  sq_head = at(params.sq_off.head);
+  sq_tail = at(params.sq_off.tail);
+  sq_mask = *at(params.sq_off.ring_mask);
+
+  // SQE at index I is always described by array[I], set it up once
+  auto sq_array = at(params.sq_off.array);
+  for (auto i = 0U;  i != params.sq_entries;  ++i)
+  {
+    sq_array[i] = i;
+  }
+
+  cq_head = at(params.cq_off.head);
+  cq_tail = at(params.cq_off.tail);
+  cq_mask = *at(params.cq_off.ring_mask);
+  cqes = reinterpret_cast<::io_uring_cqe *>(at(params.cq_off.cqes));
+
+  error.clear();
+}
+
+
+io_uring_t::~io_uring_t () noexcept
+{
+  if (sqes != MAP_FAILED)
+  {
+    (void)::munmap(sqes, sqes_size);
+  }
+  if (ring != MAP_FAILED)
+  {
+    (void)::munmap(ring, ring_size);
+  }
+  if (fd != -1)
+  {
+    (void)::close(fd);
+  }
+}
+
+
+bool io_uring_t::submit (const ::io_uring_sqe &sqe,
+  std::error_code &error,
+  bool flush) noexcept
+{
+  for (;;)
+  {
+    {
+      std::lock_guard lock(sq_mutex);
+      auto tail = *sq_tail;
+      if (tail - __atomic_load_n(sq_head, __ATOMIC_ACQUIRE) < params.sq_entries)
+      {
+        sqes[tail & sq_mask] = sqe;
+        __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+        break;
+      }
+    }
+
+    // submission queue is full, flush and retry
+    if (enter(unsubmitted(), 0, 0) == -1 && errno != EINTR)
+    {
+      error.assign(errno, std::generic_category());
+      return false;
+    }
+  }
+
+  if (flush)
+  {
+    this->flush();
+  }
+  return true;
+}
+
+
+namespace {
+
+
+inline void uring_error (io_t *io, int result) noexcept
+{
+  // keep same mapping as net::__bits::socket_t
+  if (result == -EDESTADDRREQ)
+  {
+    result = -ENOTCONN;
+  }
+  io->status.assign(-result, std::generic_category());
+}
+
+
+// add io into owner's list of submitted operations
+bool uring_link (io_t *io) noexcept
+{
+  auto &handler = *io->owner;
+  std::lock_guard lock(handler.uring_mutex);
+  try
+  {
+    io->uring_slot = handler.uring_ops.size();
+    handler.uring_ops.push_back(io);
+    return true;
+  }
+  catch (const std::bad_alloc &)
+  {
+    return false;
+  }
+}
+
+
+// remove io from owner's list of submitted operations
+void uring_unlink (io_t *io) noexcept
+{
+  auto &handler = *io->owner;
+  std::lock_guard lock(handler.uring_mutex);
+  auto last = handler.uring_ops.back();
+  last->uring_slot = io->uring_slot;
+  handler.uring_ops[io->uring_slot] = last;
+  handler.uring_ops.pop_back();
+}
+
+
+// submit sqe of io (flush: submit to kernel immediately; without, it is
+// left queued for caller to flush once for multiple operations). Operations
+// started by application are flushed to keep them ordered with synchronous
+// socket calls (shutdown, etc) that follow
+void uring_start (io_t *io, ::io_uring_sqe &sqe, bool flush) noexcept
+{
+  io->owner->count_started();
+  sqe.fd = io->owner->socket.handle;
+  sqe.user_data = reinterpret_cast<uintptr_t>(io);
+
+  // linked before submit, completion may be reaped before submit returns
+  if (!uring_link(io))
+  {
+    io->status = std::make_error_code(std::errc::not_enough_memory);
+    io->completed();
+  }
+  else if (!io->service.uring->submit(sqe, io->status, flush))
+  {
+    uring_unlink(io);
+    io->completed();
+  }
+}
+
+
+// iovec array for io->message that stays valid while io is pending
+inline ::iovec *uring_message_iov (io_t *io) noexcept
+{
+  return io->chain_next ? io->chain_next->pending.chain_iov : &io->message_iov;
+}
+
+
+// setup io->message for [begin(),end()) of io and it's scatter/gather chain
+// (message_iov.iov_len is total data size)
+void uring_make_message (io_t *io, void *name, size_t name_size) noexcept
+{
+  io->message = {};
+  io->message.msg_name = name;
+  io->message.msg_namelen = static_cast<socklen_t>(name_size);
+
+  if (!io->chain_next)
+  {
+    io->message_iov.iov_base = io->begin;
+    io->message_iov.iov_len = io->end - io->begin;
+    io->message.msg_iov = &io->message_iov;
+    io->message.msg_iovlen = 1;
+    return;
+  }
+
+  auto iov = uring_message_iov(io);
+  io->message.msg_iov = iov;
+  io->message.msg_iovlen = make_iov(io, iov);
+
+  io->message_iov = {};
+  for (auto i = 0U;  i != io->message.msg_iovlen;  ++i)
+  {
+    io->message_iov.iov_len += iov[i].iov_len;
+  }
+}
+
+
+void uring_start_receive (io_t *io,
+  void *remote_endpoint,
+  size_t remote_endpoint_capacity,
+  bool flush) noexcept
+{
+  uring_make_message(io, remote_endpoint, remote_endpoint_capacity);
+
+  ::io_uring_sqe sqe{};
+  sqe.opcode = IORING_OP_RECVMSG;
+  sqe.addr = reinterpret_cast<uintptr_t>(&io->message);
+  sqe.len = 1;
+  sqe.msg_flags = *io->flags | MSG_NOSIGNAL;
+  uring_start(io, sqe, flush);
+}
+
+
+bool uring_finish_receive_from (io_t *io, uint16_t, uint32_t result) noexcept
+{
+  auto size = static_cast<int32_t>(result);
+  if (size > -1)
+  {
+    *io->transferred = size;
+    if (io->message.msg_flags & MSG_TRUNC)
+    {
+      io->status.assign(EMSGSIZE, std::generic_category());
+    }
+    else
+    {
+      io->status.clear();
+      io->pending.receive_from.remote_endpoint_capacity =
+        io->message.msg_namelen;
+    }
+  }
+  else
+  {
+    *io->transferred = 0;
+    uring_error(io, size);
+  }
+  return true;
+}
+
+
+bool uring_finish_receive (io_t *io, uint16_t, uint32_t result) noexcept
+{
+  auto size = static_cast<int32_t>(result);
+  if (size > 0 || (size == 0 && !io->message_iov.iov_len))
+  {
+    *io->transferred = size;
+    if (io->message.msg_flags & MSG_TRUNC)
+    {
+      io->status.assign(EMSGSIZE, std::generic_category());
+    }
+    else
+    {
+      io->status.clear();
+    }
+  }
+  else if (size == 0)
+  {
+    *io->transferred = 0;
+    io->status = std::make_error_code(std::errc::broken_pipe);
+  }
+  else
+  {
+    *io->transferred = 0;
+    uring_error(io, size);
+  }
+  return true;
+}
+
+
+bool uring_finish_receive_from_pooled (io_t *io, uint16_t flags,
+  uint32_t result) noexcept
+{
+  (void)uring_finish_receive_from(io, flags, result);
+  if (io->owner)
+  {
+    // owner is cleared if handler is already gone (~handler_t)
+    io->owner->replenish_receive_pool(io);
+  }
+  return true;
+}
+
+
+bool uring_finish_receive_from_with_info (io_t *io, uint16_t, uint32_t result)
+  noexcept
+{
+  auto size = static_cast<int32_t>(result);
+  if (size > -1)
+  {
+    receive_info_result(io, io->message, size);
+  }
+  else
+  {
+    *io->transferred = 0;
+    uring_error(io, size);
+  }
+  return true;
+}
+
+
+bool uring_finish_receive_from_segmented (io_t *io, uint16_t, uint32_t result)
+  noexcept
+{
+  auto size = static_cast<int32_t>(result);
+  if (size > -1)
+  {
+    segmented_receive_result(io, io->message, size);
+  }
+  else
+  {
+    *io->transferred = 0;
+    uring_error(io, size);
+  }
+  return true;
+}
+
+
+bool uring_finish_send (io_t *io, uint16_t, uint32_t result) noexcept
+{
+  auto size = static_cast<int32_t>(result);
+  if (size > -1)
+  {
+    *io->transferred = size;
+    io->status.clear();
+  }
+  else
+  {
+    *io->transferred = 0;
+    uring_error(io, size);
+  }
+  return true;
+}
+
+
+bool uring_finish_send_zerocopy (io_t *io, uint16_t flags, uint32_t result)
+  noexcept
+{
+  // first completion has send result and if IORING_CQE_F_MORE is set, it is
+  // followed by notification when kernel has released io data
+  if (flags & IORING_CQE_F_NOTIF)
+  {
+    return true;
+  }
+  uring_finish_send(io, flags, result);
+  return !(flags & IORING_CQE_F_MORE);
+}
+
+
+void uring_start_send_to (io_t *io, message_flags_t flags, bool flush)
+  noexcept
+{
+  io->on_finish = uring_finish_send;
+  uring_make_message(io,
+    &io->pending.send_to.remote_endpoint,
+    io->pending.send_to.remote_endpoint_size
+  );
+
+  ::io_uring_sqe sqe{};
+  sqe.opcode = IORING_OP_SENDMSG;
+  sqe.addr = reinterpret_cast<uintptr_t>(&io->message);
+  sqe.len = 1;
+  sqe.msg_flags = flags | MSG_NOSIGNAL;
+  uring_start(io, sqe, flush);
+}
+
+
+void uring_start_accept (io_t *io) noexcept
+{
+  ::io_uring_sqe sqe{};
+  sqe.opcode = IORING_OP_ACCEPT;
+  uring_start(io, sqe, true);
+}
+
+
+// resubmit accept that is still in owner's list, returning false if it
+// can't be restarted (io status is set)
+bool uring_restart_accept (io_t *io) noexcept
+{
+  if (!io->owner)
+  {
+    io->status = std::make_error_code(std::errc::operation_canceled);
+    return false;
+  }
+
+  ::io_uring_sqe sqe{};
+  sqe.opcode = IORING_OP_ACCEPT;
+  sqe.fd = io->owner->socket.handle;
+  sqe.user_data = reinterpret_cast<uintptr_t>(io);
+  return io->service.uring->submit(sqe, io->status);
+}
+
+
+bool uring_finish_accept (io_t *io, uint16_t, uint32_t result) noexcept
+{
+  auto handle = static_cast<int32_t>(result);
+  if (handle > -1)
+  {
+    *io->pending.accept.socket_handle = handle;
+    io->status.clear();
+    return true;
+  }
+
+  switch (-handle)
+  {
+    // see accept(2), these are already pending errors
+    case ENETDOWN:
+    case EPROTO:
+    case ENOPROTOOPT:
+    case EHOSTDOWN:
+    case ENONET:
+    case EHOSTUNREACH:
+    case EOPNOTSUPP:
+    case ENETUNREACH:
+    case ECONNABORTED:
+      if (uring_restart_accept(io))
+      {
+        return false;
+      }
+      *io->pending.accept.socket_handle = socket_t::invalid;
+      return true;
+  }
+
+  *io->pending.accept.socket_handle = socket_t::invalid;
+  uring_error(io, handle);
+  return true;
+}
+
+
+bool uring_finish_connect (io_t *io, uint16_t, uint32_t result) noexcept
+{
+  auto status = static_cast<int32_t>(result);
+  if (status > -1)
+  {
+    io->status.clear();
+  }
+  else
+  {
+    uring_error(io, status);
+  }
+  return true;
+}
+
+
+// request cancel of io (or all socket's pending operations if io is nullptr),
+// canceled operations are completed with operation_canceled
+void uring_cancel (handler_t &handler, const io_t *io) noexcept
+{
+  ::io_uring_sqe sqe{};
+  sqe.opcode = IORING_OP_ASYNC_CANCEL;
+  sqe.fd = handler.socket.handle;
+  if (io)
+  {
+    sqe.addr = reinterpret_cast<uintptr_t>(io);
+  }
+  else
+  {
+    sqe.cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+  }
+  // flushed immediately: socket may be closed right after cancel request
+  // and queued entries would refer to closed (or reused) descriptor
+  std::error_code ignored;
+  (void)handler.service->uring->submit(sqe, ignored, true);
+}
+
+
+// finish operations from completion ring into queue, returning number of
+// completed operations
+size_t uring_reap (completion_queue_t &queue) noexcept
+{
+  auto &uring = *queue.service->uring;
+
+  // handler's completions over drain budget are completed after other
+  // handlers' completions of same reap (in order)
+  io_t::pending_list_t surplus{};
+  auto within_budget = [&](handler_t &owner)
+  {
+    if (owner.reap != uring.reaps)
+    {
+      owner.reap = uring.reaps;
+      owner.reaped = 0;
+    }
+    return !queue.drain_budget || ++owner.reaped <= queue.drain_budget;
+  };
+
+  auto completed = uring.reap(queue.max_events,
+    [&](const ::io_uring_cqe &cqe) -> size_t
+    {
+      // wakeup entries are tagged with lowest bit (io_t is aligned)
+      if (cqe.user_data & 1)
+      {
+        reinterpret_cast<wakeup_t *>(cqe.user_data & ~uint64_t{1})
+          ->signaled.store(false, std::memory_order_relaxed);
+        return 1;
+      }
+
+      // entries without user_data are internal (cancel requests)
+      if (auto io = reinterpret_cast<io_t *>(cqe.user_data))
+      {
+        // owner is either cleared or it's destructor waits for cq_mutex
+        auto flags = static_cast<uint16_t>(cqe.flags);
+        if ((*io->on_finish)(io, flags, static_cast<uint32_t>(cqe.res)))
+        {
+          if (auto owner = io->owner)
+          {
+            uring_unlink(io);
+            if (cqe.res == -ECANCELED)
+            {
+              // same as with reactor: canceled io has no owner
+              owner->completed.fetch_add(1, std::memory_order_relaxed);
+              io->owner = nullptr;
+            }
+            else if (!within_budget(*owner))
+            {
+              surplus.push(io);
+              return 1;
+            }
+          }
+          io->completed(queue.completed_list);
+          return 1;
+        }
+      }
+      return 0;
+    },
+    [&]
+    {
+      // owners are still valid
+      while (auto io = surplus.try_pop())
+      {
+        io->completed(queue.completed_list);
+      }
+    }
+  );
+  completion_queue_t::count(queue.events, completed);
+
+  // operations restarted by on_finish handlers are queued, submit together
+  uring.flush();
+
+  return completed;
+}
+
+
+bool uring_wait (completion_queue_t &queue,
+  const std::chrono::milliseconds &timeout,
+  std::error_code &error) noexcept
+{
+  auto &uring = *queue.service->uring;
+  auto reap = [&queue]
+  {
+    return uring_reap(queue);
+  };
+
+  using namespace std::chrono;
+  auto deadline = steady_clock::time_point::max();
+  if (timeout != timeout.max())
+  {
+    deadline = steady_clock::now() + timeout;
+  }
+
+  for (;;)
+  {
+    if (reap())
+    {
+      error.clear();
+      return true;
+    }
+
+    ::__kernel_timespec ts{};
+    ::io_uring_getevents_arg arg{};
+    if (deadline != steady_clock::time_point::max())
+    {
+      auto remaining = (std::max)(
+        deadline - steady_clock::now(),
+        steady_clock::duration::zero()
+      );
+      auto s = duration_cast<seconds>(remaining);
+      ts.tv_sec = s.count();
+      ts.tv_nsec = duration_cast<nanoseconds>(remaining - s).count();
+      arg.ts = reinterpret_cast<uintptr_t>(&ts);
+    }
+
+    auto result = uring.enter(uring.unsubmitted(),
+      1,
+      IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+      &arg,
+      sizeof(arg)
+    );
+
+    if (result == -1)
+    {
+      if (errno == ETIME)
+      {
+        error.clear();
+        return reap() > 0;
+      }
+      else if (errno != EBUSY && errno != EAGAIN)
+      {
+        error.assign(errno, std::generic_category());
+        return false;
+      }
+    }
+  }
+}
+
+
+} // namespace
+
+
+#endif // __sal_io_uring
+
+
+#elif __sal_os_macos //{{{1
+
+
+namespace {
+
+
+inline ::timespec *to_timespec (::timespec *ts,
+  const std::chrono::milliseconds &timeout) noexcept
+{
+  using namespace std::chrono;
+
+  if (timeout != (milliseconds::max)())
+  {
+    auto s = duration_cast<seconds>(timeout);
+    ts->tv_nsec = duration_cast<nanoseconds>(timeout - s).count();
+    ts->tv_sec = s.count();
+    return ts;
+  }
+  return nullptr;
+}
+
+
+inline int make_queue () noexcept
+{
+  return ::kqueue();
+}
+
+
+using reactor_event_t = struct ::kevent;
+
+
+inline int wait_events (int reactor,
+  reactor_event_t *events,
+  int max_events,
+  const std::chrono::milliseconds &timeout) noexcept
+{
+  ::timespec ts;
+  return ::kevent(
+    reactor,
+    nullptr,
+    0,
+    events,
+    max_events,
+    to_timespec(&ts, timeout)
+  );
+}
+
+
+inline bool is_nested_reactor (const reactor_event_t &event) noexcept
+{
+  return event.udata == nullptr;
+}
+
+
+void nest_reactor (int reactor, int nested, std::error_code &error) noexcept
+{
+  // level-triggered: nested stays ready while it has unreported events
+  struct ::kevent change;
+  EV_SET(&change, nested, EVFILT_READ, EV_ADD, 0, 0, nullptr);
+
+  if (::kevent(reactor, &change, 1, nullptr, 0, nullptr) > -1)
+  {
+    error.clear();
+  }
+  else
+  {
+    error.assign(errno, std::generic_category());
+  }
+}
+
+
+inline bool is_wakeup_event (const reactor_event_t &event) noexcept
+{
+  return event.filter == EVFILT_USER;
+}
+
+
+inline wakeup_t &wakeup_of (const reactor_event_t &event) noexcept
+{
+  return *static_cast<wakeup_t *>(event.udata);
+}
+
+
+void register_wakeup (int reactor, wakeup_t &wakeup, std::error_code &error)
+  noexcept
+{
+  struct ::kevent change;
+  EV_SET(&change,
+    reinterpret_cast<uintptr_t>(&wakeup),
+    EVFILT_USER,
+    EV_ADD | EV_CLEAR,
+    0,
+    0,
+    &wakeup
+  );
+
+  if (::kevent(reactor, &change, 1, nullptr, 0, nullptr) > -1)
+  {
+    wakeup.reactor = reactor;
+    error.clear();
+  }
+  else
+  {
+    error.assign(errno, std::generic_category());
+  }
+}
+
+
+inline void close_wakeup (wakeup_t &) noexcept
+{
+  // EVFILT_USER event is removed with reactor
+}
+
+
+inline void register_handler (handler_t &, std::error_code &error) noexcept
+{
+  error.clear();
+}
+
+
+bool await_io (io_t *io, int16_t filter, uint16_t flags) noexcept
+{
+  if (io->status != std::errc::operation_would_block
+    && io->status != std::errc::no_buffer_space)
+  {
+    return true;
+  }
+
+  auto &handler = *io->owner;
+  count_would_block(handler);
+
+  struct ::kevent change;
+  EV_SET(&change,
+    handler.socket.handle,
+    filter,
+    flags,
+    0,
+    0,
+    &handler
+  );
+
+  auto result = ::kevent(
+    handler.reactor,
+    &change,
+    1,
+    nullptr,
+    0,
+    nullptr
+  );
+
+  if (result > -1)
+  {
+    return false;
+  }
+
+  io->status.assign(errno, std::generic_category());
+  return true;
+}
+
+
+inline bool await_read (io_t *io) noexcept
+{
+  return await_io(io, EVFILT_READ, EV_ADD | EV_CLEAR);
+}
+
+
+inline bool await_write (io_t *io) noexcept
+{
+  return await_io(io, EVFILT_WRITE, EV_ADD | EV_CLEAR);
+}
+
+
+bool drain (handler_t::pending_t &pending,
+  uint16_t flags,
+  uint32_t fflags,
+  io_t::completed_list_t *queue) noexcept
+{
+  post_events(pending, flags, fflags);
+  return drain_pending(pending,
+    [&pending, queue](uint16_t flags, uint32_t fflags)
+    {
+      while (auto io = static_cast<io_t *>(pending.list.head()))
+      {
+        if ((*io->on_finish)(io, flags, fflags))
+        {
+          (void)pending.list.try_pop();
+          complete(io, queue);
+        }
+        else
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+  );
+}
+
+
+// drain budget is not supported (EV_CLEAR filter is not re-armed), handler
+// never needs re-arming
+bool drain (const struct ::kevent &event,
+  io_t::completed_list_t &queue,
+  size_t) noexcept
+{
+  auto &handler = *static_cast<handler_t *>(event.udata);
+  (void)drain(
+    event.filter == EVFILT_READ ? handler.pending_read : handler.pending_write,
+    event.flags,
+    static_cast<uint32_t>(event.fflags),
+    &queue
+  );
+  return false;
+}
+
+
+inline void rearm (struct ::kevent &, io_t::completed_list_t &) noexcept
+{ }
+
+
+inline bool complete_connection (io_t *io, uint16_t flags, uint32_t fflags)
+  noexcept
+{
+  if (flags & EV_EOF)
+  {
+    io->status.assign(fflags, std::generic_category());
+  }
+  else
+  {
+    io->status.clear();
+  }
+  return true;
+}
+
+
+} // namespace
+
+
+#endif //}}}1
+
+
+#if __sal_os_linux || __sal_os_macos //{{{1
+
+
+namespace {
+
+inline bool uses_io_uring ([[maybe_unused]] const handler_t &handler) noexcept
+{
+#if __sal_io_uring
+  return handler.service->uring != nullptr;
+#else
+  return false;
+#endif
+}
+
+
+// wait for reactor events and drain those into queue (up to drain_budget
+// operations per handler), returning number of events or -1 on error. If
+// nested reactor becomes ready, it is drained into same queue without
+// blocking
+int wait_reactor (int reactor,
+  int nested,
+  const std::chrono::milliseconds &timeout,
+  io_t::completed_list_t &queue,
+  reactor_event_t *events,
+  int max_events,
+  size_t drain_budget) noexcept
+{
+  auto events_count = wait_events(reactor, &events[0], max_events, timeout);
+  if (events_count < 0)
+  {
+    return events_count;
+  }
+
+  auto nested_ready = false;
+  auto rearm_end = &events[0];
+  for (auto event = &events[0];  event != &events[0] + events_count;  ++event)
+  {
+    if (is_nested_reactor(*event))
+    {
+      nested_ready = true;
+    }
+    else if (is_wakeup_event(*event))
+    {
+      // posted io is already in queue
+      wakeup_of(*event).signaled.store(false, std::memory_order_relaxed);
+    }
+    else if (drain(*event, queue, drain_budget))
+    {
+      // already handled events' slots are reused
+      *rearm_end++ = *event;
+    }
+  }
+
+  // handlers that used up drain budget are re-armed only after whole batch
+  // is handled: re-armed readiness is reported behind handlers that became
+  // ready meanwhile and other threads can't pick it up while this one still
+  // drains same batch
+  for (auto event = &events[0];  event != rearm_end;  ++event)
+  {
+    rearm(*event, queue);
+  }
+
+  if (nested_ready)
+  {
+    // events are already handled, reuse buffer
+    auto nested_count = wait_reactor(nested,
+      -1,
+      std::chrono::milliseconds::zero(),
+      queue,
+      events,
+      max_events,
+      drain_budget
+    );
+    if (nested_count < 0)
+    {
+      return nested_count;
+    }
+    events_count += nested_count - 1;
+  }
+
+  return events_count;
+}
+
+} // namespace
+
+
+service_t::service_t ()
+  : queue(make_queue())
+{
+  if (queue < 0)
+  {
+    std::error_code error;
+    error.assign(errno, std::generic_category());
+    throw_system_error(error, "async::service::make_queue");
+  }
+
+  std::error_code error;
+  register_wakeup(queue, wakeup, error);
+  if (error)
+  {
+    close_wakeup(wakeup);
+    (void)::close(queue);
+    throw_system_error(error, "async::service::make_wakeup");
+  }
+
+#if __sal_io_uring
+  // on failure (old kernel, not permitted, etc) fall back to epoll
+  uring.reset(new(std::nothrow) io_uring_t(error));
+  if (error)
+  {
+    uring.reset();
+  }
+#endif
+}
+
+
+service_t::~service_t () noexcept
+{
+#if __sal_os_linux
+  release_zerocopy_orphans(*this);
+#endif
+  close_wakeup(wakeup);
+  (void)::close(queue);
+}
+
+
+bool completion_queue_t::wait_io (const std::chrono::milliseconds &timeout,
+  std::error_code &error) noexcept
+{
+#if __sal_io_uring
+  if (service->uring)
+  {
+    return uring_wait(*this, timeout, error);
+  }
+#endif
+
+  reactor_event_t stack_events[default_max_events];
+  auto events = max_events > default_max_events
+    ? reinterpret_cast<reactor_event_t *>(event_buffer.get())
+    : stack_events
+  ;
+
+  auto events_count = reactor != -1
+    ? wait_reactor(reactor,
+        service->queue,
+        timeout,
+        completed_list,
+        events,
+        static_cast<int>(max_events),
+        drain_budget
+      )
+    : wait_reactor(service->queue,
+        -1,
+        timeout,
+        completed_list,
+        events,
+        static_cast<int>(max_events),
+        drain_budget
+      )
+  ;
+
+  if (events_count > -1)
+  {
+    count(this->events, events_count);
+    return events_count > 0;
+  }
+
+  error.assign(errno, std::generic_category());
+  return false;
+}
+
+
+completion_queue_t::completion_queue_t (service_ptr service, bool own_reactor)
+  : completion_queue_t(service)
+{
+  if (!own_reactor)
+  {
+    return;
+  }
+
+#if __sal_io_uring
+  if (service->uring)
+  {
+    // completions are reaped directly from shared ring
+    return;
+  }
+#endif
+
+  std::error_code error;
+  reactor = make_queue();
+  if (reactor == -1)
+  {
+    error.assign(errno, std::generic_category());
+  }
+  else
+  {
+    // handlers not bound to any queue are still drained by this queue
+    nest_reactor(reactor, service->queue, error);
+  }
+
+  if (!error)
+  {
+    register_wakeup(reactor, wakeup, error);
+  }
+
+  if (error)
+  {
+    // constructed by delegation, destructor closes reactor
+    throw_system_error(error, "async::completion_queue::make_reactor");
+  }
+}
+
+
+void completion_queue_t::pin_thread ([[maybe_unused]] size_t cpu,
+  std::error_code &error) noexcept
+{
+#if __sal_os_linux
+
+  ::cpu_set_t set;
+  CPU_ZERO(&set);
+  if (cpu >= CPU_SETSIZE)
+  {
+    error = std::make_error_code(std::errc::invalid_argument);
+    return;
+  }
+  CPU_SET(cpu, &set);
+
+  if (::sched_setaffinity(0, sizeof(set), &set) > -1)
+  {
+    error.clear();
+  }
+  else
+  {
+    error.assign(errno, std::generic_category());
+  }
+
+#elif __sal_os_macos
+
+  // only affinity tags (scheduling hints) are supported
+  error = std::make_error_code(std::errc::operation_not_supported);
+
+#endif
+}
+
+
+bool completion_queue_t::poll_io (std::error_code &error) noexcept
+{
+#if __sal_io_uring
+  if (service->uring && !service->uring->unsubmitted())
+  {
+    error.clear();
+    return uring_reap(*this) > 0;
+  }
+#endif
+  return wait_io(std::chrono::milliseconds::zero(), error);
+}
+
+
+void completion_queue_t::set_max_events (size_t count)
+{
+  // with io_uring, completions are reaped directly from ring
+  auto reactor_events = true;
+#if __sal_io_uring
+  reactor_events = service->uring == nullptr;
+#endif
+
+  std::unique_ptr<std::byte[]> buffer{};
+  if (count > default_max_events && reactor_events)
+  {
+    buffer.reset(new std::byte[count * sizeof(reactor_event_t)]);
+  }
+  event_buffer = std::move(buffer);
+  max_events = count;
+}
+
+
+namespace {
+
+void notify ([[maybe_unused]] service_t &service, wakeup_t &wakeup) noexcept
+{
+#if __sal_io_uring
+  if (service.uring)
+  {
+    // waiters block in io_uring_enter, completed NOP wakes one of them
+    ::io_uring_sqe sqe{};
+    sqe.opcode = IORING_OP_NOP;
+    sqe.user_data = reinterpret_cast<uintptr_t>(&wakeup) | 1;
+    std::error_code ignored;
+    (void)service.uring->submit(sqe, ignored, true);
+    return;
+  }
+#endif
+
+#if __sal_os_linux
+  uint64_t value = 1;
+  (void)::write(wakeup.event, &value, sizeof(value));
+#elif __sal_os_macos
+  struct ::kevent change;
+  EV_SET(&change,
+    reinterpret_cast<uintptr_t>(&wakeup),
+    EVFILT_USER,
+    0,
+    NOTE_TRIGGER,
+    0,
+    &wakeup
+  );
+  (void)::kevent(wakeup.reactor, &change, 1, nullptr, 0, nullptr);
+#endif
+}
+
+} // namespace
+
+
+handler_t::handler_t (service_ptr service,
+    completion_queue_t *queue,
+    socket_t &socket,
+    std::error_code &error) noexcept
+  : service(service)
+  , socket(socket.handle)
+  , reactor(queue && queue->reactor != -1 ? queue->reactor : service->queue)
+{
+#if __sal_os_linux && defined(SO_BUSY_POLL)
+  if (queue && queue->socket_busy_poll)
+  {
+    // best effort, raising above net.core.busy_poll needs CAP_NET_ADMIN
+    std::error_code ignore_error;
+    int value = queue->socket_busy_poll;
+    this->socket.set_opt(SOL_SOCKET,
+      SO_BUSY_POLL,
+      &value,
+      sizeof(value),
+      ignore_error
+    );
+  #if defined(SO_PREFER_BUSY_POLL)
+    value = 1;
+    this->socket.set_opt(SOL_SOCKET,
+      SO_PREFER_BUSY_POLL,
+      &value,
+      sizeof(value),
+      ignore_error
+    );
+  #endif
+  }
+#endif
+
+#if __sal_io_uring
+  if (service->uring)
+  {
+    error.clear();
+    return;
+  }
+#endif
+
+  register_handler(*this, error);
+}
+
+
+handler_t::~handler_t () noexcept
+{
+  if (has_deadlines.load(std::memory_order_relaxed))
+  {
+    service->clear_deadlines(this);
+  }
+
+#if __sal_io_uring
+  if (service->uring)
+  {
+    // completions may arrive after handler is gone (cancel is asynchronous
+    // and operation may finish before it): detach submitted operations.
+    // Reaping thread holds cq_mutex while it uses io owner (and restarts
+    // operations only if it is set)
+    std::lock_guard cq_lock(service->uring->cq_mutex);
+    std::lock_guard lock(uring_mutex);
+    for (auto io: uring_ops)
+    {
+      io->owner = nullptr;
+    }
+    uring_ops.clear();
+
+    // kernel holds socket while there are pending operations, cancel those
+    // (completions are reported with operation_canceled)
+    uring_cancel(*this, nullptr);
+  }
+#endif
+
+#if __sal_os_linux
+  // kernel may still read data of sent zerocopy io_t, keep those until it
+  // reports releasing them (if it fails, they are canceled below)
+  (void)orphan_zerocopy(*this);
+#endif
+
+  socket.handle = socket.invalid;
+
+  auto cancel = [](auto &list)
+  {
+    while (auto io = list.try_pop())
+    {
+      io->status = std::make_error_code(std::errc::operation_canceled);
+      io->owner = nullptr;
+      io->completed();
+    }
+  };
+  cancel(pending_read.incoming);
+  cancel(pending_read.list);
+  cancel(pending_write.incoming);
+  cancel(pending_write.list);
+#if __sal_os_linux
+  cancel(zerocopy_list);
+#endif
+}
+
+
+namespace {
+
+
+inline void start (io_t *io, handler_t::pending_t &pending) noexcept
+{
+  // if there is no drainer, this thread becomes one and tries io at once
+  // (unless older operations wait for readiness)
+  io->owner->count_started();
+  pending.incoming.push(io);
+  (void)drain(pending, 0, 0, nullptr);
+}
+
+
+bool finish_receive_from (io_t *io, uint16_t, uint32_t) noexcept
+{
+  *io->transferred = io->owner->socket.receive_from(
+    io->begin,
+    io->end - io->begin,
+    io->pending.receive_from.remote_endpoint,
+    &io->pending.receive_from.remote_endpoint_capacity,
+    *io->flags,
+    io->status
+  );
+  return await_read(io);
+}
+
+
+bool finish_receive_from_pooled (io_t *io, uint16_t flags, uint32_t events)
+  noexcept
+{
+  if (finish_receive_from(io, flags, events))
+  {
+    io->owner->replenish_receive_pool(io);
+    return true;
+  }
+  return false;
+}
+
+
+bool finish_receive (io_t *io, uint16_t, uint32_t) noexcept
+{
+  *io->transferred = io->owner->socket.receive(
+    io->begin,
+    io->end - io->begin,
+    *io->flags,
+    io->status
+  );
+  return await_read(io);
+}
+
+
+bool finish_send_to (io_t *io, uint16_t, uint32_t) noexcept
+{
+  *io->transferred = io->owner->socket.send_to(
+    io->begin,
+    io->end - io->begin,
+    &io->pending.send_to.remote_endpoint,
+    io->pending.send_to.remote_endpoint_size,
+    io->pending.send_to.flags,
+    io->status
+  );
+  return await_write(io);
+}
+
+
+bool finish_send (io_t *io, uint16_t, uint32_t) noexcept
+{
+  *io->transferred = io->owner->socket.send(
+    io->begin,
+    io->end - io->begin,
+    io->pending.send_to.flags,
+    io->status
+  );
+  return await_write(io);
+}
+
+
+bool finish_accept (io_t *io, uint16_t, uint32_t) noexcept
+{
+  *io->pending.accept.socket_handle = io->owner->socket.accept(
+    nullptr,
+    nullptr,
+    false,
+    io->status
+  );
+  return await_read(io);
+}
+
+
+bool finish_connect (io_t *io, uint16_t flags, uint32_t fflags) noexcept
+{
+  if (io->status == std::errc::operation_in_progress)
+  {
+    // just started socket.connect() in start_connect()
+    // wait socket to become writable
+    io->status = std::make_error_code(std::errc::operation_would_block);
+    return await_write(io);
+  }
+  else if (io->status != std::errc::operation_would_block)
+  {
+    // blocking socket, we know result immediately
+    return true;
+  }
+
+  // final state (connected, rejected, etc)
+  return complete_connection(io, flags, fflags);
+}
+
+
+//
+// Scatter/gather: io with chained io_t is finished with single
+// recvmsg()/sendmsg() over all chain data ranges
+//
+
+bool receive_chain (io_t *io, void *remote_endpoint) noexcept
+{
+  ::iovec iov[io_t::max_chain_size];
+  ::msghdr msg{};
+  msg.msg_iov = iov;
+  msg.msg_iovlen = make_iov(io, iov);
+
+  size_t data_size = 0;
+  for (auto i = 0U;  i != msg.msg_iovlen;  ++i)
+  {
+    data_size += iov[i].iov_len;
+  }
+
+  if (remote_endpoint)
+  {
+    msg.msg_name = remote_endpoint;
+    msg.msg_namelen = static_cast<socklen_t>(
+      io->pending.receive_from.remote_endpoint_capacity
+    );
+  }
+
+  auto flags = *io->flags;
+#if __sal_os_linux
+  flags |= MSG_NOSIGNAL;
+#endif
+
+  auto size = ::recvmsg(io->owner->socket.handle, &msg, flags);
+
+  if (size == -1)
+  {
+    *io->transferred = 0;
+    io->status.assign(errno, std::generic_category());
+  }
+  else if (size == 0 && data_size && !remote_endpoint)
+  {
+    *io->transferred = 0;
+    io->status = std::make_error_code(std::errc::broken_pipe);
+  }
+  else if (msg.msg_flags & MSG_TRUNC)
+  {
+    *io->transferred = size;
+    io->status.assign(EMSGSIZE, std::generic_category());
+  }
+  else
+  {
+    *io->transferred = size;
+    io->status.clear();
+    if (remote_endpoint)
+    {
+      io->pending.receive_from.remote_endpoint_capacity = msg.msg_namelen;
+    }
+  }
+
+  return await_read(io);
+}
+
+
+bool finish_receive_from_chain (io_t *io, uint16_t, uint32_t) noexcept
+{
+  return receive_chain(io, io->pending.receive_from.remote_endpoint);
+}
+
+
+bool finish_receive_chain (io_t *io, uint16_t, uint32_t) noexcept
+{
+  return receive_chain(io, nullptr);
+}
+
+
+bool send_chain (io_t *io, void *remote_endpoint) noexcept
+{
+  ::iovec iov[io_t::max_chain_size];
+  ::msghdr msg{};
+  msg.msg_iov = iov;
+  msg.msg_iovlen = make_iov(io, iov);
+
+  if (remote_endpoint)
+  {
+    msg.msg_name = remote_endpoint;
+    msg.msg_namelen = static_cast<socklen_t>(
+      io->pending.send_to.remote_endpoint_size
+    );
+  }
+
+  auto flags = io->pending.send_to.flags;
+#if __sal_os_linux
+  flags |= MSG_NOSIGNAL;
+#endif
+
+  auto size = ::sendmsg(io->owner->socket.handle, &msg, flags);
+
+  if (size > -1)
+  {
+    *io->transferred = size;
+    io->status.clear();
+  }
+  else
+  {
+    // keep same mapping as net::__bits::socket_t
+    *io->transferred = 0;
+    io->status.assign(errno == EDESTADDRREQ ? ENOTCONN : errno,
+      std::generic_category()
+    );
+  }
+
+  return await_write(io);
+}
+
+
+bool finish_send_to_chain (io_t *io, uint16_t, uint32_t) noexcept
+{
+  return send_chain(io, &io->pending.send_to.remote_endpoint);
+}
+
+
+bool finish_send_chain (io_t *io, uint16_t, uint32_t) noexcept
+{
+  return send_chain(io, nullptr);
+}
+
+
+} // namespace
+
+
+void handler_t::start_receive_from (io_t *io,
+  void *remote_endpoint,
+  size_t remote_endpoint_capacity,
+  size_t *transferred,
+  message_flags_t *flags) noexcept
+{
+  io->owner = this;
+  io->on_finish = io->chain_next
+    ? finish_receive_from_chain
+    : finish_receive_from
+  ;
+  io->transferred = transferred;
+  io->flags = flags;
+
+#if __sal_io_uring
+  if (service->uring)
+  {
+    io->on_finish = uring_finish_receive_from;
+    uring_start_receive(io, remote_endpoint, remote_endpoint_capacity, true);
+    return;
+  }
+#endif
+
+  *io->flags |= MSG_DONTWAIT;
+  io->pending.receive_from.remote_endpoint = remote_endpoint;
+  io->pending.receive_from.remote_endpoint_capacity = remote_endpoint_capacity;
+
+  start(io, pending_read);
+}
+
+
+void handler_t::start_pooled_receive_from (io_t *io,
+  void *remote_endpoint,
+  size_t remote_endpoint_capacity,
+  size_t *transferred,
+  message_flags_t *flags) noexcept
+{
+  io->owner = this;
+  io->on_finish = finish_receive_from_pooled;
+  io->transferred = transferred;
+  io->flags = flags;
+
+#if __sal_io_uring
+  if (service->uring)
+  {
+    // replacements are started while reaping completions (flushed after
+    // reap) and initial pool by start_receive_from_pool() (flushed there)
+    io->on_finish = uring_finish_receive_from_pooled;
+    uring_start_receive(io, remote_endpoint, remote_endpoint_capacity, false);
+    return;
+  }
+#endif
+
+  *io->flags |= MSG_DONTWAIT;
+  io->pending.receive_from.remote_endpoint = remote_endpoint;
+  io->pending.receive_from.remote_endpoint_capacity = remote_endpoint_capacity;
+
+  start(io, pending_read);
+}
+
+
+void handler_t::start_receive (io_t *io,
+  size_t *transferred,
+  message_flags_t *flags) noexcept
+{
+  io->owner = this;
+  io->on_finish = io->chain_next
+    ? finish_receive_chain
+    : finish_receive
+  ;
+  io->transferred = transferred;
+  io->flags = flags;
+
+#if __sal_io_uring
+  if (service->uring)
+  {
+    io->on_finish = uring_finish_receive;
+    uring_start_receive(io, nullptr, 0, true);
+    return;
+  }
+#endif
+
+  *io->flags |= MSG_DONTWAIT;
+
+  start(io, pending_read);
+}
+
+
+void handler_t::start_send_to (io_t *io,
+  const void *remote_endpoint,
+  size_t remote_endpoint_size,
+  size_t *transferred,
+  message_flags_t flags) noexcept
+{
+  io->owner = this;
+  io->on_finish = io->chain_next
+    ? finish_send_to_chain
+    : finish_send_to
+  ;
+  io->transferred = transferred;
+
+  io->pending.send_to.flags = flags | MSG_DONTWAIT;
+
+  io->pending.send_to.remote_endpoint_size = remote_endpoint_size;
+  memcpy(
+    &io->pending.send_to.remote_endpoint,
+    remote_endpoint,
+    remote_endpoint_size
+  );
+
+#if __sal_io_uring
+  if (service->uring)
+  {
+    uring_start_send_to(io, flags, true);
+    return;
+  }
+#endif
+
+  start(io, pending_write);
+}
+
+
+void handler_t::start_send (io_t *io,
+  size_t *transferred,
+  message_flags_t flags) noexcept
+{
+  io->owner = this;
+  io->on_finish = io->chain_next
+    ? finish_send_chain
+    : finish_send
+  ;
+  io->transferred = transferred;
+
+  io->pending.send.flags = flags | MSG_DONTWAIT;
+
+#if __sal_io_uring
+  if (service->uring)
+  {
+    io->on_finish = uring_finish_send;
+
+    ::io_uring_sqe sqe{};
+    if (io->chain_next)
+    {
+      uring_make_message(io, nullptr, 0);
+      sqe.opcode = IORING_OP_SENDMSG;
+      sqe.addr = reinterpret_cast<uintptr_t>(&io->message);
+      sqe.len = 1;
+    }
+    else
+    {
+      sqe.opcode = IORING_OP_SEND;
+      sqe.addr = reinterpret_cast<uintptr_t>(io->begin);
+      sqe.len = static_cast<uint32_t>(io->end - io->begin);
+    }
+    sqe.msg_flags = flags | MSG_NOSIGNAL;
+    uring_start(io, sqe, true);
+    return;
+  }
+#endif
+
+  start(io, pending_write);
+}
+
+
+void handler_t::start_accept (io_t *io,
+  int /*family*/,
+  socket_t::handle_t *socket_handle) noexcept
+{
+  io->owner = this;
+  io->on_finish = finish_accept;
+
+  io->pending.accept.socket_handle = socket_handle;
+
+#if __sal_io_uring
+  if (service->uring)
+  {
+    io->on_finish = uring_finish_accept;
+    uring_start_accept(io);
+    return;
+  }
+#endif
+
+  start(io, pending_read);
+}
+
+
+void handler_t::start_connect (io_t *io,
+  const void *remote_endpoint,
+  size_t remote_endpoint_size) noexcept
+{
+  io->owner = this;
+  io->on_finish = finish_connect;
+
+#if __sal_io_uring
+  if (service->uring)
+  {
+    io->on_finish = uring_finish_connect;
+
+    io->pending.connect.remote_endpoint_size = remote_endpoint_size;
+    memcpy(
+      &io->pending.connect.remote_endpoint,
+      remote_endpoint,
+      remote_endpoint_size
+    );
+
+    ::io_uring_sqe sqe{};
+    sqe.opcode = IORING_OP_CONNECT;
+    sqe.addr = reinterpret_cast<uintptr_t>(&io->pending.connect.remote_endpoint);
+    sqe.off = remote_endpoint_size;
+    uring_start(io, sqe, true);
+    return;
+  }
+#endif
+
+  socket.connect(remote_endpoint, remote_endpoint_size, io->status);
+
+  start(io, pending_write);
+}
+
+
+#if __sal_os_linux
+
+
+void handler_t::start_receive_from_with_info (io_t *io,
+  void *remote_endpoint,
+  size_t remote_endpoint_capacity,
+  size_t *transferred,
+  message_flags_t *flags,
+  uint32_t *interface_index,
+  std::chrono::system_clock::time_point *timestamp,
+  net::ip::address_t *local_address) noexcept
+{
+  enable_receive_info(*this);
+
+  io->owner = this;
+  io->on_finish = finish_receive_from_with_info;
+  io->transferred = transferred;
+  io->flags = flags;
+
+  io->pending.receive_from.remote_endpoint = remote_endpoint;
+  io->pending.receive_from.remote_endpoint_capacity = remote_endpoint_capacity;
+  io->pending.receive_from.interface_index = interface_index;
+  io->pending.receive_from.timestamp = timestamp;
+  io->pending.receive_from.local_address = local_address;
+
+#if __sal_io_uring
+  if (service->uring)
+  {
+    io->on_finish = uring_finish_receive_from_with_info;
+    make_receive_message(io, io->message, uring_message_iov(io));
+
+    ::io_uring_sqe sqe{};
+    sqe.opcode = IORING_OP_RECVMSG;
+    sqe.addr = reinterpret_cast<uintptr_t>(&io->message);
+    sqe.len = 1;
+    sqe.msg_flags = *io->flags | MSG_NOSIGNAL;
+    uring_start(io, sqe, true);
+    return;
+  }
+#endif
+
+  *io->flags |= MSG_DONTWAIT;
+
+  start(io, pending_read);
+}
+
+
+void handler_t::start_receive_from_segmented (io_t *io,
+  void *remote_endpoint,
+  size_t remote_endpoint_capacity,
+  size_t *transferred,
+  message_flags_t *flags,
+  size_t *segment_size) noexcept
+{
+  io->owner = this;
+  io->on_finish = finish_receive_from_segmented;
+  io->transferred = transferred;
+  io->flags = flags;
+
+  io->pending.receive_from.remote_endpoint = remote_endpoint;
+  io->pending.receive_from.remote_endpoint_capacity = remote_endpoint_capacity;
+  io->pending.receive_from.segment_size = segment_size;
+
+#if __sal_io_uring
+  if (service->uring)
+  {
+    io->on_finish = uring_finish_receive_from_segmented;
+    make_receive_message(io, io->message, uring_message_iov(io));
+
+    ::io_uring_sqe sqe{};
+    sqe.opcode = IORING_OP_RECVMSG;
+    sqe.addr = reinterpret_cast<uintptr_t>(&io->message);
+    sqe.len = 1;
+    sqe.msg_flags = *io->flags | MSG_NOSIGNAL;
+    uring_start(io, sqe, true);
+    return;
+  }
+#endif
+
+  *io->flags |= MSG_DONTWAIT;
+
+  start(io, pending_read);
+}
+
+
+void handler_t::start_send_to_segmented (io_t *io,
+  const void *remote_endpoint,
+  size_t remote_endpoint_size,
+  size_t segment_size,
+  size_t *transferred,
+  message_flags_t flags) noexcept
+{
+  io->owner = this;
+  io->on_finish = finish_send_to_segmented;
+  io->transferred = transferred;
+
+  io->pending.send_to.flags = flags | MSG_DONTWAIT;
+
+  io->pending.send_to.remote_endpoint_size = remote_endpoint_size;
+  memcpy(
+    &io->pending.send_to.remote_endpoint,
+    remote_endpoint,
+    remote_endpoint_size
+  );
+
+  auto cmsg = reinterpret_cast<::cmsghdr *>(io->pending.send_to.control);
+  cmsg->cmsg_level = SOL_UDP;
+  cmsg->cmsg_type = UDP_SEGMENT;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+  auto size = static_cast<uint16_t>(segment_size);
+  std::memcpy(CMSG_DATA(cmsg), &size, sizeof(size));
+
+#if __sal_io_uring
+  if (service->uring)
+  {
+    io->on_finish = uring_finish_send;
+    make_segmented_send(io, io->message, uring_message_iov(io));
+
+    ::io_uring_sqe sqe{};
+    sqe.opcode = IORING_OP_SENDMSG;
+    sqe.addr = reinterpret_cast<uintptr_t>(&io->message);
+    sqe.len = 1;
+    sqe.msg_flags = flags | MSG_NOSIGNAL;
+    uring_start(io, sqe, true);
+    return;
+  }
+#endif
+
+  start(io, pending_write);
+}
+
+
+void handler_t::start_send_zerocopy (io_t *io,
+  const void *remote_endpoint,
+  size_t remote_endpoint_size,
+  size_t *transferred,
+  message_flags_t flags) noexcept
+{
+  io->owner = this;
+  io->on_finish = finish_send_zerocopy;
+  io->transferred = transferred;
+
+  io->pending.send_to.flags = flags | MSG_DONTWAIT;
+
+  io->pending.send_to.remote_endpoint_size = remote_endpoint_size;
+  if (remote_endpoint_size)
+  {
+    std::memcpy(
+      &io->pending.send_to.remote_endpoint,
+      remote_endpoint,
+      remote_endpoint_size
+    );
+  }
+
+#if __sal_io_uring
+  if (service->uring)
+  {
+    io->on_finish = uring_finish_send;
+    io->message_iov.iov_base = io->begin;
+    io->message_iov.iov_len = io->end - io->begin;
+    io->message = {};
+    io->message.msg_iov = &io->message_iov;
+    io->message.msg_iovlen = 1;
+    if (remote_endpoint_size)
+    {
+      io->message.msg_name = &io->pending.send_to.remote_endpoint;
+      io->message.msg_namelen = remote_endpoint_size;
+    }
+
+    ::io_uring_sqe sqe{};
+    sqe.opcode = IORING_OP_SENDMSG;
+    if (service->uring->sendmsg_zc)
+    {
+      io->on_finish = uring_finish_send_zerocopy;
+      sqe.opcode = IORING_OP_SENDMSG_ZC;
+    }
+    sqe.addr = reinterpret_cast<uintptr_t>(&io->message);
+    sqe.len = 1;
+    sqe.msg_flags = flags | MSG_NOSIGNAL;
+    uring_start(io, sqe, true);
+    return;
+  }
+#endif
+
+  start(io, pending_write);
+}
+
+
+namespace {
+
+void start (io_t **io, size_t count, handler_t::pending_t &pending) noexcept
+{
+  // drainer batches consecutive operations with same batch handler
+  (*io)->owner->count_started(count);
+  while (count--)
+  {
+    pending.incoming.push(*io++);
+  }
+  (void)drain(pending, 0, 0, nullptr);
+}
+
+} // namespace
+
+#endif
+
+
+void handler_t::start_receive_from_batch (io_t **io, size_t count) noexcept
+{
+#if __sal_os_linux
+  if (!uses_io_uring(*this))
+  {
+    for (auto it = io;  it != io + count;  ++it)
+    {
+      (*it)->owner = this;
+      (*it)->on_finish = finish_receive_from_batch;
+      *(*it)->flags |= MSG_DONTWAIT;
+    }
+    start(io, count, pending_read);
+    return;
+  }
+#endif
+
+#if __sal_io_uring
+  if (service->uring)
+  {
+    // submit all with single system call
+    for (auto it = io;  it != io + count;  ++it)
+    {
+      auto &pending = (*it)->pending.receive_from;
+      (*it)->owner = this;
+      (*it)->on_finish = uring_finish_receive_from;
+      uring_start_receive(*it,
+        pending.remote_endpoint,
+        pending.remote_endpoint_capacity,
+        false
+      );
+    }
+    service->uring->flush();
+    return;
+  }
+#endif
+
+  for (auto it = io;  it != io + count;  ++it)
+  {
+    auto &pending = (*it)->pending.receive_from;
+    start_receive_from(*it,
+      pending.remote_endpoint,
+      pending.remote_endpoint_capacity,
+      (*it)->transferred,
+      (*it)->flags
+    );
+  }
+}
+
+
+void handler_t::start_send_to_batch (io_t **io, size_t count) noexcept
+{
+#if __sal_os_linux
+  if (!uses_io_uring(*this))
+  {
+    for (auto it = io;  it != io + count;  ++it)
+    {
+      (*it)->owner = this;
+      (*it)->on_finish = finish_send_to_batch;
+      (*it)->flags = &(*it)->pending.send_to.flags;
+      *(*it)->flags |= MSG_DONTWAIT;
+    }
+    start(io, count, pending_write);
+    return;
+  }
+#endif
+
+#if __sal_io_uring
+  if (service->uring)
+  {
+    // pending data is already set up, submit all with single system call
+    for (auto it = io;  it != io + count;  ++it)
+    {
+      (*it)->owner = this;
+      uring_start_send_to(*it, (*it)->pending.send_to.flags, false);
+    }
+    service->uring->flush();
+    return;
+  }
+#endif
+
+  for (auto it = io;  it != io + count;  ++it)
+  {
+    // copy, start_send_to() sets up pending data from arguments
+    auto pending = (*it)->pending.send_to;
+    start_send_to(*it,
+      &pending.remote_endpoint,
+      pending.remote_endpoint_size,
+      (*it)->transferred,
+      pending.flags
+    );
+  }
+}
+
+
+namespace {
+
+// complete operations in pending list that match predicate with
+// operation_canceled, keeping order of remaining ones
+template <typename Predicate>
+void cancel_pending (handler_t::pending_t &pending, Predicate match) noexcept
+{
+  // claim drainer role, waiting until current drainer has finished
+  auto claim = [&pending]()
+  {
+    uint32_t idle = 0;
+    return pending.requests.compare_exchange_strong(idle, 1,
+      std::memory_order_seq_cst,
+      std::memory_order_relaxed
+    );
+  };
+  if (!claim())
+  {
+    handoff_wait(claim);
+  }
+
+  while (auto io = static_cast<io_t *>(pending.incoming.try_pop()))
+  {
+    pending.list.push(io);
+  }
+
+  io_t::pending_list_t remaining{};
+  while (auto io = static_cast<io_t *>(pending.list.try_pop()))
+  {
+    if (match(io))
+    {
+      io->status = std::make_error_code(std::errc::operation_canceled);
+      io->owner->completed.fetch_add(1, std::memory_order_relaxed);
+      io->owner = nullptr;
+      io->completed();
+    }
+    else
+    {
+      remaining.push(io);
+    }
+  }
+  pending.list = std::move(remaining);
+
+  // release drainer role and drain requests that arrived meanwhile
+  pending.requests.store(0, std::memory_order_release);
+  (void)drain(pending, 0, 0, nullptr);
+}
+
+} // namespace
+
+
+void handler_t::cancel (const io_t *io) noexcept
+{
+#if __sal_io_uring
+  if (service->uring)
+  {
+    // io memory is never released while service exists, but it may have
+    // been already completed and restarted on other socket
+    if (io->owner == this)
+    {
+      uring_cancel(*this, io);
+    }
+    return;
+  }
+#endif
+
+  // io can be only in one of lists, pointer is compared but not dereferenced
+  auto match = [io](const io_t *it) { return it == io; };
+  cancel_pending(pending_read, match);
+  cancel_pending(pending_write, match);
+}
+
+
+void handler_t::cancel_all () noexcept
+{
+  stop_receive_pool(*this);
+
+#if __sal_io_uring
+  if (service->uring)
+  {
+    uring_cancel(*this, nullptr);
+    return;
+  }
+#endif
+
+  // MSG_ZEROCOPY sends waiting for notification are already sent, these
+  // are completed normally
+  auto match = [](const io_t *) { return true; };
+  cancel_pending(pending_read, match);
+  cancel_pending(pending_write, match);
+}
+
+
+bool handler_t::cancel_expired (const io_t *io) noexcept
+{
+#if __sal_io_uring
+  if (service->uring)
+  {
+    if (io->owner == this)
+    {
+      uring_cancel(*this, io);
+    }
+    return true;
+  }
+#endif
+
+  // if io has completed and is restarted on same socket meanwhile, it's
+  // deadline is already cleared and new operation is left alone
+  auto found = false;
+  auto match = [io, &found](const io_t *it)
+  {
+    if (it != io
+      || it->deadline.load(std::memory_order_relaxed)
+        != service_t::deadline_expired)
+    {
+      return false;
+    }
+    return found = true;
+  };
+  cancel_pending(pending_read, match);
+  cancel_pending(pending_write, match);
+  return found;
+}
+
+
+#endif //}}}1
+
+
+namespace {
+
+// pooled receive completions of single handler finished by calling thread
+// since it last started waiting (i.e. size of burst)
+thread_local struct
+{
+  const handler_t *handler;
+  uint32_t size;
+} receive_burst{};
+
+
+// start new pooled receive set up from handler.receive_pool, return false
+// if io_t could not be allocated
+bool start_pooled_receive (handler_t &handler) noexcept
+{
+  auto &pool = handler.receive_pool;
+
+  io_t *io;
+  try
+  {
+    io = handler.service->make_io(pool.completed_list, pool.size_class);
+  }
+  catch (...)
+  {
+    return false;
+  }
+
+  io->op = pool.op;
+  io->context_type = pool.context_type;
+  io->context = pool.context;
+
+  auto flags = reinterpret_cast<message_flags_t *>(
+    io->result + pool.flags_offset
+  );
+  *flags = pool.flags;
+
+  handler.start_pooled_receive_from(io,
+    io->result + pool.remote_endpoint_offset,
+    pool.remote_endpoint_capacity,
+    reinterpret_cast<size_t *>(io->result + pool.transferred_offset),
+    flags
+  );
+  return true;
+}
+
+
+// start pooled receives until there are depth outstanding
+void fill_receive_pool (handler_t &handler) noexcept
+{
+  auto &pool = handler.receive_pool;
+  auto posted = pool.posted.load(std::memory_order_relaxed);
+  while (posted < pool.depth.load(std::memory_order_relaxed))
+  {
+    if (!pool.posted.compare_exchange_weak(posted, posted + 1,
+        std::memory_order_relaxed))
+    {
+      continue;
+    }
+    if (!start_pooled_receive(handler))
+    {
+      pool.posted.fetch_sub(1, std::memory_order_relaxed);
+      return;
+    }
+    ++posted;
+  }
+}
+
+} // namespace
+
+
+void handler_t::start_receive_from_pool (io_t *io,
+  void *remote_endpoint,
+  size_t remote_endpoint_capacity,
+  size_t *transferred,
+  message_flags_t *flags,
+  size_t depth,
+  size_t max_depth) noexcept
+{
+  auto offset = [io](const void *field) -> size_t
+  {
+    return static_cast<const std::byte *>(field) - io->result;
+  };
+
+  auto &pool = receive_pool;
+  pool.op = io->op;
+  pool.context_type = io->context_type;
+  pool.context = io->context;
+  pool.completed_list = io->completed_list;
+  pool.size_class = io->size_class;
+  pool.flags = *flags;
+  pool.remote_endpoint_capacity = remote_endpoint_capacity;
+  pool.remote_endpoint_offset = offset(remote_endpoint);
+  pool.transferred_offset = offset(transferred);
+  pool.flags_offset = offset(flags);
+
+  constexpr size_t limit = (std::numeric_limits<uint32_t>::max)();
+  pool.min_depth = static_cast<uint32_t>((std::clamp)(depth, size_t{1}, limit));
+  pool.max_depth = static_cast<uint32_t>(
+    (std::clamp)(max_depth, size_t{pool.min_depth}, limit)
+  );
+  pool.window.store(0, std::memory_order_relaxed);
+  pool.peak_burst.store(0, std::memory_order_relaxed);
+  pool.depth.store(pool.min_depth, std::memory_order_relaxed);
+
+  pool.posted.fetch_add(1, std::memory_order_relaxed);
+  start_pooled_receive_from(io,
+    remote_endpoint,
+    remote_endpoint_capacity,
+    transferred,
+    flags
+  );
+  fill_receive_pool(*this);
+
+#if __sal_io_uring
+  if (service->uring)
+  {
+    service->uring->flush();
+  }
+#endif
+}
+
+
+void handler_t::replenish_receive_pool (const io_t *io) noexcept
+{
+  auto &pool = receive_pool;
+
+  // saturating: cancel_all() resets counter while receives are in flight
+  auto posted = pool.posted.load(std::memory_order_relaxed);
+  while (posted && !pool.posted.compare_exchange_weak(posted, posted - 1,
+      std::memory_order_relaxed))
+  { }
+
+  auto depth = pool.depth.load(std::memory_order_relaxed);
+  if (!depth)
+  {
+    return;
+  }
+
+  // truncated datagram or ICMP error does not fail socket itself
+  if (io->status
+    && io->status != std::errc::message_size
+    && io->status != std::errc::connection_refused)
+  {
+    return;
+  }
+
+  auto &burst = receive_burst;
+  if (burst.handler != this)
+  {
+    burst.handler = this;
+    burst.size = 0;
+  }
+  ++burst.size;
+
+  if (burst.size >= depth && depth < pool.max_depth)
+  {
+    // burst consumed whole pool: double it
+    depth = (std::min)(depth * 2, pool.max_depth);
+    pool.depth.store(depth, std::memory_order_relaxed);
+  }
+
+  auto peak = pool.peak_burst.load(std::memory_order_relaxed);
+  while (peak < burst.size
+    && !pool.peak_burst.compare_exchange_weak(peak, burst.size,
+      std::memory_order_relaxed))
+  { }
+
+  if (pool.window.fetch_add(1, std::memory_order_relaxed) + 1
+    == receive_pool_t::window_size)
+  {
+    // bursts during window used less than half of pool: halve it
+    pool.window.store(0, std::memory_order_relaxed);
+    peak = pool.peak_burst.exchange(0, std::memory_order_relaxed);
+    if (peak * 2 < depth && depth > pool.min_depth)
+    {
+      depth = (std::max)(depth / 2, pool.min_depth);
+      pool.depth.store(depth, std::memory_order_relaxed);
+    }
+  }
+
+  fill_receive_pool(*this);
+}
+
+
+void completion_queue_t::post (io_t *io) noexcept
+{
+  auto own = has_reactor();
+  io->owner = nullptr;
+  io->completed(own ? completed_list : service->completed_list);
+
+  // pairs with fence in wait_io_or_posted(): either waiter sees posted io
+  // or this thread sees waiter and signals it
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  auto &wakeup = own ? this->wakeup : service->wakeup;
+  if (wakeup.waiters.load(std::memory_order_relaxed)
+    && !wakeup.signaled.exchange(true, std::memory_order_acq_rel))
+  {
+    notify(*service, wakeup);
+  }
+}
+
+
+namespace {
+
+// blocking wait_io() announced to posting threads: if io was posted after
+// caller last checked it's lists, do not block at all
+bool wait_io_or_posted (completion_queue_t &queue,
+  const std::chrono::milliseconds &timeout,
+  std::error_code &error) noexcept
+{
+  if (timeout.count() == 0)
+  {
+    return queue.wait_io(timeout, error);
+  }
+
+  auto own = queue.has_reactor();
+  auto &service = *queue.service;
+  service.wakeup.waiters.fetch_add(1, std::memory_order_relaxed);
+  if (own)
+  {
+    queue.wakeup.waiters.fetch_add(1, std::memory_order_relaxed);
+  }
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  auto completed = true;
+  if (queue.has_posted())
+  {
+    error.clear();
+  }
+  else
+  {
+    completed = queue.wait_io(timeout, error);
+    queue.count(queue.waits);
+    if (completed)
+    {
+      queue.count(queue.wakeups);
+    }
+  }
+
+  if (own)
+  {
+    queue.wakeup.waiters.fetch_sub(1, std::memory_order_relaxed);
+  }
+  service.wakeup.waiters.fetch_sub(1, std::memory_order_relaxed);
+  return completed;
+}
+
+
+// complete expired timers into queue and cancel operations past their
+// deadlines, returning true if there were any (on the way, release idle
+// io_t pool blocks)
+bool expire (completion_queue_t &queue) noexcept
+{
+  queue.service->trim_io_pool();
+
+  auto any = queue.service->expire_timers(queue.completed_list);
+  if (queue.service->expire_deadlines())
+  {
+    // canceled operations are completed immediately (epoll) or their
+    // completions are posted when cancel requests are submitted (io_uring)
+    std::error_code ignored;
+    (void)queue.poll_io(ignored);
+    any = true;
+  }
+  return any;
+}
+
+} // namespace
+
+
+bool completion_queue_t::wait (const std::chrono::milliseconds &timeout,
+  std::error_code &error) noexcept
+{
+  auto cache = use_io_cache(*service);
+  if (cache && service->io_pool_capped.load(std::memory_order_relaxed))
+  {
+    // don't hide free io_t from other threads while idle
+    cache->flush();
+  }
+  receive_burst = {};
+
+  auto io_timeout = service->timer_timeout(timeout);
+  if (busy_poll_budget.count() == 0 || io_timeout.count() == 0)
+  {
+    auto completed = wait_io_or_posted(*this, io_timeout, error);
+    return expire(*this) || completed;
+  }
+
+  // spin up to budget (or timeout if it is shorter)
+  using clock_t = std::chrono::steady_clock;
+  auto start = clock_t::now(), now = start;
+  auto spin_until = start + busy_poll_budget;
+  auto timeout_within_budget = false;
+  if (io_timeout != io_timeout.max() && io_timeout < busy_poll_budget)
+  {
+    spin_until = start + io_timeout;
+    timeout_within_budget = true;
+  }
+
+  // io posted by other threads (without waking anyone while this thread
+  // is not blocked) also ends spinning
+  auto completed = false;
+  do
+  {
+    completed = poll_io(error) || has_posted();
+    if (error)
+    {
+      return false;
+    }
+    now = clock_t::now();
+  } while (!completed && now < spin_until);
+
+  if (completed)
+  {
+    count(busy_poll_completions);
+  }
+  else if (!timeout_within_budget)
+  {
+    count(busy_poll_blocks);
+
+    auto remaining = io_timeout;
+    if (io_timeout != io_timeout.max())
+    {
+      remaining -= std::chrono::duration_cast<std::chrono::milliseconds>(
+        now - start
+      );
+      remaining = (std::max)(remaining, std::chrono::milliseconds::zero());
+    }
+    completed = wait_io_or_posted(*this, remaining, error);
+  }
+
+  return expire(*this) || completed;
+}
+
+
+completion_queue_t::completion_queue_t (service_ptr service) noexcept
+  : service(service)
+{
+  if (!thread_queue)
+  {
+    thread_queue = this;
+  }
+
+  std::lock_guard lock(service->queues_mutex);
+  if ((next = service->queues))
+  {
+    next->prev = this;
+  }
+  service->queues = this;
+}
+
+
+completion_queue_t::~completion_queue_t () noexcept
+{
+  while (auto io = completed_list.try_pop())
+  {
+    // already completed (and counted), only move it
+    io->completed_list = &service->completed_list;
+    service->completed_list.push(io);
+  }
+
+  if (thread_queue == this)
+  {
+    thread_queue = nullptr;
+  }
+
+  std::lock_guard lock(service->queues_mutex);
+  (prev ? prev->next : service->queues) = next;
+  if (next)
+  {
+    next->prev = prev;
+  }
+
+  auto &retired = service->retired_stats;
+  auto counters = stats();
+  retired.waits += counters.waits;
+  retired.wakeups += counters.wakeups;
+  retired.events += counters.events;
+  retired.would_block += counters.would_block;
+
+#if __sal_os_linux || __sal_os_macos
+  close_wakeup(wakeup);
+  if (reactor != -1)
+  {
+    (void)::close(reactor);
+  }
+#endif
+}
+
+
+void timer_wheel_t::insert (io_base_t *io) noexcept
+{
+  auto delay = (std::min)(io->pending.timer.expires - now, max_delay);
+  auto at = now + delay;
+
+  size_t level = 0;
+  while (delay >> (level_bits * (level + 1)))
+  {
+    ++level;
+  }
+
+  slots[level][(at >> (level_bits * level)) & (slot_count - 1)].push(io);
+  ++level_size[level];
+  ++size;
+}
+
+
+void timer_wheel_t::process (io_t::pending_list_t &expired) noexcept
+{
+  // on level boundary, move timers from higher level into lower ones
+  for (auto level = 1U;  level != level_count;  ++level)
+  {
+    auto shift = level_bits * level;
+    if (now & ((1ULL << shift) - 1))
+    {
+      break;
+    }
+
+    auto list = std::move(slots[level][(now >> shift) & (slot_count - 1)]);
+    while (auto io = list.try_pop())
+    {
+      --level_size[level];
+      --size;
+      insert(io);
+    }
+  }
+
+  auto &slot = slots[0][now & (slot_count - 1)];
+  while (auto io = slot.try_pop())
+  {
+    --level_size[0];
+    --size;
+    expired.push(io);
+  }
+}
+
+
+void timer_wheel_t::advance (uint64_t tick, io_t::pending_list_t &expired)
+  noexcept
+{
+  while (now < tick)
+  {
+    if (!size)
+    {
+      now = tick;
+    }
+    else if (!level_size[0])
+    {
+      // nothing to expire before next level 0 boundary
+      auto boundary = (now | (slot_count - 1)) + 1;
+      if (boundary > tick)
+      {
+        now = tick;
+      }
+      else
+      {
+        now = boundary;
+        process(expired);
+      }
+    }
+    else
+    {
+      ++now;
+      process(expired);
+    }
+  }
+}
+
+
+uint64_t timer_wheel_t::next_tick () const noexcept
+{
+  auto result = (std::numeric_limits<uint64_t>::max)();
+  for (auto level = 0U;  level != level_count;  ++level)
+  {
+    if (!level_size[level])
+    {
+      continue;
+    }
+
+    auto shift = level_bits * level;
+    auto index = now >> shift;
+    for (auto i = 1U;  i <= slot_count;  ++i)
+    {
+      if (!slots[level][(index + i) & (slot_count - 1)].empty())
+      {
+        result = (std::min)(result, (index + i) << shift);
+        break;
+      }
+    }
+  }
+  return result;
+}
+
+
+void service_t::start_timer (io_t *io,
+  const std::chrono::steady_clock::time_point &deadline) noexcept
+{
+  using namespace std::chrono;
+
+  io->owner = nullptr;
+  io->status.clear();
+
+  auto now = steady_clock::now();
+  auto tick = ceil<milliseconds>(deadline - timer_epoch).count();
+  if (deadline > now && tick > 0)
+  {
+    std::lock_guard lock(timer_mutex);
+    if (!timers.size)
+    {
+      // wheel is not advanced while empty
+      timers.now = duration_cast<milliseconds>(now - timer_epoch).count();
+    }
+    if (static_cast<uint64_t>(tick) > timers.now)
+    {
+      io->pending.timer.expires = tick;
+      timers.insert(io);
+      return;
+    }
+  }
+
+  io->completed();
+}
+
+
+std::chrono::milliseconds service_t::timer_timeout (
+  const std::chrono::milliseconds &timeout) noexcept
+{
+  using namespace std::chrono;
+
+  uint64_t tick;
+  {
+    std::lock_guard lock(timer_mutex);
+    tick = timers.next_tick();
+  }
+  tick = (std::min)(tick, next_deadline());
+
+  if (tick == (std::numeric_limits<uint64_t>::max)())
+  {
+    return timeout;
+  }
+
+  auto remaining = timer_epoch + milliseconds(tick) - steady_clock::now();
+  if (remaining <= remaining.zero())
+  {
+    return milliseconds::zero();
+  }
+  return (std::min)(timeout, ceil<milliseconds>(remaining));
+}
+
+
+bool service_t::expire_timers (io_t::completed_list_t &queue) noexcept
+{
+  using namespace std::chrono;
+
+  io_t::pending_list_t expired{};
+  {
+    auto tick = duration_cast<milliseconds>(
+      steady_clock::now() - timer_epoch
+    ).count();
+
+    std::lock_guard lock(timer_mutex);
+    timers.advance(tick, expired);
+  }
+
+  auto any = false;
+  while (auto io = expired.try_pop())
+  {
+    any |= io->completed_list != &io->free_list();
+    io->completed(queue);
+  }
+  return any;
+}
+
+
+namespace {
+
+// shard mutex is locked by caller for following helpers
+
+inline void update_next_deadline (service_t::deadline_shard_t &shard) noexcept
+{
+  shard.next.store(
+    shard.deadlines.empty()
+      ? service_t::no_deadline
+      : shard.deadlines.begin()->first,
+    std::memory_order_relaxed
+  );
+}
+
+
+void insert_deadline (service_t::deadline_shard_t &shard,
+  io_base_t *io,
+  uint64_t tick)
+{
+  auto [it, inserted] = shard.deadlines.emplace(tick, io);
+  try
+  {
+    shard.ticks.emplace(io, tick);
+  }
+  catch (...)
+  {
+    shard.deadlines.erase(it);
+    throw;
+  }
+  io->deadline.store(service_t::deadline_pending, std::memory_order_relaxed);
+  update_next_deadline(shard);
+}
+
+
+void erase_deadline (service_t::deadline_shard_t &shard,
+  io_base_t *io,
+  uint64_t tick) noexcept
+{
+  shard.deadlines.erase({tick, io});
+  shard.ticks.erase(io);
+  update_next_deadline(shard);
+}
+
+} // namespace
+
+
+bool service_t::set_deadline (io_t *io,
+  const std::chrono::steady_clock::time_point &deadline) noexcept
+{
+  using namespace std::chrono;
+
+  auto tick = ceil<milliseconds>(deadline - timer_epoch).count();
+  if (deadline <= steady_clock::now() || tick <= 0)
+  {
+    io->status = std::make_error_code(std::errc::timed_out);
+    return false;
+  }
+
+  auto &shard = deadline_shard(io);
+  std::lock_guard lock(shard.mutex);
+  try
+  {
+    insert_deadline(shard, io, tick);
+  }
+  catch (const std::bad_alloc &)
+  {
+    io->status = std::make_error_code(std::errc::not_enough_memory);
+    return false;
+  }
+  return true;
+}
+
+
+void service_t::clear_deadline (io_base_t *io) noexcept
+{
+  auto &shard = deadline_shard(io);
+  std::lock_guard lock(shard.mutex);
+  if (io->deadline.load(std::memory_order_relaxed) == deadline_expired)
+  {
+    // unless operation managed to finish before cancel got to it
+    if (io->status == std::errc::operation_canceled)
+    {
+      io->status = std::make_error_code(std::errc::timed_out);
+    }
+  }
+  else if (auto it = shard.ticks.find(io);  it != shard.ticks.end())
+  {
+    erase_deadline(shard, io, it->second);
+  }
+  io->deadline.store(0, std::memory_order_relaxed);
+}
+
+
+void service_t::clear_deadlines (const handler_t *owner) noexcept
+{
+  for (auto &shard: deadline_shards)
+  {
+    std::lock_guard lock(shard.mutex);
+    for (auto it = shard.deadlines.begin();  it != shard.deadlines.end();  )
+    {
+      auto [tick, io] = *it++;
+      if (io->owner == owner)
+      {
+        io->deadline.store(0, std::memory_order_relaxed);
+        erase_deadline(shard, io, tick);
+      }
+    }
+  }
+
+  // wait for expire_deadlines() to finish with owner's operations
+  handoff_wait(
+    [owner]()
+    {
+      return !owner->deadline_refs.load(std::memory_order_seq_cst);
+    }
+  );
+}
+
+
+bool service_t::expire_deadlines () noexcept
+{
+  using namespace std::chrono;
+
+  auto tick = static_cast<uint64_t>(
+    duration_cast<milliseconds>(steady_clock::now() - timer_epoch).count()
+  );
+  if (tick < next_deadline())
+  {
+    return false;
+  }
+
+  // owners cancel without lock (completion of canceled io needs it), so
+  // expired operations are collected in batches until shard has none left
+  constexpr size_t max_expired = 16;
+  std::pair<io_t *, handler_t *> expired[max_expired];
+  auto any = false;
+
+  for (auto &shard: deadline_shards)
+  {
+    while (tick >= shard.next.load(std::memory_order_relaxed))
+    {
+      size_t expired_count = 0;
+      {
+        std::lock_guard lock(shard.mutex);
+        while (expired_count < max_expired
+          && !shard.deadlines.empty()
+          && shard.deadlines.begin()->first <= tick)
+        {
+          auto [expires, io] = *shard.deadlines.begin();
+          erase_deadline(shard, io, expires);
+
+          // owner is cleared when io is already completing (canceled by
+          // application or closed socket), leave it's status alone
+          auto owner = io->owner;
+          if (!owner)
+          {
+            io->deadline.store(0, std::memory_order_relaxed);
+            continue;
+          }
+
+          io->deadline.store(deadline_expired, std::memory_order_relaxed);
+          owner->deadline_refs.fetch_add(1, std::memory_order_relaxed);
+          expired[expired_count++] = {static_cast<io_t *>(io), owner};
+        }
+      }
+
+      for (size_t i = 0;  i != expired_count;  ++i)
+      {
+        auto [io, owner] = expired[i];
+        if (!owner->cancel_expired(io))
+        {
+          // not pending: either it is completing right now or starting
+          // thread has not got to start it yet; retry on next tick
+          std::lock_guard lock(shard.mutex);
+          if (io->deadline.load(std::memory_order_relaxed) == deadline_expired)
+          {
+            try
+            {
+              insert_deadline(shard, io, tick + 1);
+            }
+            catch (const std::bad_alloc &)
+            {
+              io->deadline.store(0, std::memory_order_relaxed);
+            }
+          }
+        }
+        owner->deadline_refs.fetch_sub(1, std::memory_order_seq_cst);
+        handoff_notify();
+      }
+      any |= expired_count > 0;
+    }
+  }
+
+  return any;
+}
+
+
+bool handler_t::start_deadline (io_t *io,
+  const std::chrono::steady_clock::time_point &deadline) noexcept
+{
+  has_deadlines.store(true, std::memory_order_relaxed);
+  io->owner = this;
+  if (service->set_deadline(io, deadline))
+  {
+    return true;
+  }
+  io->owner = nullptr;
+  io->completed();
+  return false;
+}
+
+
+#if __sal_os_linux
+
+namespace {
+
+void bind_to_local_node (void *block, size_t size) noexcept
+{
+  unsigned cpu, node;
+  if (::syscall(SYS_getcpu, &cpu, &node, nullptr) == -1)
+  {
+    return;
+  }
+
+  constexpr size_t bits = 8 * sizeof(unsigned long);
+  unsigned long mask[1024 / bits]{};
+  if (node >= 1024)
+  {
+    return;
+  }
+  mask[node / bits] = 1UL << (node % bits);
+
+  // preferred (not strict) binding: allocate elsewhere if node runs out
+  (void)::syscall(SYS_mbind, block, size, MPOL_PREFERRED, mask, 1024, 0);
+}
+
+} // namespace
+
+
+io_block_ptr alloc_io_block (size_t size, const io_pool_policy_t &policy)
+{
+  using huge_pages_t = io_pool_policy_t::huge_pages_t;
+
+  if (policy.huge_pages == huge_pages_t::none
+    && !policy.lock
+    && !policy.numa_local)
+  {
+    return io_block_ptr{new std::byte[size]};
+  }
+
+  auto block = MAP_FAILED;
+  if (policy.huge_pages == huge_pages_t::reserved)
+  {
+    auto huge_size = (size + huge_page_size - 1) / huge_page_size * huge_page_size;
+    block = ::mmap(nullptr, huge_size,
+      PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+      -1,
+      0
+    );
+    if (block != MAP_FAILED)
+    {
+      size = huge_size;
+    }
+  }
+
+  if (block == MAP_FAILED)
+  {
+    // not requested or no reserved huge pages left
+    block = ::mmap(nullptr, size,
+      PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS,
+      -1,
+      0
+    );
+    if (block == MAP_FAILED)
+    {
+      throw std::bad_alloc();
+    }
+    if (policy.huge_pages != huge_pages_t::none)
+    {
+      (void)::madvise(block, size, MADV_HUGEPAGE);
+    }
+  }
+
+  // before pages are touched by io_t construction
+  if (policy.numa_local)
+  {
+    bind_to_local_node(block, size);
+  }
+
+  // best effort, may be limited by RLIMIT_MEMLOCK
+  if (policy.lock)
+  {
+    (void)::mlock(block, size);
+  }
+
+  return io_block_ptr{static_cast<std::byte *>(block), io_block_deleter_t{size}};
+}
+
+
+void io_block_deleter_t::operator() (std::byte *block) const noexcept
+{
+  if (mapped_size)
+  {
+    (void)::munmap(block, mapped_size);
+  }
+  else
+  {
+    delete[] block;
+  }
+}
+
+#else
+
+io_block_ptr alloc_io_block (size_t size, const io_pool_policy_t &)
+{
+  // allocation policy is not supported
+  return io_block_ptr{new std::byte[size]};
+}
+
+
+void io_block_deleter_t::operator() (std::byte *block) const noexcept
+{
+  delete[] block;
+}
+
+#endif
+
+
+io_base_t *service_t::alloc_io (size_t size_class)
+{
+  auto &pool = io_pool[size_class];
+  auto io = pool.free_list.try_pop();
+  if (!io)
+  {
+    // grow exponentially but limit single allocation for large classes and
+    // whole pool to io_pool_limit
+    constexpr size_t max_alloc_size = 16 * 1024 * 1024;
+    auto block_size = io_t::block_size(size_class);
+    auto limit = io_pool_limit.load(std::memory_order_relaxed);
+    auto available = limit > io_pool_memory ? limit - io_pool_memory : 0;
+    auto batch_size = std::min<size_t>(
+      std::min<size_t>(
+        16 * (1ULL << pool.blocks.size()),
+        max_alloc_size / block_size
+      ),
+      available / block_size
+    );
+    if (!batch_size)
+    {
+      io_pool_capped.store(true, std::memory_order_relaxed);
+      return nullptr;
+    }
+
+    if (io_pool_policy.huge_pages != io_pool_policy_t::huge_pages_t::none)
+    {
+      // use whole huge pages (if limit allows)
+      auto size = batch_size * block_size;
+      size = (size + huge_page_size - 1) / huge_page_size * huge_page_size;
+      if (size <= available)
+      {
+        batch_size = size / block_size;
+      }
+    }
+
+    auto &block = pool.blocks.emplace_back();
+    try
+    {
+      block.data = alloc_io_block(batch_size * block_size, io_pool_policy);
+    }
+    catch (...)
+    {
+      pool.blocks.pop_back();
+      throw;
+    }
+    block.size = batch_size;
+    ++io_pool_grows;
+    io_pool_size += batch_size;
+    io_pool_peak_size = (std::max)(io_pool_peak_size, io_pool_size);
+    io_pool_memory += batch_size * block_size;
+    io_pool_free.fetch_add(batch_size, std::memory_order_relaxed);
+    if (io_pool_memory + block_size > limit)
+    {
+      // last growth for this size class
+      io_pool_capped.store(true, std::memory_order_relaxed);
+    }
+
+    auto it = block.data.get();
+    while (batch_size--)
+    {
+      pool.free_list.push(new(it) io_t(*this, &completed_list, size_class));
+      it += block_size;
+    }
+
+    io = pool.free_list.try_pop();
+    io_released();
+  }
+  io_pool_free.fetch_sub(1, std::memory_order_relaxed);
+  return io;
 }
 
 
-namespace {
+io_t *service_t::try_make_io (io_t::completed_list_t *completed,
+  size_t size_class)
+{
+  sal_throw_if(size_class >= io_t::size_class_count);
 
+  io_base_t *io;
 
-inline void start (io_t *io, handler_t::pending_t &pending) noexcept
-{
-  std::lock_guard lock(pending.mutex);
-  if (pending.list.empty() && (*io->on_finish)(io, 0, 0))
+  auto cache = thread_io_cache;
+  if (cache && cache->service.load(std::memory_order_relaxed) != this)
   {
-    io->completed();
+    cache = nullptr;
+  }
+
+  if (cache && !io_pool_capped.load(std::memory_order_relaxed))
+  {
+    io = cache->alloc(size_class);
   }
   else
   {
-    pending.list.push(io);
+    if (cache)
+    {
+      // pool is capped: stop caching, make cached io_t available to all
+      cache->flush();
+    }
+    std::lock_guard lock(io_pool_mutex);
+    io = alloc_io(size_class);
   }
-}
 
+  auto result = static_cast<io_t *>(io);
+  if (!result)
+  {
+    return result;
+  }
 
-bool finish_receive_from (io_t *io, uint16_t, uint32_t) noexcept
-{
-  *io->transferred = io->owner->socket.receive_from(
-    io->begin,
-    io->end - io->begin,
-    io->pending.receive_from.remote_endpoint,
-    &io->pending.receive_from.remote_endpoint_capacity,
-    *io->flags,
-    io->status
-  );
-  return await_read(io);
+  if (result->chain_next)
+  {
+    // head was released internally (skip_completion_notification)
+    release_io(std::exchange(result->chain_next, nullptr));
+  }
+  result->begin = result->data();
+  result->end = result->data() + result->data_size;
+  result->completed_list = completed;
+  result->owner = nullptr;
+  return result;
 }
 
 
-bool finish_receive (io_t *io, uint16_t, uint32_t) noexcept
+io_t *service_t::try_make_io_for (io_t::completed_list_t *completed,
+  size_t size_class,
+  const std::chrono::milliseconds &timeout)
 {
-  *io->transferred = io->owner->socket.receive(
-    io->begin,
-    io->end - io->begin,
-    *io->flags,
-    io->status
-  );
-  return await_read(io);
-}
-
+  auto deadline = std::chrono::steady_clock::now() + timeout;
 
-bool finish_send_to (io_t *io, uint16_t, uint32_t) noexcept
-{
-  *io->transferred = io->owner->socket.send_to(
-    io->begin,
-    io->end - io->begin,
-    &io->pending.send_to.remote_endpoint,
-    io->pending.send_to.remote_endpoint_size,
-    io->pending.send_to.flags,
-    io->status
-  );
-  return await_write(io);
+  // releasing threads check io_pool_waiters after pushing io_t to
+  // free_list: either release is seen by try_make_io() or it signals
+  io_pool_waiters.fetch_add(1, std::memory_order_seq_cst);
+  io_t *io = nullptr;
+  try
+  {
+    for (;;)
+    {
+      auto releases = io_pool_releases.load(std::memory_order_relaxed);
+      if ((io = try_make_io(completed, size_class)))
+      {
+        break;
+      }
+
+      std::unique_lock lock(io_pool_wait_mutex);
+      if (!io_pool_released.wait_until(lock, deadline,
+          [this, releases]()
+          {
+            return io_pool_releases.load(std::memory_order_relaxed) != releases;
+          }))
+      {
+        break;
+      }
+    }
+  }
+  catch (...)
+  {
+    io_pool_waiters.fetch_sub(1, std::memory_order_relaxed);
+    throw;
+  }
+  io_pool_waiters.fetch_sub(1, std::memory_order_relaxed);
+  return io;
 }
 
 
-bool finish_send (io_t *io, uint16_t, uint32_t) noexcept
+void service_t::notify_io_waiters () noexcept
 {
-  *io->transferred = io->owner->socket.send(
-    io->begin,
-    io->end - io->begin,
-    io->pending.send_to.flags,
-    io->status
-  );
-  return await_write(io);
+  {
+    std::lock_guard lock(io_pool_wait_mutex);
+    io_pool_releases.fetch_add(1, std::memory_order_relaxed);
+  }
+  io_pool_released.notify_all();
 }
 
 
-bool finish_accept (io_t *io, uint16_t, uint32_t) noexcept
+service_stats_t service_t::stats () noexcept
 {
-  *io->pending.accept.socket_handle = io->owner->socket.accept(
-    nullptr,
-    nullptr,
-    false,
-    io->status
-  );
-  return await_read(io);
+  service_stats_t result{};
+  {
+    std::lock_guard lock(queues_mutex);
+    static_cast<io_stats_t &>(result) = retired_stats;
+    for (auto queue = queues;  queue;  queue = queue->next)
+    {
+      auto counters = queue->stats();
+      result.waits += counters.waits;
+      result.wakeups += counters.wakeups;
+      result.events += counters.events;
+      result.would_block += counters.would_block;
+    }
+  }
+
+  std::lock_guard lock(io_pool_mutex);
+  result.io_pool_grows = io_pool_grows;
+  result.io_pool_trims = io_pool_trims;
+  return result;
 }
 
 
-bool finish_connect (io_t *io, uint16_t flags, uint32_t fflags) noexcept
+void service_t::trim_io_pool () noexcept
 {
-  if (io->status == std::errc::operation_in_progress)
+  using namespace std::chrono;
+
+  auto high_water = io_pool_high_water.load(std::memory_order_relaxed);
+  if (high_water == no_io_pool_limit)
   {
-    // just started socket.connect() in start_connect()
-    // wait socket to become writable
-    io->status = std::make_error_code(std::errc::operation_would_block);
-    return await_write(io);
+    return;
   }
-  else if (io->status != std::errc::operation_would_block)
+
+  // single thread per idle timeout does the check
+  auto tick = static_cast<uint64_t>(
+    duration_cast<milliseconds>(steady_clock::now() - timer_epoch).count()
+  );
+  auto next_trim = io_pool_next_trim.load(std::memory_order_relaxed);
+  if (tick < next_trim
+    || !io_pool_next_trim.compare_exchange_strong(next_trim,
+      tick + io_pool_idle_timeout.load(std::memory_order_relaxed),
+      std::memory_order_relaxed))
   {
-    // blocking socket, we know result immediately
-    return true;
+    return;
   }
 
-  // final state (connected, rejected, etc)
-  return complete_connection(io, flags, fflags);
-}
-
+  std::lock_guard lock(io_pool_mutex);
+  for (auto size_class = 0U;  size_class != io_t::size_class_count;  ++size_class)
+  {
+    auto &pool = io_pool[size_class];
+    if (pool.blocks.empty())
+    {
+      continue;
+    }
 
-} // namespace
+    // take all free io_t and count them per block (blocks are looked up by
+    // address, free io_t of released blocks are dropped, others returned)
+    auto block_size = io_t::block_size(size_class);
+    std::vector<std::pair<const std::byte *, size_t>> by_address;
+    std::vector<size_t> free_count;
+    std::vector<bool> released;
+    try
+    {
+      by_address.reserve(pool.blocks.size());
+      free_count.resize(pool.blocks.size());
+      released.resize(pool.blocks.size());
+    }
+    catch (const std::bad_alloc &)
+    {
+      return;
+    }
+    for (auto i = 0U;  i != pool.blocks.size();  ++i)
+    {
+      by_address.emplace_back(pool.blocks[i].data.get(), i);
+    }
+    std::sort(by_address.begin(), by_address.end());
 
+    auto block_of = [&](const io_base_t *io)
+    {
+      auto it = std::upper_bound(by_address.begin(), by_address.end(),
+        std::make_pair(reinterpret_cast<const std::byte *>(io), size_t{0}),
+        [](const auto &a, const auto &b) { return a.first < b.first; }
+      );
+      return std::prev(it)->second;
+    };
+
+    io_t::pending_list_t free{};
+    while (auto io = pool.free_list.try_pop())
+    {
+      if (io->chain_next)
+      {
+        // chain of internally released head is free as well
+        release_io(std::exchange(io->chain_next, nullptr));
+      }
+      ++free_count[block_of(io)];
+      free.push(io);
+    }
 
-void handler_t::start_receive_from (io_t *io,
-  void *remote_endpoint,
-  size_t remote_endpoint_capacity,
-  size_t *transferred,
-  message_flags_t *flags) noexcept
-{
-  io->owner = this;
-  io->on_finish = finish_receive_from;
-  io->transferred = transferred;
-  io->flags = flags;
+    // release newest (largest) idle blocks first
+    for (auto i = pool.blocks.size();  i-- > 0;  )
+    {
+      auto &block = pool.blocks[i];
+      auto memory = block.size * block_size;
+      if (free_count[i] != block.size)
+      {
+        block.idle = false;
+      }
+      else if (block.idle && io_pool_memory - memory >= high_water)
+      {
+        released[i] = true;
+        ++io_pool_trims;
+        io_pool_size -= block.size;
+        io_pool_memory -= memory;
+        io_pool_free.fetch_sub(block.size, std::memory_order_relaxed);
+        io_pool_capped.store(false, std::memory_order_relaxed);
+      }
+      else
+      {
+        block.idle = true;
+      }
+    }
 
-  *io->flags |= MSG_DONTWAIT;
-  io->pending.receive_from.remote_endpoint = remote_endpoint;
-  io->pending.receive_from.remote_endpoint_capacity = remote_endpoint_capacity;
+    while (auto io = free.try_pop())
+    {
+      if (!released[block_of(io)])
+      {
+        pool.free_list.push(io);
+      }
+    }
 
-  start(io, pending_read);
+    for (auto i = pool.blocks.size();  i-- > 0;  )
+    {
+      if (released[i])
+      {
+        pool.blocks.erase(pool.blocks.begin() + i);
+      }
+    }
+  }
 }
 
 
-void handler_t::start_receive (io_t *io,
-  size_t *transferred,
-  message_flags_t *flags) noexcept
-{
-  io->owner = this;
-  io->on_finish = finish_receive;
-  io->transferred = transferred;
-  io->flags = flags;
-
-  *io->flags |= MSG_DONTWAIT;
+namespace {
 
-  start(io, pending_read);
-}
+// guards service_t::io_caches and io_cache_t::service of all threads' caches
+std::mutex io_cache_mutex{};
 
 
-void handler_t::start_send_to (io_t *io,
-  const void *remote_endpoint,
-  size_t remote_endpoint_size,
-  size_t *transferred,
-  message_flags_t flags) noexcept
+// owns calling thread's caches, returning cached io_t to their services on
+// thread exit
+struct thread_io_cache_list_t
 {
-  io->owner = this;
-  io->on_finish = finish_send_to;
-  io->transferred = transferred;
-
-  io->pending.send_to.flags = flags | MSG_DONTWAIT;
+  io_cache_t *head{};
 
-  io->pending.send_to.remote_endpoint_size = remote_endpoint_size;
-  memcpy(
-    &io->pending.send_to.remote_endpoint,
-    remote_endpoint,
-    remote_endpoint_size
-  );
+  ~thread_io_cache_list_t () noexcept
+  {
+    thread_io_cache = nullptr;
 
-  start(io, pending_write);
-}
+    std::lock_guard lock(io_cache_mutex);
+    while (auto cache = head)
+    {
+      head = cache->thread_next;
+      if (auto service = cache->service.load(std::memory_order_relaxed))
+      {
+        cache->flush();
+        (cache->prev ? cache->prev->next : service->io_caches.head) = cache->next;
+        if (cache->next)
+        {
+          cache->next->prev = cache->prev;
+        }
+      }
+      delete cache;
+    }
+  }
+};
 
+thread_local thread_io_cache_list_t thread_io_caches{};
 
-void handler_t::start_send (io_t *io,
-  size_t *transferred,
-  message_flags_t flags) noexcept
-{
-  io->owner = this;
-  io->on_finish = finish_send;
-  io->transferred = transferred;
+} // namespace
 
-  io->pending.send.flags = flags | MSG_DONTWAIT;
 
-  start(io, pending_write);
-}
+io_cache_t *bind_io_cache (service_t &service) noexcept
+{
+  auto &caches = thread_io_caches;
+  std::lock_guard lock(io_cache_mutex);
 
+  io_cache_t *unused = nullptr;
+  for (auto it = caches.head;  it;  it = it->thread_next)
+  {
+    auto it_service = it->service.load(std::memory_order_relaxed);
+    if (it_service == &service)
+    {
+      return thread_io_cache = it;
+    }
+    else if (!it_service)
+    {
+      unused = it;
+    }
+  }
 
-void handler_t::start_accept (io_t *io,
-  int /*family*/,
-  socket_t::handle_t *socket_handle) noexcept
-{
-  io->owner = this;
-  io->on_finish = finish_accept;
+  if (unused)
+  {
+    // cached io_t of destroyed service were released with it's pool
+    for (auto &bin: unused->bins)
+    {
+      bin = {};
+    }
+    unused->hits.store(0, std::memory_order_relaxed);
+    unused->misses.store(0, std::memory_order_relaxed);
+  }
+  else if ((unused = new(std::nothrow) io_cache_t))
+  {
+    unused->thread_next = caches.head;
+    caches.head = unused;
+  }
+  else
+  {
+    return nullptr;
+  }
 
-  io->pending.accept.socket_handle = socket_handle;
+  unused->service.store(&service, std::memory_order_relaxed);
+  unused->prev = nullptr;
+  if ((unused->next = service.io_caches.head))
+  {
+    unused->next->prev = unused;
+  }
+  service.io_caches.head = unused;
 
-  start(io, pending_read);
+  return thread_io_cache = unused;
 }
 
 
-void handler_t::start_connect (io_t *io,
-  const void *remote_endpoint,
-  size_t remote_endpoint_size) noexcept
+const io_cache_t *find_io_cache (const service_t &service) noexcept
 {
-  io->owner = this;
-  io->on_finish = finish_connect;
-
-  socket.connect(remote_endpoint, remote_endpoint_size, io->status);
+  if (auto cache = thread_io_cache;
+    cache && cache->service.load(std::memory_order_relaxed) == &service)
+  {
+    return cache;
+  }
 
-  start(io, pending_write);
+  std::lock_guard lock(io_cache_mutex);
+  for (auto it = thread_io_caches.head;  it;  it = it->thread_next)
+  {
+    if (it->service.load(std::memory_order_relaxed) == &service)
+    {
+      return it;
+    }
+  }
+  return nullptr;
 }
 
 
-#endif //}}}1
+service_t::io_cache_list_t::~io_cache_list_t () noexcept
+{
+  // no thread uses service anymore, owning threads reuse or delete caches
+  std::lock_guard lock(io_cache_mutex);
+  while (auto cache = head)
+  {
+    head = cache->next;
+    cache->prev = cache->next = nullptr;
+    cache->service.store(nullptr, std::memory_order_relaxed);
+  }
+}
 
 
-io_t *service_t::make_io (io_t::completed_list_t *completed)
+io_base_t *io_cache_t::refill (size_t size_class)
 {
-  std::lock_guard lock(io_pool_mutex);
+  misses.store(misses.load(std::memory_order_relaxed) + 1,
+    std::memory_order_relaxed
+  );
 
-  auto io = free_list.try_pop();
+  auto &service = *this->service.load(std::memory_order_relaxed);
+  std::lock_guard lock(service.io_pool_mutex);
+  auto io = service.alloc_io(size_class);
   if (!io)
   {
-    auto batch_size = 16 * (1ULL << io_pool.size());
-    auto it = io_pool.emplace_back(new std::byte[batch_size * sizeof(io_t)]).get();
-    io_pool_size += batch_size;
+    return io;
+  }
 
-    while (batch_size--)
+  // take more without growing pool
+  auto &bin = bins[size_class];
+  auto &free_list = service.io_pool[size_class].free_list;
+  while (bin.size < batch_size[size_class])
+  {
+    if (auto it = free_list.try_pop())
+    {
+      service.io_pool_free.fetch_sub(1, std::memory_order_relaxed);
+      bin.list.push(it);
+      ++bin.size;
+    }
+    else
     {
-      free_list.push(new(it) io_t(*this, &completed_list));
-      it += sizeof(io_t);
+      break;
     }
+  }
+
+  return io;
+}
+
 
-    io = free_list.try_pop();
+void io_cache_t::flush (size_t size_class, size_t count) noexcept
+{
+  auto &service = *this->service.load(std::memory_order_relaxed);
+  auto &bin = bins[size_class];
+  auto &free_list = service.io_pool[size_class].free_list;
+  auto released = false;
+  while (count--)
+  {
+    if (auto io = bin.list.try_pop())
+    {
+      --bin.size;
+      service.io_pool_free.fetch_add(1, std::memory_order_relaxed);
+      free_list.push(io);
+      released = true;
+    }
+    else
+    {
+      break;
+    }
   }
 
-  auto result = static_cast<io_t *>(io);
-  result->begin = result->data;
-  result->end = result->data + sizeof(result->data);
-  result->completed_list = completed;
-  result->owner = nullptr;
-  return result;
+  if (released)
+  {
+    service.io_released();
+  }
 }
 
 
@@ -3,10 +3,26 @@
 #include <sal/config.hpp>
 #include <sal/intrusive_mpsc_queue.hpp>
 #include <sal/intrusive_queue.hpp>
+#include <sal/intrusive_stack.hpp>
 #include <sal/net/__bits/socket.hpp>
+#include <sal/net/fwd.hpp>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <deque>
+#include <limits>
 #include <memory>
 #include <mutex>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if __sal_os_linux
+  #include <netinet/in.h>
+#endif
 
 
 __sal_begin
@@ -19,13 +35,25 @@ using net::__bits::socket_t;
 using net::__bits::message_flags_t;
 
 struct io_t;
+struct io_cache_t;
 struct service_t;
 struct completion_queue_t;
 struct handler_t;
 
+#if __sal_os_linux
+struct zerocopy_orphan_t;
+#endif
+
+#if __sal_io_uring
+struct io_uring_t;
+#endif
+
 
 struct io_base_t //{{{1
 {
+  // max number of io_t in scatter/gather chain (including head)
+  static constexpr size_t max_chain_size = 8;
+
 #if __sal_os_windows
   OVERLAPPED overlapped{};
   using endpoint_size_t = INT;
@@ -41,6 +69,19 @@ struct io_base_t //{{{1
     {
       void *remote_endpoint;
       endpoint_size_t remote_endpoint_capacity;
+#if __sal_os_linux
+      size_t *segment_size;
+
+      // start_receive_from_with_info() ancillary data destinations
+      uint32_t *interface_index;
+      std::chrono::system_clock::time_point *timestamp;
+      net::ip::address_t *local_address;
+
+      // UDP_GRO or SCM_TIMESTAMPNS + IP_PKTINFO/IPV6_PKTINFO
+      alignas(::cmsghdr) std::byte control[
+        CMSG_SPACE(sizeof(::timespec)) + CMSG_SPACE(sizeof(::in6_pktinfo))
+      ];
+#endif
     } receive_from;
 
     struct
@@ -50,8 +91,14 @@ struct io_base_t //{{{1
     struct
     {
       message_flags_t flags;
+#if __sal_os_linux
+      uint32_t zerocopy_id;
+#endif
       sockaddr_storage remote_endpoint;
       size_t remote_endpoint_size;
+#if __sal_os_linux
+      alignas(::cmsghdr) std::byte control[CMSG_SPACE(sizeof(uint16_t))];
+#endif
     } send_to;
 
     struct
@@ -70,15 +117,35 @@ struct io_base_t //{{{1
     {
       size_t unused_transferred;
       message_flags_t unused_flags;
+#if __sal_io_uring
+      sockaddr_storage remote_endpoint;
+      size_t remote_endpoint_size;
+#endif
     } connect;
+
+    struct
+    {
+      uint64_t expires;
+    } timer;
+
+#if __sal_io_uring
+    // chained io_t is not started itself, first chained io_t holds iovec
+    // array of head's operation while it is pending
+    ::iovec chain_iov[max_chain_size];
+#endif
   } pending{};
 
+#if __sal_io_uring
+  ::msghdr message{};
+  ::iovec message_iov{};
+#endif
+
   handler_t *owner{};
   uintptr_t context_type{};
   void *context{};
 
   uint64_t op{};
-  std::byte result[160];
+  std::byte result[176];
   size_t *transferred{};
   message_flags_t *flags{};
   std::error_code status{};
@@ -86,31 +153,80 @@ struct io_base_t //{{{1
   std::byte *begin{};
   const std::byte *end{};
 
+  // next io_t in scatter/gather chain started with this one
+  io_t *chain_next{};
+
+  // data area (follows io_t in same memory block, see io_t::data()) and it's
+  // size class
+  uint32_t data_size : 24;
+  uint32_t size_class : 8;
+
+  // deadline state of pending operation (see service_t::set_deadline())
+  std::atomic<uint32_t> deadline{};
+
   union
   {
     intrusive_mpsc_queue_hook_t<io_base_t> completed_io{};
     intrusive_queue_hook_t<io_base_t> pending_io;
+    intrusive_stack_hook_t<io_base_t> cached_io;
+    intrusive_stack_hook_t<io_base_t> timer_io;
+#if __sal_io_uring
+    // index in handler_t::uring_ops while submitted to io_uring
+    size_t uring_slot;
+#endif
   };
   using completed_list_t = intrusive_mpsc_queue_t<&io_base_t::completed_io>;
   using pending_list_t = intrusive_queue_t<&io_base_t::pending_io>;
+  using cached_list_t = intrusive_stack_t<&io_base_t::cached_io>;
+  using timer_list_t = intrusive_stack_t<&io_base_t::timer_io>;
 
   service_t &service;
   completed_list_t *completed_list;
 
 
   io_base_t (service_t &service, completed_list_t *completed_list) noexcept
-    : service(service)
+    : data_size(0)
+    , size_class(0)
+    , service(service)
     , completed_list(completed_list)
   { }
 
 
-  void completed () noexcept
+  void completed () noexcept;
+  void completed (completed_list_t &list) noexcept;
+
+
+  // service's free list of io_t with same size class
+  completed_list_t &free_list () const noexcept;
+
+
+  // setup receive_from/send_to parameters for batched start
+  void setup_receive_from (void *remote_endpoint,
+    size_t remote_endpoint_capacity,
+    size_t *transferred,
+    message_flags_t *flags) noexcept
   {
-    completed_list->push(this);
+    pending.receive_from.remote_endpoint = remote_endpoint;
+    pending.receive_from.remote_endpoint_capacity =
+      static_cast<endpoint_size_t>(remote_endpoint_capacity);
+    this->transferred = transferred;
+    this->flags = flags;
   }
 
 
-  void completed (completed_list_t &list) noexcept;
+  void setup_send_to (const void *remote_endpoint,
+    size_t remote_endpoint_size,
+    size_t *transferred,
+    message_flags_t flags) noexcept
+  {
+    pending.send_to.flags = flags;
+    pending.send_to.remote_endpoint_size = remote_endpoint_size;
+    std::memcpy(&pending.send_to.remote_endpoint,
+      remote_endpoint,
+      remote_endpoint_size
+    );
+    this->transferred = transferred;
+  }
 
 
   io_base_t () = delete;
@@ -125,20 +241,178 @@ struct io_t //{{{1
   : public io_base_t
 {
   static constexpr size_t mtu_size = 1500;
-  static constexpr size_t data_size = 2048 - sizeof(io_base_t);
-  static_assert(data_size >= mtu_size);
 
-  std::byte data[data_size];
+  // data area sizes of supported size classes: small, MTU (default, whole
+  // block fits into 2kB), jumbo frame and max UDP datagram
+  static constexpr size_t size_class_count = 4;
+  static constexpr size_t size_classes[size_class_count] =
+  {
+    512,
+    2048 - sizeof(io_base_t),
+    9216,
+    65536,
+  };
+  static constexpr size_t default_size_class = 1;
+  static_assert(size_classes[default_size_class] >= mtu_size);
+
 
-  io_t (service_t &service, completed_list_t *completed_list) noexcept
+  io_t (service_t &service,
+    completed_list_t *completed_list,
+    size_t size_class) noexcept
     : io_base_t(service, completed_list)
-  { }
+  {
+    data_size = static_cast<uint32_t>(size_classes[size_class]);
+    this->size_class = static_cast<uint32_t>(size_class);
+  }
+
+
+  std::byte *data () noexcept
+  {
+    return reinterpret_cast<std::byte *>(this) + sizeof(io_t);
+  }
+
+
+  const std::byte *data () const noexcept
+  {
+    return reinterpret_cast<const std::byte *>(this) + sizeof(io_t);
+  }
+
+
+  // return smallest size class with data area at least size_hint bytes or
+  // size_class_count if there is no such class
+  static constexpr size_t size_class_for (size_t size_hint) noexcept
+  {
+    size_t size_class = 0;
+    while (size_class < size_class_count
+      && size_classes[size_class] < size_hint)
+    {
+      ++size_class;
+    }
+    return size_class;
+  }
+
+
+  // io_t header and data area are allocated as single block
+  static constexpr size_t block_size (size_t size_class) noexcept
+  {
+    return sizeof(io_t) + size_classes[size_class];
+  }
 };
 
-static_assert(sizeof(io_t) == 2048);
+static_assert(sizeof(io_t) == sizeof(io_base_t));
+static_assert(io_t::block_size(io_t::default_size_class) == 2048);
 static_assert(std::is_trivially_destructible_v<io_t>);
 
 
+struct timer_wheel_t //{{{1
+{
+  // Hierarchical timing wheel with 1ms tick: level L slot holds timers that
+  // expire within 64^(L+1) ticks and on level L slot boundary, it's timers
+  // are cascaded into lower level. Timers further than max_delay are placed
+  // into top level and rescheduled on cascade.
+
+  static constexpr size_t level_bits = 6;
+  static constexpr size_t slot_count = 1 << level_bits;
+  static constexpr size_t level_count = 4;
+  static constexpr uint64_t max_delay = (1ULL << (level_bits * level_count)) - 1;
+
+  io_t::timer_list_t slots[level_count][slot_count]{};
+  size_t level_size[level_count]{};
+  size_t size{};
+
+  // last processed tick
+  uint64_t now{};
+
+
+  // add io that expires at tick io->pending.timer.expires (> now)
+  void insert (io_base_t *io) noexcept;
+
+  // process ticks up to (inclusive) tick, moving expired timers to expired
+  void advance (uint64_t tick, io_t::pending_list_t &expired) noexcept;
+
+  // return tick when wheel should be advanced next (earliest expiration or
+  // cascade) or max if there are no timers
+  uint64_t next_tick () const noexcept;
+
+
+private:
+
+  void process (io_t::pending_list_t &expired) noexcept;
+};
+
+
+struct wakeup_t //{{{1
+{
+#if __sal_os_linux
+  // eventfd registered with reactor (edge-triggered, never read)
+  int event = -1;
+#elif __sal_os_macos
+  // reactor with EVFILT_USER event registered
+  int reactor = -1;
+#endif
+
+  // threads blocked (or about to block) in wait
+  std::atomic<uint32_t> waiters{};
+
+  // set by signaling thread until waiter receives wakeup event
+  std::atomic<bool> signaled{};
+};
+
+
+struct io_pool_policy_t //{{{1
+{
+  // none, madvise(MADV_HUGEPAGE) or MAP_HUGETLB (falling back to transparent)
+  enum class huge_pages_t { none, transparent, reserved } huge_pages{};
+
+  // mlock() blocks
+  bool lock{};
+
+  // bind blocks to NUMA node of allocating thread's CPU
+  bool numa_local{};
+};
+
+// huge page blocks are allocated in multiples of this
+constexpr size_t huge_page_size = 2 * 1024 * 1024;
+
+
+// pool block memory, allocated with new[] (mapped_size == 0) or mmap()
+struct io_block_deleter_t
+{
+  size_t mapped_size{};
+  void operator() (std::byte *block) const noexcept;
+};
+using io_block_ptr = std::unique_ptr<std::byte[], io_block_deleter_t>;
+
+
+// allocate block of size bytes using policy
+io_block_ptr alloc_io_block (size_t size, const io_pool_policy_t &policy);
+
+
+struct io_stats_t //{{{1
+{
+  // blocking waits, those that returned with OS events and number of OS
+  // events (reactor events or completions) handled
+  size_t waits{}, wakeups{}, events{};
+
+  // attempts to finish pending operation that had to wait for readiness
+  size_t would_block{};
+};
+
+
+struct service_stats_t //{{{1
+  : io_stats_t
+{
+  // io_t pool blocks allocated and released
+  size_t io_pool_grows{}, io_pool_trims{};
+};
+
+
+struct handler_stats_t //{{{1
+{
+  size_t started{}, completed{}, would_block{};
+};
+
+
 struct service_t //{{{1
 {
 #if __sal_os_windows
@@ -147,26 +421,168 @@ struct service_t //{{{1
   int queue;
 #endif
 
+#if __sal_io_uring
+  // if set, completions are handled by io_uring instead of epoll
+  std::unique_ptr<io_uring_t> uring{};
+#endif
+
+  // io_t blocks and free list per size class
+  struct io_pool_t
+  {
+    struct block_t
+    {
+      io_block_ptr data{};
+      size_t size{};
+
+      // all io_t of block were free on last trim_io_pool() check
+      bool idle{};
+    };
+    std::deque<block_t> blocks{};
+    io_t::completed_list_t free_list{};
+  };
+
   std::mutex io_pool_mutex{};
-  std::deque<std::unique_ptr<std::byte[]>> io_pool{};
-  size_t io_pool_size{};
+  io_pool_t io_pool[io_t::size_class_count]{};
+  size_t io_pool_size{}, io_pool_peak_size{}, io_pool_memory{};
+
+  // io_t in free lists (without threads' caches), updated after push and
+  // before pop so it may lag behind momentarily
+  std::atomic<ptrdiff_t> io_pool_free{};
+
+  // threads' caches of this service's io_t (see bind_io_cache()), declared
+  // after io_pool to detach them before pool is released
+  struct io_cache_list_t
+  {
+    io_cache_t *head{};
+    ~io_cache_list_t () noexcept;
+  } io_caches{};
+
+  // pool does not grow beyond io_pool_limit bytes; while it is above
+  // io_pool_high_water, blocks staying completely free for
+  // io_pool_idle_timeout are released
+  static constexpr size_t no_io_pool_limit = (std::numeric_limits<size_t>::max)();
+  std::atomic<size_t> io_pool_limit = no_io_pool_limit;
+
+  // set when pool can't grow for some size class anymore (cleared when limit
+  // is changed or pool is trimmed). While set, released io_t bypass threads'
+  // caches and caches return their content on next use, so free io_t are not
+  // hidden from other threads
+  std::atomic<bool> io_pool_capped{};
+
+  // threads waiting in try_make_io_for() are woken up when io_t is released
+  // to free_list (io_pool_releases is changed with io_pool_wait_mutex locked)
+  std::mutex io_pool_wait_mutex{};
+  std::condition_variable io_pool_released{};
+  std::atomic<uint32_t> io_pool_waiters{};
+  std::atomic<uint64_t> io_pool_releases{};
+  std::atomic<size_t> io_pool_high_water = no_io_pool_limit;
+  std::atomic<std::chrono::milliseconds::rep> io_pool_idle_timeout = 60'000;
+  std::atomic<uint64_t> io_pool_next_trim{};
+
+  // used for new blocks (io_pool_mutex locked)
+  io_pool_policy_t io_pool_policy{};
+
+  // blocks allocated and released (io_pool_mutex locked)
+  size_t io_pool_grows{}, io_pool_trims{};
 
   std::mutex completed_list_mutex{};
-  io_t::completed_list_t completed_list{}, free_list{};
+  io_t::completed_list_t completed_list{};
+
+  // wakes thread waiting on service's reactor for io posted to
+  // completed_list
+  wakeup_t wakeup{};
+
+  // live queues are linked into queues list, counters of destroyed ones are
+  // accumulated into retired_stats (queues_mutex locked)
+  std::mutex queues_mutex{};
+  completion_queue_t *queues{};
+  io_stats_t retired_stats{};
+
+  std::mutex timer_mutex{};
+  timer_wheel_t timers{};
+  const std::chrono::steady_clock::time_point timer_epoch =
+    std::chrono::steady_clock::now();
+
+#if __sal_os_linux
+  // sockets of destroyed handlers kept open until kernel releases data of
+  // their zerocopy sends (zerocopy_orphans_mutex locked)
+  std::mutex zerocopy_orphans_mutex{};
+  zerocopy_orphan_t *zerocopy_orphans{};
+#endif
 
 
   service_t ();
   ~service_t () noexcept;
 
 
-  io_t *make_io (io_t::completed_list_t *completed_list);
+  // return nullptr if pool has reached io_pool_limit
+  io_t *try_make_io (io_t::completed_list_t *completed_list,
+    size_t size_class
+  );
+
+
+  // retry try_make_io() until io_t is released to pool or timeout
+  io_t *try_make_io_for (io_t::completed_list_t *completed_list,
+    size_t size_class,
+    const std::chrono::milliseconds &timeout
+  );
+
+
+  // throw std::bad_alloc if pool has reached io_pool_limit
+  io_t *make_io (io_t::completed_list_t *completed_list, size_t size_class)
+  {
+    if (auto io = try_make_io(completed_list, size_class))
+    {
+      return io;
+    }
+    throw std::bad_alloc();
+  }
+
+
+  io_t *make_io (size_t size_class = io_t::default_size_class)
+  {
+    return make_io(&completed_list, size_class);
+  }
+
+
+  // pop from size_class free_list, growing pool if necessary (or returning
+  // nullptr if it would exceed io_pool_limit) (io_pool_mutex locked)
+  io_base_t *alloc_io (size_t size_class);
+
+
+  // release blocks that have stayed completely free since last check (if
+  // pool is above high water mark), checked at most once per idle timeout
+  void trim_io_pool () noexcept;
+
+
+  // sum of live and destroyed queues' counters and pool counters
+  service_stats_t stats () noexcept;
+
+
+  size_t io_pool_free_size () const noexcept
+  {
+    auto free = io_pool_free.load(std::memory_order_relaxed);
+    return free > 0 ? static_cast<size_t>(free) : 0;
+  }
+
+
+  // return io to calling thread's cache if it is for this service and pool
+  // is not capped, otherwise to free_list
+  void release_io (io_base_t *io) noexcept;
 
 
-  io_t *make_io ()
+  // io_t was pushed to free_list: wake up try_make_io_for() waiters
+  void io_released () noexcept
   {
-    return make_io(&completed_list);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (io_pool_waiters.load(std::memory_order_relaxed))
+    {
+      notify_io_waiters();
+    }
   }
 
+  void notify_io_waiters () noexcept;
+
 
   io_t *try_get () noexcept
   {
@@ -175,6 +591,108 @@ struct service_t //{{{1
   }
 
 
+  // pass up to count completed io to put(io_t *) under single lock
+  template <typename Put>
+  size_t try_get_many (size_t count, Put put) noexcept
+  {
+    if (completed_list.empty())
+    {
+      return 0;
+    }
+
+    std::lock_guard lock(completed_list_mutex);
+    size_t result = 0;
+    while (result != count)
+    {
+      if (auto io = static_cast<io_t *>(completed_list.try_pop()))
+      {
+        put(io);
+        ++result;
+      }
+      else
+      {
+        break;
+      }
+    }
+    return result;
+  }
+
+
+  // complete io on or after deadline
+  void start_timer (io_t *io,
+    const std::chrono::steady_clock::time_point &deadline
+  ) noexcept;
+
+
+  // return timeout clamped to next timer wheel tick
+  std::chrono::milliseconds timer_timeout (
+    const std::chrono::milliseconds &timeout
+  ) noexcept;
+
+
+  // complete expired timers into queue, returning true if there were any
+  bool expire_timers (io_t::completed_list_t &queue) noexcept;
+
+
+  // operations started with deadline, ordered by expiration tick (same as
+  // timers) and their ticks by io. On expiration, io is removed from here
+  // and it's deadline state set to deadline_expired while owner cancels it.
+  // Canceled operation's status is changed to timed_out when it completes
+  // (see clear_deadline()). Registry is sharded by io address so that
+  // completions on different threads do not contend on single lock.
+  static constexpr uint32_t deadline_pending = 1, deadline_expired = 2;
+  static constexpr uint64_t no_deadline = (std::numeric_limits<uint64_t>::max)();
+  static constexpr size_t deadline_shard_bits = 4;
+
+  struct alignas(64) deadline_shard_t
+  {
+    std::mutex mutex{};
+    std::set<std::pair<uint64_t, io_base_t *>> deadlines{};
+    std::unordered_map<const io_base_t *, uint64_t> ticks{};
+    std::atomic<uint64_t> next = no_deadline;
+  } deadline_shards[1 << deadline_shard_bits]{};
+
+  deadline_shard_t &deadline_shard (const io_base_t *io) noexcept
+  {
+    // Fibonacci hashing: io_t addresses are multiples of their size class
+    uint64_t hash = reinterpret_cast<uintptr_t>(io);
+    hash *= 0x9e3779b97f4a7c15ULL;
+    return deadline_shards[hash >> (64 - deadline_shard_bits)];
+  }
+
+  // return earliest tick of registered deadlines (or no_deadline)
+  uint64_t next_deadline () const noexcept
+  {
+    auto result = no_deadline;
+    for (auto &shard: deadline_shards)
+    {
+      result = (std::min)(result, shard.next.load(std::memory_order_relaxed));
+    }
+    return result;
+  }
+
+
+  // register deadline for io (io->owner is set) that is started next. If
+  // deadline has already passed or it can't be registered, set io status and
+  // return false
+  bool set_deadline (io_t *io,
+    const std::chrono::steady_clock::time_point &deadline
+  ) noexcept;
+
+
+  // remove io deadline on it's completion
+  void clear_deadline (io_base_t *io) noexcept;
+
+
+  // remove deadlines of owner's pending operations (owner is closing)
+  void clear_deadlines (const handler_t *owner) noexcept;
+
+
+  // cancel operations with expired deadlines, returning true if there were
+  // any
+  bool expire_deadlines () noexcept;
+
+
   service_t (const service_t &) = delete;
   service_t &operator= (const service_t &) = delete;
   service_t (service_t &&) = delete;
@@ -183,34 +701,234 @@ struct service_t //{{{1
 using service_ptr = std::shared_ptr<service_t>;
 
 
+struct io_cache_t //{{{1
+{
+  // number of io_t moved between cache and service pool at once per size
+  // class (fewer for larger classes to bound per-thread cached memory)
+  static constexpr size_t batch_size[io_t::size_class_count] = { 32, 32, 8, 2 };
+
+  // service whose io_t are cached, cleared (with io_cache_mutex locked) if
+  // service is destroyed before owning thread exits
+  std::atomic<service_t *> service{};
+
+  struct bin_t
+  {
+    io_t::cached_list_t list{};
+    size_t size{};
+  } bins[io_t::size_class_count]{};
+
+  // updated only by owner thread, relaxed atomics for concurrent readers
+  std::atomic<size_t> hits{}, misses{};
+
+  // links in service_t::io_caches (io_cache_mutex locked)
+  io_cache_t *prev{}, *next{};
+
+  // link in owning thread's list of caches
+  io_cache_t *thread_next{};
+
+
+  io_base_t *alloc (size_t size_class)
+  {
+    auto &bin = bins[size_class];
+    if (auto io = bin.list.try_pop())
+    {
+      --bin.size;
+      hits.store(hits.load(std::memory_order_relaxed) + 1,
+        std::memory_order_relaxed
+      );
+      return io;
+    }
+    return refill(size_class);
+  }
+
+
+  void release (io_base_t *io) noexcept
+  {
+    auto &bin = bins[io->size_class];
+    bin.list.push(io);
+    if (++bin.size > 2 * batch_size[io->size_class])
+    {
+      flush(io->size_class, batch_size[io->size_class]);
+    }
+  }
+
+
+  io_base_t *refill (size_t size_class);
+  void flush (size_t size_class, size_t count) noexcept;
+
+
+  // return all cached io_t to service pool
+  void flush () noexcept
+  {
+    for (auto size_class = 0U;  size_class != io_t::size_class_count;  ++size_class)
+    {
+      flush(size_class, bins[size_class].size);
+    }
+  }
+
+
+  io_cache_t () = default;
+  io_cache_t (const io_cache_t &) = delete;
+  io_cache_t &operator= (const io_cache_t &) = delete;
+  io_cache_t (io_cache_t &&) = delete;
+  io_cache_t &operator= (io_cache_t &&) = delete;
+};
+
+
+// calling thread's io_t cache of service it last used through
+// completion_queue_t (used by service_t::make_io() and io_t release)
+inline thread_local io_cache_t *thread_io_cache = nullptr;
+
+
+// make calling thread's cache of service current, creating it on first use.
+// Returns nullptr if it can't be allocated (thread uses service pool directly)
+io_cache_t *bind_io_cache (service_t &service) noexcept;
+
+
+inline io_cache_t *use_io_cache (service_t &service) noexcept
+{
+  if (auto cache = thread_io_cache;
+    cache && cache->service.load(std::memory_order_relaxed) == &service)
+  {
+    return cache;
+  }
+  return bind_io_cache(service);
+}
+
+
+// return calling thread's cache of service or nullptr if there is none
+const io_cache_t *find_io_cache (const service_t &service) noexcept;
+
+
+inline void service_t::release_io (io_base_t *io) noexcept
+{
+  auto cache = thread_io_cache;
+  if (cache
+    && (cache->service.load(std::memory_order_relaxed) != this
+      || io_pool_capped.load(std::memory_order_relaxed)))
+  {
+    cache = nullptr;
+  }
+  do
+  {
+    // chained io_t are released together with head
+    auto next = std::exchange(io->chain_next, nullptr);
+    if (cache)
+    {
+      cache->release(io);
+    }
+    else
+    {
+      io_pool_free.fetch_add(1, std::memory_order_relaxed);
+      io->free_list().push(io);
+    }
+    io = next;
+  } while (io);
+
+  if (!cache)
+  {
+    io_released();
+  }
+}
+
+
 struct completion_queue_t //{{{1
 {
   service_ptr service;
   io_t::completed_list_t completed_list{};
 
+#if __sal_os_linux || __sal_os_macos
+  // own epoll/kqueue for handlers bound to this queue (service's reactor is
+  // nested into it) or -1 if queue uses only service's reactor
+  int reactor = -1;
+#endif
 
-  completion_queue_t (service_ptr service) noexcept
-    : service(service)
-  { }
+  // if non-zero, wait() polls without blocking up to this long before
+  // falling back to blocking wait
+  std::chrono::nanoseconds busy_poll_budget{};
+
+  // SO_BUSY_POLL (usec) set on handlers bound to this queue (Linux only)
+  int socket_busy_poll{};
+
+  // updated only by waiting thread, relaxed atomics for concurrent readers
+  std::atomic<size_t> busy_poll_completions{}, busy_poll_blocks{};
+  std::atomic<size_t> waits{}, wakeups{}, events{};
+
+  // updated only by thread that created this queue (see thread_queue)
+  std::atomic<size_t> would_block{};
+
+  // links in service_t::queues
+  completion_queue_t *prev{}, *next{};
+
+  // wakes thread waiting on own reactor (unused without own reactor)
+  wakeup_t wakeup{};
+
+  // max OS events (reactor events or completions) handled per wait_io(),
+  // event_buffer is used only if they don't fit into stack buffer
+#if __sal_os_windows
+  static constexpr size_t default_max_events = 256;
+#else
+  static constexpr size_t default_max_events = 128;
+#endif
+  size_t max_events = default_max_events;
+  std::unique_ptr<std::byte[]> event_buffer{};
 
+  // max operations finished per handler readiness event before handler is
+  // re-armed behind other ready handlers (epoll) or completed ahead of other
+  // handlers' completions reaped at once (io_uring), 0 - unlimited
+  static constexpr size_t default_drain_budget = 64;
+  size_t drain_budget = default_drain_budget;
 
-  ~completion_queue_t () noexcept
+
+  completion_queue_t (service_ptr service) noexcept;
+
+
+  completion_queue_t (service_ptr service, bool own_reactor);
+  ~completion_queue_t () noexcept;
+
+
+  bool has_reactor () const noexcept
   {
-    while (auto io = completed_list.try_pop())
-    {
-      io->completed(service->completed_list);
-    }
+#if __sal_os_linux || __sal_os_macos
+    return reactor != -1;
+#else
+    return false;
+#endif
+  }
+
+
+  // set calling thread affinity to single cpu
+  static void pin_thread (size_t cpu, std::error_code &error) noexcept;
+
+
+  // io_t allocations and releases of thread using queue go through that
+  // thread's cache of service (bound on first use)
+
+  io_t *make_io (size_t size_class = io_t::default_size_class)
+  {
+    (void)use_io_cache(*service);
+    return service->make_io(&completed_list, size_class);
+  }
+
+
+  io_t *try_make_io (size_t size_class = io_t::default_size_class)
+  {
+    (void)use_io_cache(*service);
+    return service->try_make_io(&completed_list, size_class);
   }
 
 
-  io_t *make_io ()
+  io_t *try_make_io_for (const std::chrono::milliseconds &timeout,
+    size_t size_class = io_t::default_size_class)
   {
-    return service->make_io(&completed_list);
+    (void)use_io_cache(*service);
+    return service->try_make_io_for(&completed_list, size_class, timeout);
   }
 
 
   io_t *try_get () noexcept
   {
+    (void)use_io_cache(*service);
     if (auto io = static_cast<io_t *>(completed_list.try_pop()))
     {
       return io;
@@ -219,11 +937,82 @@ struct completion_queue_t //{{{1
   }
 
 
+  // pass up to count completed io to put(io_t *), returning number of those
+  template <typename Put>
+  size_t try_get_many (size_t count, Put put) noexcept
+  {
+    (void)use_io_cache(*service);
+    size_t result = 0;
+    while (result != count)
+    {
+      if (auto io = static_cast<io_t *>(completed_list.try_pop()))
+      {
+        put(io);
+        ++result;
+      }
+      else
+      {
+        return result + service->try_get_many(count - result, put);
+      }
+    }
+    return result;
+  }
+
+
+  io_stats_t stats () const noexcept
+  {
+    return
+    {
+      waits.load(std::memory_order_relaxed),
+      wakeups.load(std::memory_order_relaxed),
+      events.load(std::memory_order_relaxed),
+      would_block.load(std::memory_order_relaxed),
+    };
+  }
+
+
+  // increment counter owned by calling thread
+  static void count (std::atomic<size_t> &counter, size_t n = 1) noexcept
+  {
+    counter.store(counter.load(std::memory_order_relaxed) + n,
+      std::memory_order_relaxed
+    );
+  }
+
+
+  // set max_events, allocating event_buffer if necessary
+  void set_max_events (size_t count);
+
+
   bool wait (const std::chrono::milliseconds &timeout,
     std::error_code &error
   ) noexcept;
 
 
+  // platform specific part of wait() (without timers)
+  bool wait_io (const std::chrono::milliseconds &timeout,
+    std::error_code &error
+  ) noexcept;
+
+
+  // non-blocking check for completions (with io_uring, only peeks
+  // completion ring without system call)
+  bool poll_io (std::error_code &error) noexcept;
+
+
+  // complete io into this queue (or into service's completed_list if queue
+  // has no own reactor) from any thread, waking waiting thread if necessary
+  // (io status is left as set by caller)
+  void post (io_t *io) noexcept;
+
+
+  // true if there are completions available without waiting
+  bool has_posted () const noexcept
+  {
+    return !completed_list.empty() || !service->completed_list.empty();
+  }
+
+
   completion_queue_t () = delete;
   completion_queue_t (const completion_queue_t &) = delete;
   completion_queue_t &operator= (const completion_queue_t &) = delete;
@@ -232,6 +1021,11 @@ struct completion_queue_t //{{{1
 };
 
 
+// first completion_queue_t created in thread (counts would_block of
+// operations drained by that thread)
+inline thread_local completion_queue_t *thread_queue = nullptr;
+
+
 struct handler_t //{{{1
 {
   service_ptr service;
@@ -240,23 +1034,82 @@ struct handler_t //{{{1
   uintptr_t context_type{};
   void *context{};
 
+  // set once operation with deadline is started; while service cancels
+  // expired operation, it holds reference to owner (closing owner waits
+  // until references are released)
+  std::atomic<bool> has_deadlines{};
+  std::atomic<uint32_t> deadline_refs{};
+
+  // started and completed operations and would_block finish attempts;
+  // operations canceled with io_uring are counted as completed when their
+  // completions are reaped (unless handler is already gone)
+  std::atomic<size_t> started{}, completed{}, would_block{};
 
-  handler_t (service_ptr service, socket_t &socket, std::error_code &error) noexcept;
+
+  // if queue is not null, handler is bound to queue's own reactor and it's
+  // events are drained only by that queue
+  handler_t (service_ptr service,
+    completion_queue_t *queue,
+    socket_t &socket,
+    std::error_code &error
+  ) noexcept;
   ~handler_t () noexcept;
 
 
 #if __sal_os_linux || __sal_os_macos
 
+  // epoll/kqueue this handler is registered with
+  int reactor{};
+
   #if __sal_os_linux
     uint32_t await_events{};
   #endif
 
+  // pending operations in start order: any thread pushes new ones into
+  // incoming; only single thread at time (drainer, claimed by raising
+  // requests from 0) moves them into list and finishes them
   struct pending_t
   {
-    std::mutex mutex{};
+    io_t::completed_list_t incoming{};
     io_t::pending_list_t list{};
+
+    // drain requests while drainer is running (0 - no drainer)
+    std::atomic<uint32_t> requests{};
+
+    // readiness posted by reactor for drainer (ready bit | flags | events)
+    std::atomic<uint64_t> events{};
+
+    // list head failed and waits for readiness (drainer only)
+    bool blocked{};
   } pending_read{}, pending_write{};
 
+  #if __sal_os_linux
+    // MSG_ZEROCOPY sends waiting for kernel notification that data is
+    // released (zerocopy and zerocopy_list are protected by zerocopy_mutex)
+    std::mutex zerocopy_mutex{};
+    io_t::pending_list_t zerocopy_list{};
+    uint32_t zerocopy_next_id{};
+
+    // SO_ZEROCOPY state: 0 - not tried yet, 1 - enabled, -1 - not supported
+    int zerocopy{};
+
+    // set when SO_TIMESTAMPNS and IP(V6)_PKTINFO are enabled
+    std::atomic<bool> receive_info{};
+  #endif
+
+  #if __sal_io_uring
+    // operations submitted to io_uring and not reaped yet; on destruction,
+    // their owner is cleared so late completions won't touch this handler
+    // (io_uring_t::cq_mutex is locked before uring_mutex)
+    std::mutex uring_mutex{};
+    std::vector<io_base_t *> uring_ops{};
+
+    // completions reaped in io_uring_t::reaps-th reap, limited by reaping
+    // queue's drain_budget (used under io_uring_t::cq_mutex)
+    uint64_t reap{};
+    size_t reaped{};
+  #endif
+
 #endif
 
 
@@ -300,6 +1153,146 @@ struct handler_t //{{{1
   ) noexcept;
 
 
+#if __sal_os_linux
+
+  // recvmsg() with receive timestamp and destination address/interface
+  void start_receive_from_with_info (io_t *io,
+    void *remote_endpoint,
+    size_t remote_endpoint_capacity,
+    size_t *transferred,
+    message_flags_t *flags,
+    uint32_t *interface_index,
+    std::chrono::system_clock::time_point *timestamp,
+    net::ip::address_t *local_address
+  ) noexcept;
+
+
+  // UDP GRO/GSO
+  void start_receive_from_segmented (io_t *io,
+    void *remote_endpoint,
+    size_t remote_endpoint_capacity,
+    size_t *transferred,
+    message_flags_t *flags,
+    size_t *segment_size
+  ) noexcept;
+
+
+  void start_send_to_segmented (io_t *io,
+    const void *remote_endpoint,
+    size_t remote_endpoint_size,
+    size_t segment_size,
+    size_t *transferred,
+    message_flags_t flags
+  ) noexcept;
+
+
+  // MSG_ZEROCOPY send/send_to (remote_endpoint is nullptr for send), io is
+  // completed only after kernel notifies it doesn't use io data anymore
+  void start_send_zerocopy (io_t *io,
+    const void *remote_endpoint,
+    size_t remote_endpoint_size,
+    size_t *transferred,
+    message_flags_t flags
+  ) noexcept;
+
+#endif
+
+
+  // receive pool: number of receive_from operations kept outstanding, each
+  // completed one is replaced with new io_t (set up same way as first one)
+  // before it is returned to application
+  struct receive_pool_t
+  {
+    // completions between checks whether depth can be shrunk
+    static constexpr uint32_t window_size = 256;
+
+    uint32_t min_depth{}, max_depth{};
+    std::atomic<uint32_t> depth{};
+
+    // started and not yet completed pooled receives
+    std::atomic<uint32_t> posted{};
+
+    // completions in current window and biggest burst seen during it
+    std::atomic<uint32_t> window{}, peak_burst{};
+
+    // new io_t setup: result type, context, completion list, size class,
+    // receive parameters
+    // and offsets of receive_from result fields in io_t::result
+    uint64_t op{};
+    uintptr_t context_type{};
+    void *context{};
+    io_t::completed_list_t *completed_list{};
+    size_t size_class{};
+    message_flags_t flags{};
+    size_t remote_endpoint_capacity{};
+    size_t remote_endpoint_offset{}, transferred_offset{}, flags_offset{};
+  } receive_pool{};
+
+  // start io and new io_t like it until there are depth receives outstanding
+  void start_receive_from_pool (io_t *io,
+    void *remote_endpoint,
+    size_t remote_endpoint_capacity,
+    size_t *transferred,
+    message_flags_t *flags,
+    size_t depth,
+    size_t max_depth
+  ) noexcept;
+
+  // invoked by pooled receive's on_finish before io is completed: adapt
+  // depth and start replacement(s)
+  void replenish_receive_pool (const io_t *io) noexcept;
+
+  // platform specific start_receive_from() with pooled on_finish
+  void start_pooled_receive_from (io_t *io,
+    void *remote_endpoint,
+    size_t remote_endpoint_capacity,
+    size_t *transferred,
+    message_flags_t *flags
+  ) noexcept;
+
+
+  // batched operations, each io[i] has to be prepared using
+  // io_t::setup_receive_from() or io_t::setup_send_to()
+  static constexpr size_t max_batch_size = 64;
+  void start_receive_from_batch (io_t **io, size_t count) noexcept;
+  void start_send_to_batch (io_t **io, size_t count) noexcept;
+
+
+  // complete pending io (if it is still pending) or all pending operations
+  // with operation_canceled, keeping socket open
+  void cancel (const io_t *io) noexcept;
+  void cancel_all () noexcept;
+
+
+  // register deadline for io that is started next; if it has already passed
+  // (or can't be registered), complete io and return false
+  bool start_deadline (io_t *io,
+    const std::chrono::steady_clock::time_point &deadline
+  ) noexcept;
+
+
+  // cancel io with expired deadline (if it is still pending), returning
+  // false if io was not found
+  bool cancel_expired (const io_t *io) noexcept;
+
+
+  void count_started (size_t count = 1) noexcept
+  {
+    started.fetch_add(count, std::memory_order_relaxed);
+  }
+
+
+  handler_stats_t stats () const noexcept
+  {
+    return
+    {
+      started.load(std::memory_order_relaxed),
+      completed.load(std::memory_order_relaxed),
+      would_block.load(std::memory_order_relaxed),
+    };
+  }
+
+
   handler_t () = delete;
   handler_t (const handler_t &) = delete;
   handler_t &operator= (const handler_t &) = delete;
@@ -310,11 +1303,12 @@ using handler_ptr = std::unique_ptr<handler_t>;
 
 
 inline handler_ptr make_handler (service_ptr service,
+  completion_queue_t *queue,
   socket_t &socket,
   std::error_code &error) noexcept
 {
   auto handler = handler_ptr(
-    new(std::nothrow) handler_t(service, socket, error)
+    new(std::nothrow) handler_t(service, queue, socket, error)
   );
   if (!handler)
   {
@@ -328,9 +1322,52 @@ inline handler_ptr make_handler (service_ptr service,
 }
 
 
+inline handler_ptr make_handler (service_ptr service,
+  socket_t &socket,
+  std::error_code &error) noexcept
+{
+  return make_handler(service, nullptr, socket, error);
+}
+
+
+inline handler_ptr make_handler (completion_queue_t &queue,
+  socket_t &socket,
+  std::error_code &error) noexcept
+{
+  return make_handler(queue.service, &queue, socket, error);
+}
+
+
+inline io_base_t::completed_list_t &io_base_t::free_list () const noexcept
+{
+  return service.io_pool[size_class].free_list;
+}
+
+
+inline void io_base_t::completed () noexcept
+{
+  if (owner)
+  {
+    owner->completed.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (deadline.load(std::memory_order_relaxed))
+  {
+    service.clear_deadline(this);
+  }
+  if (completed_list == &free_list())
+  {
+    service.io_pool_free.fetch_add(1, std::memory_order_relaxed);
+    completed_list->push(this);
+    service.io_released();
+    return;
+  }
+  completed_list->push(this);
+}
+
+
 inline void io_base_t::completed (completed_list_t &list) noexcept
 {
-  if (completed_list != &service.free_list)
+  if (completed_list != &free_list())
   {
     completed_list = &list;
   }
@@ -11,6 +11,8 @@
 #include <sal/net/async/__bits/async.hpp>
 #include <sal/net/async/io.hpp>
 #include <sal/net/async/service.hpp>
+#include <sal/span.hpp>
+#include <algorithm>
 #include <chrono>
 
 
@@ -36,6 +38,26 @@ public:
   { }
 
 
+  /**
+   * Instantiate new completion queue for \a service. If \a own_reactor is
+   * true, queue creates own OS reactor (epoll/kqueue). Sockets associated
+   * with this queue (see basic_socket_t::associate(completion_queue_t &)) are
+   * registered with it and their readiness events are drained only by
+   * thread waiting on this queue, i.e. their pending operations lists are
+   * not shared between cores. Sockets associated with service are still
+   * handled by this queue as well.
+   *
+   * Queue must outlive sockets associated with it. On Windows and with
+   * io_uring, \a own_reactor is ignored (completions are already delivered
+   * to waiting thread without shared readiness state).
+   *
+   * \throws std::system_error if reactor can't be created
+   */
+  completion_queue_t (const service_t &service, bool own_reactor)
+    : impl_(service.impl_, own_reactor)
+  { }
+
+
   completion_queue_t (const completion_queue_t &) = delete;
   completion_queue_t (completion_queue_t &&) = delete;
   completion_queue_t &operator= (const completion_queue_t &) = delete;
@@ -63,6 +85,293 @@ public:
   }
 
 
+  /**
+   * Allocate new I/O operation with associated \a context and data area of
+   * at least \a size_hint bytes. I/O operations are pooled in size classes
+   * (see io_t) and smallest class fitting \a size_hint is used.
+   *
+   * \throw std::logic_error if \a size_hint is bigger than largest size
+   * class (64kB)
+   */
+  template <typename Context>
+  io_ptr make_io (size_t size_hint, Context *context)
+  {
+    auto io = reinterpret_cast<io_t *>(
+      impl_.make_io(__bits::io_t::size_class_for(size_hint))
+    );
+    io->context<Context>(context);
+    return io_ptr{io};
+  }
+
+
+  /**
+   * Allocate new I/O operation with data area of at least \a size_hint bytes.
+   * \see make_io(size_t, Context *)
+   */
+  io_ptr make_io (size_t size_hint)
+  {
+    return make_io<std::nullptr_t>(size_hint, nullptr);
+  }
+
+
+  /**
+   * Allocate new I/O operation with data area of at least \a size_hint bytes
+   * or return nullptr if pool has reached service_t::io_pool_limit().
+   */
+  io_ptr try_make_io (size_t size_hint)
+  {
+    auto io = reinterpret_cast<io_t *>(
+      impl_.try_make_io(__bits::io_t::size_class_for(size_hint))
+    );
+    if (io)
+    {
+      io->context<std::nullptr_t>(nullptr);
+    }
+    return io_ptr{io};
+  }
+
+
+  /**
+   * Allocate new I/O operation or return nullptr if pool has reached
+   * service_t::io_pool_limit().
+   */
+  io_ptr try_make_io ()
+  {
+    auto io = reinterpret_cast<io_t *>(impl_.try_make_io());
+    if (io)
+    {
+      io->context<std::nullptr_t>(nullptr);
+    }
+    return io_ptr{io};
+  }
+
+
+  /**
+   * Allocate new I/O operation with data area of at least \a size_hint bytes.
+   * If pool has reached service_t::io_pool_limit(), wait up to \a timeout
+   * for some I/O operation of same size class to be released. Returns
+   * nullptr on timeout.
+   */
+  template <typename Rep, typename Period>
+  io_ptr try_make_io_for (const std::chrono::duration<Rep, Period> &timeout,
+    size_t size_hint)
+  {
+    auto io = reinterpret_cast<io_t *>(
+      impl_.try_make_io_for(
+        std::chrono::ceil<std::chrono::milliseconds>(timeout),
+        __bits::io_t::size_class_for(size_hint)
+      )
+    );
+    if (io)
+    {
+      io->context<std::nullptr_t>(nullptr);
+    }
+    return io_ptr{io};
+  }
+
+
+  /**
+   * Allocate new I/O operation, waiting up to \a timeout if pool has reached
+   * service_t::io_pool_limit().
+   * \see try_make_io_for(const std::chrono::duration<Rep, Period> &, size_t)
+   */
+  template <typename Rep, typename Period>
+  io_ptr try_make_io_for (const std::chrono::duration<Rep, Period> &timeout)
+  {
+    auto io = reinterpret_cast<io_t *>(
+      impl_.try_make_io_for(
+        std::chrono::ceil<std::chrono::milliseconds>(timeout)
+      )
+    );
+    if (io)
+    {
+      io->context<std::nullptr_t>(nullptr);
+    }
+    return io_ptr{io};
+  }
+
+
+  /**
+   * Return number of I/O operation allocations satisfied from calling
+   * thread's local cache (of this queue's service_t) without locking
+   * service_t pool.
+   *
+   * Thread gets own cache of free io_t objects per service_t when it first
+   * uses completion_queue_t of that service (make_io(), try_get(), wait()
+   * etc). After that, io_t allocations and releases for that service_t in
+   * that thread use this cache, exchanging io_t objects with service_t pool
+   * in batches. Threads that have not used any queue use service_t pool
+   * directly. Cached io_t objects are returned to pool when thread exits
+   * and, once pool has reached service_t::io_pool_limit(), on next use of
+   * cache (caching is bypassed until limit is changed or pool is trimmed).
+   */
+  size_t io_cache_hits () const noexcept
+  {
+    auto cache = __bits::find_io_cache(*impl_.service);
+    return cache ? cache->hits.load(std::memory_order_relaxed) : 0;
+  }
+
+
+  /**
+   * Return number of I/O operation allocations that had to refill calling
+   * thread's cache from service_t pool.
+   * \see io_cache_hits()
+   */
+  size_t io_cache_misses () const noexcept
+  {
+    auto cache = __bits::find_io_cache(*impl_.service);
+    return cache ? cache->misses.load(std::memory_order_relaxed) : 0;
+  }
+
+
+  /**
+   * Return true if this queue has own reactor.
+   * \see completion_queue_t(const service_t &, bool)
+   */
+  bool has_own_reactor () const noexcept
+  {
+    return impl_.has_reactor();
+  }
+
+
+  /**
+   * Pin calling thread to \a cpu. Intended to be called from thread that
+   * waits on queue with own reactor to keep it's sockets' state on single
+   * core. On failure (or if not supported by OS, like on MacOS), set
+   * \a error.
+   */
+  static void pin_thread (size_t cpu, std::error_code &error) noexcept
+  {
+    __bits::completion_queue_t::pin_thread(cpu, error);
+  }
+
+
+  /**
+   * \see pin_thread(size_t, std::error_code &)
+   * \throws std::system_error on failure
+   */
+  static void pin_thread (size_t cpu)
+  {
+    pin_thread(cpu, throw_on_error("completion_queue::pin_thread"));
+  }
+
+
+  /**
+   * Enable busy polling: wait_for() and wait() check for completions without
+   * blocking up to \a budget before falling back to blocking wait. This
+   * trades CPU for latency. Zero \a budget disables busy polling (default).
+   *
+   * If \a socket_busy_poll is true, sockets associated with this queue
+   * afterwards (see basic_socket_t::associate(completion_queue_t &)) also
+   * get SO_BUSY_POLL (\a budget) and SO_PREFER_BUSY_POLL set, letting kernel
+   * poll device queue directly (Linux only, best effort: raising busy poll
+   * above system default requires CAP_NET_ADMIN).
+   *
+   * Should be set before queue is used by waiting thread.
+   */
+  template <typename Rep, typename Period>
+  void busy_poll (const std::chrono::duration<Rep, Period> &budget,
+    bool socket_busy_poll = false) noexcept
+  {
+    using namespace std::chrono;
+    impl_.busy_poll_budget = duration_cast<nanoseconds>(budget);
+    impl_.socket_busy_poll = socket_busy_poll && budget.count() > 0
+      ? static_cast<int>((std::max)(
+          duration_cast<microseconds>(budget).count(),
+          microseconds::rep{1}
+        ))
+      : 0
+    ;
+  }
+
+
+  /**
+   * Return current busy polling budget.
+   * \see busy_poll(const std::chrono::duration<Rep, Period> &, bool)
+   */
+  std::chrono::nanoseconds busy_poll () const noexcept
+  {
+    return impl_.busy_poll_budget;
+  }
+
+
+  /**
+   * Return number of waits that found completions while busy polling (i.e.
+   * without blocking).
+   */
+  size_t busy_poll_completions () const noexcept
+  {
+    return impl_.busy_poll_completions.load(std::memory_order_relaxed);
+  }
+
+
+  /**
+   * Return number of waits that exhausted busy polling budget without
+   * completions and fell back to blocking wait.
+   */
+  size_t busy_poll_blocks () const noexcept
+  {
+    return impl_.busy_poll_blocks.load(std::memory_order_relaxed);
+  }
+
+
+  /**
+   * Counters of thread using this queue:
+   *   - waits: blocking waits for OS events (reactor events or completions)
+   *   - wakeups: blocking waits that returned with OS events (i.e. reactor
+   *     wake rate)
+   *   - events: OS events handled, including non-blocking polls (events per
+   *     wait is events / waits)
+   *   - would_block: attempts to finish pending operation that had to wait
+   *     for readiness (epoll/kqueue only), counted by thread that created
+   *     this queue
+   *
+   * Counters are updated by owning thread without synchronization and can
+   * be read from any thread.
+   */
+  using stats_t = __bits::io_stats_t;
+
+
+  /**
+   * Return snapshot of this queue's counters.
+   */
+  stats_t stats () const noexcept
+  {
+    return impl_.stats();
+  }
+
+
+  /**
+   * post() result type
+   */
+  struct post_t
+  {
+  };
+
+
+  /**
+   * Hand \a io over to thread waiting on this queue. Can be called from any
+   * thread. Posted \a io is returned through completion queue like completed
+   * I/O operation with result type post_t (application-specific payload can
+   * be passed in io_t data area and/or context).
+   *
+   * If queue has own reactor (see completion_queue_t(const service_t &,
+   * bool)), \a io is returned only by this queue. Otherwise queues sharing
+   * service are interchangeable and \a io is returned by any of them (same
+   * as with other completions).
+   *
+   * Waiting thread is woken up (eventfd on Linux, EVFILT_USER on MacOS,
+   * PostQueuedCompletionStatus on Windows, NOP with io_uring) only if it is
+   * blocked, i.e. posting to busy thread does not involve system calls.
+   */
+  void post (io_ptr &&io) noexcept
+  {
+    io->prepare<post_t>();
+    io->impl_.status.clear();
+    impl_.post(reinterpret_cast<__bits::io_t *>(io.release()));
+  }
+
+
   /**
    * Return next completed I/O operation without blocking calling thread. If
    * there is no pending completion immediately available, return nullptr.
@@ -73,6 +382,87 @@ public:
   }
 
 
+  /**
+   * Move up to \a ios.size() completed I/O operations into \a ios without
+   * blocking calling thread and return number of those (elements past
+   * returned count are not touched). Completions shared with other queues
+   * are taken under single lock, i.e. draining in batches is cheaper than
+   * calling try_get() repeatedly.
+   */
+  size_t try_get_many (const span_t<io_ptr> &ios) noexcept
+  {
+    auto it = ios.data();
+    return impl_.try_get_many(ios.size(),
+      [&it](__bits::io_t *io) noexcept
+      {
+        (it++)->reset(reinterpret_cast<io_t *>(io));
+      }
+    );
+  }
+
+
+  /**
+   * Return maximum number of OS events handled by single wait.
+   * \see max_events(size_t)
+   */
+  size_t max_events () const noexcept
+  {
+    return impl_.max_events;
+  }
+
+
+  /**
+   * Set maximum number of OS events (readiness events with epoll/kqueue,
+   * completions with IOCP/io_uring) handled by single wait_for()/wait()/
+   * poll() (default is 128, 256 on Windows). Bigger batches reduce number
+   * of system calls under load, smaller ones spread events more evenly
+   * between threads waiting on shared reactor. \a count is clamped to range
+   * [1, max_events_limit].
+   *
+   * Should be set before queue is used by waiting thread.
+   * \throws std::bad_alloc if event buffer can't be allocated
+   */
+  void max_events (size_t count)
+  {
+    impl_.set_max_events(std::clamp<size_t>(count, 1, max_events_limit));
+  }
+
+
+  /// Upper limit for max_events(size_t)
+  static constexpr size_t max_events_limit = 64 * 1024;
+
+
+  /**
+   * Return maximum number of operations of single socket finished per
+   * readiness event (epoll) or per reaped completions batch (io_uring).
+   * \see drain_budget(size_t)
+   */
+  size_t drain_budget () const noexcept
+  {
+    return impl_.drain_budget;
+  }
+
+
+  /**
+   * Set maximum number of pending operations of single socket finished per
+   * readiness event by wait_for()/wait()/poll() (default is 64, 0 means
+   * unlimited). When socket still has data after \a count operations, it is
+   * re-armed once all events of same wait are handled and reported again
+   * after other sockets that became ready meanwhile, so sockets with deep
+   * backlog can't starve others.
+   *
+   * With io_uring, socket's completions over \a count among completions
+   * reaped at once are queued after other sockets' completions of same
+   * batch (in their original order). Not supported with IOCP and kqueue.
+   *
+   * Should be set before queue is used by waiting thread.
+   */
+  void drain_budget (size_t count) noexcept
+  {
+    impl_.drain_budget = count;
+  }
+
+
   /**
    * Suspend calling thread up to \a timeout until there are more I/O
    * operations completed. After successful wait, next try_get() is guaranteed
@@ -153,6 +543,10 @@ public:
 private:
 
   __bits::completion_queue_t impl_;
+
+  template <typename Protocol> friend class net::basic_socket_t;
+  template <typename Protocol> friend class net::basic_socket_acceptor_t;
+  template <typename Protocol> friend class net::ip::basic_resolver_t;
 };
 
 
@@ -2,7 +2,9 @@
 #include <sal/net/async/service.hpp>
 #include <sal/net/ip/udp.hpp>
 #include <sal/net/common.test.hpp>
+#include <algorithm>
 #include <thread>
+#include <vector>
 
 
 namespace {
@@ -57,6 +59,138 @@ TEST_F(net_async_completion_queue, make_io_with_context) //{{{1
 }
 
 
+TEST_F(net_async_completion_queue, io_cache) //{{{1
+{
+  EXPECT_EQ(0U, queue.io_cache_hits());
+  EXPECT_EQ(0U, queue.io_cache_misses());
+
+  // first allocation refills cache from service pool
+  auto io = queue.make_io();
+  EXPECT_EQ(0U, queue.io_cache_hits());
+  EXPECT_EQ(1U, queue.io_cache_misses());
+
+  // following are served from cache
+  io = queue.make_io();
+  io = service.make_io();
+  EXPECT_EQ(2U, queue.io_cache_hits());
+  EXPECT_EQ(1U, queue.io_cache_misses());
+}
+
+
+TEST_F(net_async_completion_queue, io_cache_reuse_released) //{{{1
+{
+  auto io = queue.make_io();
+  auto p = io.get();
+  io.reset();
+
+  io = queue.make_io();
+  EXPECT_EQ(p, io.get());
+  EXPECT_EQ(1U, queue.io_cache_hits());
+}
+
+
+TEST_F(net_async_completion_queue, io_cache_size_class) //{{{1
+{
+  auto io = queue.make_io(0);
+  auto p = io.get();
+  io.reset();
+  EXPECT_EQ(1U, queue.io_cache_misses());
+
+  // each size class is cached separately
+  io = queue.make_io(65536);
+  EXPECT_NE(p, io.get());
+  EXPECT_EQ(2U, queue.io_cache_misses());
+
+  io = queue.make_io(1);
+  EXPECT_EQ(p, io.get());
+  EXPECT_EQ(1U, queue.io_cache_hits());
+}
+
+
+TEST_F(net_async_completion_queue, io_cache_many) //{{{1
+{
+  std::vector<sal::net::async::io_ptr> io_list;
+  for (auto i = 0U;  i != 1000;  ++i)
+  {
+    io_list.emplace_back(queue.make_io());
+  }
+  EXPECT_EQ(1000U, queue.io_cache_hits() + queue.io_cache_misses());
+  EXPECT_GT(queue.io_cache_hits(), queue.io_cache_misses());
+  io_list.clear();
+
+  // released back to service pool, no growing
+  auto pool_size = service.io_pool_size();
+  for (auto i = 0U;  i != 1000;  ++i)
+  {
+    io_list.emplace_back(queue.make_io());
+  }
+  EXPECT_EQ(pool_size, service.io_pool_size());
+}
+
+
+TEST_F(net_async_completion_queue, io_cache_other_thread) //{{{1
+{
+  std::thread([this]
+  {
+    // queue used from other thread binds that thread's own cache
+    auto io = queue.make_io();
+    EXPECT_NE(nullptr, io);
+    EXPECT_EQ(0U, queue.io_cache_hits());
+    EXPECT_EQ(1U, queue.io_cache_misses());
+
+    io = queue.make_io();
+    EXPECT_EQ(1U, queue.io_cache_hits());
+  }).join();
+  EXPECT_EQ(0U, queue.io_cache_hits());
+  EXPECT_EQ(0U, queue.io_cache_misses());
+
+  // io_t cached by exited thread are returned to pool
+  auto pool_size = service.io_pool_size();
+  EXPECT_EQ(pool_size, service.io_pool_free_size());
+}
+
+
+TEST_F(net_async_completion_queue, io_cache_other_queue) //{{{1
+{
+  // queues of same service share thread's cache
+  sal::net::async::completion_queue_t other{service};
+  auto io = other.make_io();
+  EXPECT_NE(nullptr, io);
+  EXPECT_EQ(0U, other.io_cache_hits());
+  EXPECT_EQ(1U, other.io_cache_misses());
+
+  io = queue.make_io();
+  EXPECT_EQ(1U, queue.io_cache_hits());
+  EXPECT_EQ(1U, queue.io_cache_misses());
+  EXPECT_EQ(1U, other.io_cache_hits());
+}
+
+
+TEST_F(net_async_completion_queue, io_cache_other_service) //{{{1
+{
+  auto io = queue.make_io();
+  EXPECT_EQ(1U, queue.io_cache_misses());
+
+  // thread has separate cache for each service it uses
+  sal::net::async::service_t other_service;
+  sal::net::async::completion_queue_t other{other_service};
+  EXPECT_EQ(0U, other.io_cache_misses());
+
+  auto other_io = other.make_io();
+  EXPECT_NE(nullptr, other_io);
+  EXPECT_EQ(0U, other.io_cache_hits());
+  EXPECT_EQ(1U, other.io_cache_misses());
+
+  other_io = other.make_io();
+  EXPECT_EQ(1U, other.io_cache_hits());
+
+  // switching back to first service uses it's cache
+  io = queue.make_io();
+  EXPECT_EQ(1U, queue.io_cache_hits());
+  EXPECT_EQ(1U, queue.io_cache_misses());
+}
+
+
 TEST_F(net_async_completion_queue, wait_for) //{{{1
 {
   a.start_receive(queue.make_io());
@@ -114,6 +248,11 @@ TEST_F(net_async_completion_queue, try_get_with_immediate_completion) //{{{1
   send(b, case_name);
   a.start_receive(queue.make_io());
 
+#if __sal_io_uring
+  // io_uring delivers all completions through wait/poll
+  EXPECT_TRUE(queue.poll());
+#endif
+
   auto io = queue.try_get();
   ASSERT_NE(nullptr, io);
 
@@ -198,11 +337,19 @@ TEST_F(net_async_completion_queue, send_skip_completion_queue_delayed) //{{{1
   b.start_send(std::move(io));
 
   EXPECT_EQ(nullptr, queue.try_get());
+#if __sal_io_uring
+  // send completion is reaped but not returned
+  EXPECT_TRUE(queue.poll());
+#else
   EXPECT_FALSE(queue.poll());
+#endif
   EXPECT_EQ(nullptr, queue.try_get());
 
   std::this_thread::sleep_for(1ms);
   a.start_receive(queue.make_io());
+#if __sal_io_uring
+  EXPECT_TRUE(queue.poll());
+#endif
   io = queue.try_get();
   ASSERT_NE(nullptr, io);
 
@@ -221,7 +368,12 @@ TEST_F(net_async_completion_queue, receive_skip_completion_queue_immediate) //{{
   EXPECT_TRUE(io->skip_completion_notification());
   a.start_receive(std::move(io));
 
+#if __sal_io_uring
+  // receive completion is reaped but not returned
+  EXPECT_TRUE(queue.poll());
+#else
   EXPECT_FALSE(queue.poll());
+#endif
 
   io = queue.try_get();
   EXPECT_EQ(nullptr, io);
@@ -243,6 +395,643 @@ TEST_F(net_async_completion_queue, receive_skip_completion_queue_delayed) //{{{1
 }
 
 
+TEST_F(net_async_completion_queue, own_reactor) //{{{1
+{
+  EXPECT_FALSE(queue.has_own_reactor());
+
+  sal::net::async::completion_queue_t reactor_queue{service, true};
+#if __sal_os_windows || __sal_io_uring
+  EXPECT_FALSE(reactor_queue.has_own_reactor());
+#else
+  EXPECT_TRUE(reactor_queue.has_own_reactor());
+#endif
+}
+
+
+TEST_F(net_async_completion_queue, own_reactor_associated_socket) //{{{1
+{
+  sal::net::async::completion_queue_t reactor_queue{service, true};
+
+  socket_t c{endpoint_t{sal::net::ip::address_v4_t::loopback, 0}};
+  c.associate(reactor_queue);
+  c.start_receive(reactor_queue.make_io());
+
+  socket_t d{protocol_t::v4};
+  d.send_to(case_name, c.local_endpoint());
+  std::this_thread::sleep_for(1ms);
+
+#if !__sal_os_windows && !__sal_io_uring
+  // events of socket bound to reactor_queue are not seen by other queues
+  EXPECT_FALSE(queue.poll());
+#endif
+
+  EXPECT_TRUE(reactor_queue.wait_for(1s));
+  auto io = reactor_queue.try_get();
+  ASSERT_NE(nullptr, io);
+
+  auto event = io->get_if<socket_t::receive_t>();
+  ASSERT_NE(nullptr, event);
+  EXPECT_EQ(case_name, to_view(io, event));
+}
+
+
+TEST_F(net_async_completion_queue, own_reactor_service_socket) //{{{1
+{
+  sal::net::async::completion_queue_t reactor_queue{service, true};
+  a.start_receive(reactor_queue.make_io());
+  send(b, case_name);
+
+  EXPECT_TRUE(reactor_queue.wait_for(1s));
+  auto io = reactor_queue.try_get();
+  ASSERT_NE(nullptr, io);
+
+  auto event = io->get_if<socket_t::receive_t>();
+  ASSERT_NE(nullptr, event);
+  EXPECT_EQ(case_name, to_view(io, event));
+}
+
+
+TEST_F(net_async_completion_queue, associate_already_associated) //{{{1
+{
+  std::error_code error;
+  a.associate(queue, error);
+  EXPECT_EQ(sal::net::socket_errc::already_associated, error);
+  EXPECT_THROW(a.associate(queue), std::system_error);
+}
+
+
+TEST_F(net_async_completion_queue, associate_closed) //{{{1
+{
+  socket_t c;
+  std::error_code error;
+  c.associate(queue, error);
+  EXPECT_EQ(std::errc::bad_file_descriptor, error);
+  EXPECT_THROW(c.associate(queue), std::system_error);
+}
+
+
+TEST_F(net_async_completion_queue, pin_thread) //{{{1
+{
+  std::error_code error;
+  std::thread([&error]
+  {
+    sal::net::async::completion_queue_t::pin_thread(0, error);
+  }).join();
+
+#if __sal_os_macos
+  EXPECT_EQ(std::errc::operation_not_supported, error);
+#else
+  EXPECT_TRUE(!error) << error.message();
+#endif
+}
+
+
+TEST_F(net_async_completion_queue, pin_thread_invalid_cpu) //{{{1
+{
+  EXPECT_THROW(
+    sal::net::async::completion_queue_t::pin_thread(
+      (std::numeric_limits<size_t>::max)()
+    ),
+    std::system_error
+  );
+}
+
+
+TEST_F(net_async_completion_queue, busy_poll) //{{{1
+{
+  EXPECT_EQ(0ns, queue.busy_poll());
+  queue.busy_poll(10us);
+  EXPECT_EQ(10us, queue.busy_poll());
+  queue.busy_poll(0s);
+  EXPECT_EQ(0ns, queue.busy_poll());
+}
+
+
+TEST_F(net_async_completion_queue, busy_poll_completion) //{{{1
+{
+  queue.busy_poll(1s);
+  a.start_receive(queue.make_io());
+  send(b, case_name);
+
+  EXPECT_TRUE(queue.wait());
+  EXPECT_EQ(1U, queue.busy_poll_completions());
+  EXPECT_EQ(0U, queue.busy_poll_blocks());
+
+  auto io = queue.try_get();
+  ASSERT_NE(nullptr, io);
+  auto event = io->get_if<socket_t::receive_t>();
+  ASSERT_NE(nullptr, event);
+  EXPECT_EQ(case_name, to_view(io, event));
+}
+
+
+TEST_F(net_async_completion_queue, busy_poll_posted) //{{{1
+{
+  queue.busy_poll(1s);
+
+  int io_ctx;
+  std::thread poster([this, &io_ctx]
+  {
+    std::this_thread::sleep_for(20ms);
+    queue.post(service.make_io(&io_ctx));
+  });
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_TRUE(queue.wait_for(5s));
+  EXPECT_GT(start + 1s, std::chrono::steady_clock::now());
+  poster.join();
+
+  EXPECT_EQ(1U, queue.busy_poll_completions());
+  EXPECT_EQ(0U, queue.busy_poll_blocks());
+
+  auto io = queue.try_get();
+  ASSERT_NE(nullptr, io);
+  EXPECT_EQ(&io_ctx, io->context<int>());
+}
+
+
+TEST_F(net_async_completion_queue, busy_poll_block) //{{{1
+{
+  queue.busy_poll(1ms);
+  a.start_receive(queue.make_io());
+
+  std::thread sender([this]
+  {
+    std::this_thread::sleep_for(20ms);
+    send(b, case_name);
+  });
+  EXPECT_TRUE(queue.wait_for(1s));
+  sender.join();
+
+  EXPECT_EQ(0U, queue.busy_poll_completions());
+  EXPECT_EQ(1U, queue.busy_poll_blocks());
+  EXPECT_NE(nullptr, queue.try_get());
+}
+
+
+TEST_F(net_async_completion_queue, busy_poll_timeout_within_budget) //{{{1
+{
+  queue.busy_poll(1s);
+  a.start_receive(queue.make_io());
+
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_FALSE(queue.wait_for(5ms));
+  EXPECT_LE(start + 5ms, std::chrono::steady_clock::now());
+  EXPECT_EQ(0U, queue.busy_poll_completions());
+  EXPECT_EQ(0U, queue.busy_poll_blocks());
+}
+
+
+TEST_F(net_async_completion_queue, busy_poll_socket) //{{{1
+{
+  queue.busy_poll(50us, true);
+
+  socket_t c{endpoint_t{sal::net::ip::address_v4_t::loopback, 0}};
+  c.associate(queue);
+  c.start_receive(queue.make_io());
+  b.send_to(case_name, c.local_endpoint());
+
+  EXPECT_TRUE(queue.wait_for(1s));
+  EXPECT_NE(nullptr, queue.try_get());
+}
+
+
+TEST_F(net_async_completion_queue, post) //{{{1
+{
+  int io_ctx = 1;
+  queue.post(queue.make_io(&io_ctx));
+
+  auto io = queue.try_get();
+  ASSERT_NE(nullptr, io);
+  EXPECT_EQ(&io_ctx, io->context<int>());
+
+  std::error_code error;
+  EXPECT_NE(nullptr, io->get_if<sal::net::async::completion_queue_t::post_t>(error));
+  EXPECT_TRUE(!error);
+  EXPECT_EQ(nullptr, io->get_if<socket_t::receive_t>());
+}
+
+
+TEST_F(net_async_completion_queue, post_reused_io) //{{{1
+{
+  a.start_receive(queue.make_io());
+  send(b, case_name);
+  ASSERT_TRUE(queue.wait_for(1s));
+  auto io = queue.try_get();
+  ASSERT_NE(nullptr, io);
+
+  // previous result is replaced
+  queue.post(std::move(io));
+  io = queue.try_get();
+  ASSERT_NE(nullptr, io);
+  EXPECT_EQ(nullptr, io->get_if<socket_t::receive_t>());
+  EXPECT_NE(nullptr, io->get_if<sal::net::async::completion_queue_t::post_t>());
+}
+
+
+TEST_F(net_async_completion_queue, post_wakes_waiter) //{{{1
+{
+  std::thread poster([this]
+  {
+    std::this_thread::sleep_for(10ms);
+    queue.post(service.make_io());
+  });
+
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_TRUE(queue.wait_for(10s));
+  EXPECT_GT(5s, std::chrono::steady_clock::now() - start);
+  poster.join();
+
+  auto io = queue.try_get();
+  ASSERT_NE(nullptr, io);
+  EXPECT_NE(nullptr, io->get_if<sal::net::async::completion_queue_t::post_t>());
+}
+
+
+TEST_F(net_async_completion_queue, post_own_reactor_wakes_waiter) //{{{1
+{
+  sal::net::async::completion_queue_t reactor_queue{service, true};
+
+  std::thread poster([&]
+  {
+    std::this_thread::sleep_for(10ms);
+    reactor_queue.post(service.make_io());
+  });
+
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_TRUE(reactor_queue.wait_for(10s));
+  EXPECT_GT(5s, std::chrono::steady_clock::now() - start);
+  poster.join();
+
+  EXPECT_NE(nullptr, reactor_queue.try_get());
+}
+
+
+TEST_F(net_async_completion_queue, post_own_reactor_not_seen_by_others) //{{{1
+{
+  sal::net::async::completion_queue_t reactor_queue{service, true};
+  reactor_queue.post(service.make_io());
+
+  if (reactor_queue.has_own_reactor())
+  {
+    EXPECT_FALSE(queue.poll());
+    EXPECT_EQ(nullptr, queue.try_get());
+  }
+  EXPECT_NE(nullptr, reactor_queue.try_get());
+}
+
+
+TEST_F(net_async_completion_queue, post_many) //{{{1
+{
+  constexpr size_t count = 1000;
+  std::thread poster([this]
+  {
+    for (auto i = 0U;  i != count;  ++i)
+    {
+      queue.post(service.make_io());
+    }
+  });
+
+  size_t received = 0;
+  while (received != count && queue.wait_for(10s))
+  {
+    while (auto io = queue.try_get())
+    {
+      ++received;
+    }
+  }
+  poster.join();
+  EXPECT_EQ(count, received);
+}
+
+
+TEST_F(net_async_completion_queue, try_get_many) //{{{1
+{
+  for (auto i = 0;  i != 3;  ++i)
+  {
+    queue.post(queue.make_io());
+  }
+
+  sal::net::async::io_ptr ios[2];
+  ASSERT_EQ(2U, queue.try_get_many(ios));
+  for (auto &io: ios)
+  {
+    ASSERT_NE(nullptr, io);
+    EXPECT_NE(nullptr, io->get_if<sal::net::async::completion_queue_t::post_t>());
+  }
+
+  // elements past returned count are not touched
+  auto first = ios[0].get(), second = ios[1].get();
+  ASSERT_EQ(1U, queue.try_get_many(ios));
+  EXPECT_NE(first, ios[0].get());
+  EXPECT_EQ(second, ios[1].get());
+
+  EXPECT_EQ(0U, queue.try_get_many(ios));
+}
+
+
+TEST_F(net_async_completion_queue, try_get_many_with_no_async_io) //{{{1
+{
+  sal::net::async::io_ptr ios[4];
+  EXPECT_EQ(0U, queue.try_get_many(ios));
+  for (auto &io: ios)
+  {
+    EXPECT_EQ(nullptr, io);
+  }
+}
+
+
+TEST_F(net_async_completion_queue, try_get_many_receive) //{{{1
+{
+  constexpr size_t count = 8;
+  for (auto i = 0U;  i != count;  ++i)
+  {
+    a.start_receive(queue.make_io());
+    send(b, case_name);
+  }
+
+  sal::net::async::io_ptr ios[count * 2];
+  size_t received = 0;
+  while (received != count && queue.wait_for(1s))
+  {
+    auto batch = queue.try_get_many(
+      sal::span_t<sal::net::async::io_ptr>{ios + received, count * 2 - received}
+    );
+    received += batch;
+  }
+  ASSERT_EQ(count, received);
+
+  for (auto i = 0U;  i != count;  ++i)
+  {
+    auto event = ios[i]->get_if<socket_t::receive_t>();
+    ASSERT_NE(nullptr, event);
+    EXPECT_EQ(case_name, to_view(ios[i], event));
+  }
+}
+
+
+TEST_F(net_async_completion_queue, max_events) //{{{1
+{
+#if __sal_os_windows
+  EXPECT_EQ(256U, queue.max_events());
+#else
+  EXPECT_EQ(128U, queue.max_events());
+#endif
+
+  queue.max_events(1000);
+  EXPECT_EQ(1000U, queue.max_events());
+
+  queue.max_events(0);
+  EXPECT_EQ(1U, queue.max_events());
+
+  queue.max_events(queue.max_events_limit + 1);
+  EXPECT_EQ(queue.max_events_limit, queue.max_events());
+}
+
+
+TEST_F(net_async_completion_queue, max_events_single) //{{{1
+{
+  queue.max_events(1);
+
+  constexpr size_t count = 4;
+  for (auto i = 0U;  i != count;  ++i)
+  {
+    a.start_receive(queue.make_io());
+  }
+  for (auto i = 0U;  i != count;  ++i)
+  {
+    send(b, case_name);
+  }
+
+  size_t received = 0;
+  while (received != count && queue.wait_for(1s))
+  {
+    while (auto io = queue.try_get())
+    {
+      EXPECT_NE(nullptr, io->get_if<socket_t::receive_t>());
+      ++received;
+    }
+  }
+  EXPECT_EQ(count, received);
+}
+
+
+TEST_F(net_async_completion_queue, max_events_big) //{{{1
+{
+  queue.max_events(1024);
+
+  a.start_receive(queue.make_io());
+  send(b, case_name);
+
+  ASSERT_TRUE(queue.wait_for(1s));
+  auto io = queue.try_get();
+  ASSERT_NE(nullptr, io);
+
+  auto event = io->get_if<socket_t::receive_t>();
+  ASSERT_NE(nullptr, event);
+  EXPECT_EQ(case_name, to_view(io, event));
+}
+
+
+TEST_F(net_async_completion_queue, stats) //{{{1
+{
+  auto stats = queue.stats();
+  EXPECT_EQ(0U, stats.waits);
+  EXPECT_EQ(0U, stats.wakeups);
+  EXPECT_EQ(0U, stats.events);
+  EXPECT_EQ(0U, stats.would_block);
+
+  EXPECT_FALSE(queue.wait_for(1ms));
+  stats = queue.stats();
+  EXPECT_EQ(1U, stats.waits);
+  EXPECT_EQ(0U, stats.wakeups);
+
+  a.start_receive(queue.make_io());
+  send(b, case_name);
+  ASSERT_TRUE(queue.wait_for(1s));
+  EXPECT_NE(nullptr, queue.try_get());
+
+  stats = queue.stats();
+  EXPECT_EQ(2U, stats.waits);
+  EXPECT_EQ(1U, stats.wakeups);
+  EXPECT_LE(1U, stats.events);
+#if __sal_io_uring
+  // operation is submitted to kernel, it never waits for readiness
+  (void)stats.would_block;
+#else
+  EXPECT_EQ(1U, stats.would_block);
+#endif
+}
+
+
+TEST_F(net_async_completion_queue, socket_stats) //{{{1
+{
+  auto stats = a.async_stats();
+  EXPECT_EQ(0U, stats.started);
+  EXPECT_EQ(0U, stats.completed);
+
+  a.start_receive(queue.make_io());
+  stats = a.async_stats();
+  EXPECT_EQ(1U, stats.started);
+  EXPECT_EQ(0U, stats.completed);
+
+  send(b, case_name);
+  ASSERT_TRUE(queue.wait_for(1s));
+  EXPECT_NE(nullptr, queue.try_get());
+
+  stats = a.async_stats();
+  EXPECT_EQ(1U, stats.started);
+  EXPECT_EQ(1U, stats.completed);
+
+  // canceled operations are counted as completed (with io_uring, when
+  // their completions are reaped)
+  a.start_receive(queue.make_io());
+  a.cancel_all();
+  EXPECT_EQ(2U, a.async_stats().started);
+#if !__sal_io_uring
+  EXPECT_EQ(2U, a.async_stats().completed);
+#endif
+}
+
+
+TEST_F(net_async_completion_queue, service_stats) //{{{1
+{
+  {
+    sal::net::async::completion_queue_t local_queue{service};
+    EXPECT_FALSE(local_queue.wait_for(1ms));
+  }
+  EXPECT_FALSE(queue.wait_for(1ms));
+
+  // destroyed queue's counters are kept
+  auto stats = service.stats();
+  EXPECT_EQ(2U, stats.waits);
+  EXPECT_EQ(0U, stats.wakeups);
+
+  auto io = queue.make_io();
+  EXPECT_EQ(1U, service.stats().io_pool_grows);
+  EXPECT_EQ(0U, service.stats().io_pool_trims);
+}
+
+
+TEST_F(net_async_completion_queue, drain_budget) //{{{1
+{
+  EXPECT_EQ(64U, queue.drain_budget());
+  queue.drain_budget(2);
+  EXPECT_EQ(2U, queue.drain_budget());
+
+  // receives are pending when datagrams arrive
+  constexpr size_t count = 5;
+  for (auto i = 0U;  i != count;  ++i)
+  {
+    a.start_receive(queue.make_io());
+  }
+  for (auto i = 0U;  i != count;  ++i)
+  {
+    b.send(case_name);
+  }
+  std::this_thread::sleep_for(1ms);
+
+  size_t received = 0;
+  ASSERT_TRUE(queue.poll());
+  while (queue.try_get())
+  {
+    ++received;
+  }
+#if !__sal_io_uring
+  EXPECT_EQ(2U, received);
+#endif
+
+  // socket is re-armed and reported again until all are finished
+  while (received < count && queue.wait_for(1s))
+  {
+    while (queue.try_get())
+    {
+      ++received;
+    }
+  }
+  EXPECT_EQ(count, received);
+}
+
+
+TEST_F(net_async_completion_queue, drain_budget_unlimited) //{{{1
+{
+  queue.drain_budget(0);
+
+  constexpr size_t count = 100;
+  for (auto i = 0U;  i != count;  ++i)
+  {
+    a.start_receive(queue.make_io());
+  }
+  for (auto i = 0U;  i != count;  ++i)
+  {
+    b.send(case_name);
+  }
+  std::this_thread::sleep_for(1ms);
+
+  size_t received = 0;
+  while (received < count && queue.wait_for(1s))
+  {
+    while (queue.try_get())
+    {
+      ++received;
+    }
+  }
+  EXPECT_EQ(count, received);
+}
+
+
+TEST_F(net_async_completion_queue, drain_budget_saturated_sockets) //{{{1
+{
+  constexpr size_t budget = 4, backlog = 4 * budget;
+  queue.drain_budget(budget);
+
+  // every socket has deep backlog of datagrams (sent one socket at time)
+  socket_t c{endpoint_t{endpoint.address(), 8196}};
+  socket_t d{endpoint_t{endpoint.address(), 8197}};
+  c.associate(service);
+  d.associate(service);
+  socket_t *sockets[] = { &a, &c, &d };
+  constexpr size_t socket_count = std::size(sockets);
+
+  for (auto socket: sockets)
+  {
+    socket->context(socket);
+    for (auto i = 0U;  i != backlog;  ++i)
+    {
+      socket->start_receive(queue.make_io());
+    }
+  }
+  for (auto socket: sockets)
+  {
+    for (auto i = 0U;  i != backlog;  ++i)
+    {
+      b.send_to(case_name, socket->local_endpoint());
+    }
+  }
+  std::this_thread::sleep_for(10ms);
+
+  // completion order by socket
+  std::vector<socket_t *> order;
+  while (order.size() < socket_count * backlog && queue.wait_for(1s))
+  {
+    while (auto io = queue.try_get())
+    {
+      order.emplace_back(io->socket_context<socket_t>());
+    }
+  }
+  ASSERT_EQ(socket_count * backlog, order.size());
+
+  // each socket progresses within first round of budgeted drains, none
+  // gets more than it's budget before others
+  auto first_round = order.begin() + socket_count * budget;
+  for (auto socket: sockets)
+  {
+    EXPECT_EQ(budget,
+      static_cast<size_t>(std::count(order.begin(), first_round, socket))
+    );
+  }
+}
+
+
 //}}}1
 
 
@@ -0,0 +1,448 @@
+#pragma once
+
+/**
+ * \file sal/net/async/coroutine.hpp
+ * C++20 coroutine awaitables for asynchronous I/O operations.
+ *
+ * This header is usable only with compilers supporting C++20 coroutines,
+ * otherwise it is empty. Use __sal_async_coroutine to check availability.
+ */
+
+
+#include <sal/config.hpp>
+
+#if __has_include(<coroutine>) && defined(__cpp_impl_coroutine)
+  #define __sal_async_coroutine 1
+#else
+  #define __sal_async_coroutine 0
+#endif
+
+#if __sal_async_coroutine
+
+#include <sal/net/async/completion_queue.hpp>
+#include <sal/net/async/io.hpp>
+#include <sal/net/async/service.hpp>
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+
+__sal_begin
+
+
+namespace net::async {
+
+
+/**
+ * Coroutine return type for functions that co_await asynchronous I/O
+ * operations. Coroutine starts executing immediately on invocation and it's
+ * frame is destroyed when coroutine returns. Unhandled exceptions terminate
+ * application.
+ */
+struct task_t
+{
+  /// \internal
+  struct promise_type
+  {
+    task_t get_return_object () noexcept
+    {
+      return {};
+    }
+
+    std::suspend_never initial_suspend () noexcept
+    {
+      return {};
+    }
+
+    std::suspend_never final_suspend () noexcept
+    {
+      return {};
+    }
+
+    void return_void () noexcept
+    { }
+
+    void unhandled_exception () noexcept
+    {
+      std::terminate();
+    }
+  };
+};
+
+
+/**
+ * Awaitable for started asynchronous I/O operation. It lives in awaiting
+ * coroutine frame and while operation is pending, io_t context points to it
+ * (original io_t context is restored on resume), i.e. there are no extra
+ * allocations per operation.
+ *
+ * Instances are created by async_*() functions below and resumed by
+ * scheduler_t::dispatch().
+ */
+class awaitable_base_t
+{
+public:
+
+  awaitable_base_t (const awaitable_base_t &) = delete;
+  awaitable_base_t &operator= (const awaitable_base_t &) = delete;
+  awaitable_base_t (awaitable_base_t &&) = delete;
+  awaitable_base_t &operator= (awaitable_base_t &&) = delete;
+
+
+  /// \internal
+  bool await_ready () const noexcept
+  {
+    return false;
+  }
+
+
+  /**
+   * Return completed I/O operation (application becomes owner). Use
+   * io_t::get_if() to query operation result.
+   */
+  io_ptr await_resume () noexcept
+  {
+    auto impl = reinterpret_cast<__bits::io_t *>(io_.get());
+    impl->context_type = context_type_;
+    impl->context = context_;
+    return std::move(io_);
+  }
+
+
+protected:
+
+  io_ptr io_;
+  std::coroutine_handle<> handle_{};
+  uintptr_t context_type_{};
+  void *context_{};
+
+
+  awaitable_base_t (io_ptr &&io) noexcept
+    : io_(std::move(io))
+  { }
+
+
+  ~awaitable_base_t () = default;
+
+
+  // take over io context until completion, return io to start with
+  io_ptr suspend (std::coroutine_handle<> handle) noexcept
+  {
+    handle_ = handle;
+    auto impl = reinterpret_cast<__bits::io_t *>(io_.get());
+    context_type_ = impl->context_type;
+    context_ = impl->context;
+    io_->context(this);
+    return std::move(io_);
+  }
+
+
+  friend class scheduler_t;
+};
+
+
+/**
+ * Awaitable that starts operation using \a Start callable (invoked with
+ * io_ptr &&) when awaiting coroutine is suspended.
+ */
+template <typename Start>
+class awaitable_t
+  : public awaitable_base_t
+{
+public:
+
+  /// \internal
+  awaitable_t (io_ptr &&io, Start start) noexcept
+    : awaitable_base_t(std::move(io))
+    , start_(std::move(start))
+  { }
+
+
+  /// \internal
+  void await_suspend (std::coroutine_handle<> handle)
+    noexcept(noexcept(std::declval<Start &>()(io_ptr{})))
+  {
+    start_(suspend(handle));
+  }
+
+
+private:
+
+  Start start_;
+};
+
+
+/**
+ * Single-threaded coroutine scheduler over completion_queue_t. It resumes
+ * coroutines awaiting completed I/O operations directly from completion
+ * drain loop.
+ *
+ * All operations awaited by coroutines must be allocated from same queue
+ * (or it's service) and scheduler must be used from single thread only.
+ */
+class scheduler_t
+{
+public:
+
+  /**
+   * Instantiate scheduler for \a queue.
+   */
+  scheduler_t (completion_queue_t &queue) noexcept
+    : queue_(queue)
+  { }
+
+
+  scheduler_t (const scheduler_t &) = delete;
+  scheduler_t &operator= (const scheduler_t &) = delete;
+  scheduler_t (scheduler_t &&) = delete;
+  scheduler_t &operator= (scheduler_t &&) = delete;
+
+
+  /**
+   * Return completion queue this scheduler drains.
+   */
+  completion_queue_t &queue () const noexcept
+  {
+    return queue_;
+  }
+
+
+  /**
+   * If completed \a io is awaited by coroutine, resume it and return
+   * nullptr. Otherwise return \a io back to caller.
+   */
+  io_ptr dispatch (io_ptr &&io) noexcept
+  {
+    if (auto awaitable = io->context<awaitable_base_t>())
+    {
+      awaitable->io_ = std::move(io);
+      awaitable->handle_.resume();
+      return {};
+    }
+    return std::move(io);
+  }
+
+
+  /**
+   * Dispatch completions already in queue without blocking. Completed I/O
+   * operations not awaited by coroutines are passed to \a on_io.
+   * \returns number of dispatched completions.
+   */
+  template <typename Handler>
+  size_t poll (Handler on_io)
+  {
+    size_t count = 0;
+    while (auto io = queue_.try_get())
+    {
+      if (auto unhandled = dispatch(std::move(io)))
+      {
+        on_io(std::move(unhandled));
+      }
+      ++count;
+    }
+    return count;
+  }
+
+
+  /**
+   * Dispatch completions already in queue without blocking. Completed I/O
+   * operations not awaited by coroutines are released.
+   * \returns number of dispatched completions.
+   */
+  size_t poll ()
+  {
+    return poll([](io_ptr &&) noexcept {});
+  }
+
+
+  /**
+   * Suspend calling thread up to \a timeout until there are completions and
+   * dispatch those.
+   * \see poll(Handler)
+   */
+  template <typename Rep, typename Period, typename Handler>
+  size_t run_for (const std::chrono::duration<Rep, Period> &timeout,
+    Handler on_io)
+  {
+    if (auto count = poll(on_io))
+    {
+      return count;
+    }
+    queue_.wait_for(timeout);
+    return poll(on_io);
+  }
+
+
+  /**
+   * \see run_for(const std::chrono::duration<Rep, Period> &, Handler)
+   */
+  template <typename Rep, typename Period>
+  size_t run_for (const std::chrono::duration<Rep, Period> &timeout)
+  {
+    return run_for(timeout, [](io_ptr &&) noexcept {});
+  }
+
+
+  /**
+   * Dispatch completions until \a done returns true.
+   */
+  template <typename Predicate>
+  void run_until (Predicate done)
+  {
+    while (!done())
+    {
+      if (!poll())
+      {
+        queue_.wait();
+      }
+    }
+  }
+
+
+private:
+
+  completion_queue_t &queue_;
+};
+
+
+/**
+ * Start receive_from() on \a socket using \a io and suspend awaiting coroutine
+ * until it completes. Additional \a args are passed to
+ * basic_datagram_socket_t::start_receive_from().
+ */
+template <typename Socket, typename... Args>
+auto async_receive_from (Socket &socket, io_ptr &&io, Args &&...args)
+{
+  return awaitable_t(std::move(io),
+    [&socket, args...](io_ptr &&io)
+    {
+      socket.start_receive_from(std::move(io), args...);
+    }
+  );
+}
+
+
+/**
+ * Start receive() on \a socket using \a io and suspend awaiting coroutine
+ * until it completes.
+ */
+template <typename Socket, typename... Args>
+auto async_receive (Socket &socket, io_ptr &&io, Args &&...args)
+{
+  return awaitable_t(std::move(io),
+    [&socket, args...](io_ptr &&io)
+    {
+      socket.start_receive(std::move(io), args...);
+    }
+  );
+}
+
+
+/**
+ * Start send_to() on \a socket using \a io and suspend awaiting coroutine
+ * until it completes.
+ */
+template <typename Socket, typename... Args>
+auto async_send_to (Socket &socket, io_ptr &&io, Args &&...args)
+{
+  return awaitable_t(std::move(io),
+    [&socket, args...](io_ptr &&io)
+    {
+      socket.start_send_to(std::move(io), args...);
+    }
+  );
+}
+
+
+/**
+ * Start send() on \a socket using \a io and suspend awaiting coroutine until
+ * it completes.
+ */
+template <typename Socket, typename... Args>
+auto async_send (Socket &socket, io_ptr &&io, Args &&...args)
+{
+  return awaitable_t(std::move(io),
+    [&socket, args...](io_ptr &&io)
+    {
+      socket.start_send(std::move(io), args...);
+    }
+  );
+}
+
+
+/**
+ * Start accept() on \a acceptor using \a io and suspend awaiting coroutine
+ * until it completes.
+ */
+template <typename Acceptor>
+auto async_accept (Acceptor &acceptor, io_ptr &&io)
+{
+  return awaitable_t(std::move(io),
+    [&acceptor](io_ptr &&io)
+    {
+      acceptor.start_accept(std::move(io));
+    }
+  );
+}
+
+
+/**
+ * Start connect() to \a endpoint on \a socket using \a io and suspend
+ * awaiting coroutine until it completes.
+ */
+template <typename Socket, typename Endpoint>
+auto async_connect (Socket &socket, io_ptr &&io, const Endpoint &endpoint)
+{
+  return awaitable_t(std::move(io),
+    [&socket, endpoint](io_ptr &&io)
+    {
+      socket.start_connect(std::move(io), endpoint);
+    }
+  );
+}
+
+
+/**
+ * Start timer using \a io on \a service and suspend awaiting coroutine until
+ * it expires after \a delay (or at deadline if \a delay is time_point).
+ */
+template <typename Delay>
+auto async_timer (service_t &service, io_ptr &&io, const Delay &delay)
+{
+  return awaitable_t(std::move(io),
+    [&service, delay](io_ptr &&io) noexcept
+    {
+      service.start_timer(std::move(io), delay);
+    }
+  );
+}
+
+
+/**
+ * Start asynchronous resolve on \a resolver using \a io and suspend awaiting
+ * coroutine until it completes through \a queue. Additional \a args are
+ * passed to basic_resolver_t::start_resolve() (host and service name
+ * strings must stay valid until coroutine is suspended, i.e. until end of
+ * co_await expression).
+ */
+template <typename Resolver, typename... Args>
+auto async_resolve (Resolver &resolver,
+  completion_queue_t &queue,
+  io_ptr &&io,
+  Args &&...args)
+{
+  return awaitable_t(std::move(io),
+    [&resolver, &queue, args...](io_ptr &&io) noexcept
+    {
+      resolver.start_resolve(queue, std::move(io), args...);
+    }
+  );
+}
+
+
+} // namespace net::async
+
+
+__sal_end
+
+#endif // __sal_async_coroutine
@@ -0,0 +1,283 @@
+#include <sal/net/async/coroutine.hpp>
+
+#if __sal_async_coroutine
+
+#include <sal/net/ip/udp.hpp>
+#include <sal/net/ip/tcp.hpp>
+#include <sal/net/common.test.hpp>
+
+
+namespace {
+
+
+using namespace std::chrono_literals;
+using sal_test::to_view;
+
+using socket_t = sal::net::ip::udp_t::socket_t;
+using sal::net::async::io_ptr;
+using sal::net::async::task_t;
+
+
+struct net_async_coroutine
+  : public sal_test::fixture
+{
+  const sal::net::ip::udp_t::endpoint_t endpoint{
+    sal::net::ip::address_v4_t::loopback,
+    8195
+  };
+
+  sal::net::async::service_t service{};
+  sal::net::async::completion_queue_t queue{service};
+  sal::net::async::scheduler_t scheduler{queue};
+  socket_t socket{sal::net::ip::udp_t::v4}, test_socket{sal::net::ip::udp_t::v4};
+
+
+  void SetUp ()
+  {
+    socket.bind(endpoint);
+    socket.associate(service);
+    test_socket.connect(endpoint);
+  }
+};
+
+
+TEST_F(net_async_coroutine, receive_from)
+{
+  std::string received;
+  auto coro = [&]() -> task_t
+  {
+    auto io = co_await async_receive_from(socket, queue.make_io());
+    if (auto result = io->get_if<socket_t::receive_from_t>())
+    {
+      received = to_view(io, result);
+    }
+  };
+
+  coro();
+  EXPECT_TRUE(received.empty());
+
+  test_socket.send(case_name);
+  scheduler.run_until([&] { return !received.empty(); });
+  EXPECT_EQ(case_name, received);
+}
+
+
+TEST_F(net_async_coroutine, receive_from_after_send)
+{
+  test_socket.send(case_name);
+
+  std::string received;
+  auto coro = [&]() -> task_t
+  {
+    auto io = co_await async_receive_from(socket, queue.make_io());
+    if (auto result = io->get_if<socket_t::receive_from_t>())
+    {
+      received = to_view(io, result);
+    }
+  };
+
+  coro();
+  scheduler.run_until([&] { return !received.empty(); });
+  EXPECT_EQ(case_name, received);
+}
+
+
+TEST_F(net_async_coroutine, context_restored)
+{
+  int ctx = 1;
+  int *resumed_ctx = nullptr;
+  auto done = false;
+  auto coro = [&]() -> task_t
+  {
+    auto io = co_await async_receive_from(socket, queue.make_io(&ctx));
+    resumed_ctx = io->context<int>();
+    done = true;
+  };
+
+  coro();
+  test_socket.send(case_name);
+  scheduler.run_until([&] { return done; });
+  EXPECT_EQ(&ctx, resumed_ctx);
+}
+
+
+TEST_F(net_async_coroutine, echo)
+{
+  constexpr size_t rounds = 10;
+
+  // echo server
+  auto server = [&]() -> task_t
+  {
+    for (auto i = 0U;  i != rounds;  ++i)
+    {
+      auto io = co_await async_receive_from(socket, queue.make_io());
+      if (auto result = io->get_if<socket_t::receive_from_t>())
+      {
+        io->resize(result->transferred);
+        auto remote_endpoint = result->remote_endpoint;
+        (void)co_await async_send_to(socket, std::move(io), remote_endpoint);
+      }
+    }
+  };
+
+  // client
+  socket_t client{sal::net::ip::udp_t::v4};
+  client.connect(endpoint);
+  client.associate(service);
+
+  size_t echoed = 0;
+  auto client_coro = [&]() -> task_t
+  {
+    for (auto i = 0U;  i != rounds;  ++i)
+    {
+      auto io = queue.make_io();
+      io->resize(case_name.size());
+      std::memcpy(io->data(), case_name.data(), case_name.size());
+      io = co_await async_send(client, std::move(io));
+      if (!io->get_if<socket_t::send_t>())
+      {
+        break;
+      }
+
+      io->reset();
+      io = co_await async_receive(client, std::move(io));
+      if (auto result = io->get_if<socket_t::receive_t>())
+      {
+        if (to_view(io, result) == case_name)
+        {
+          ++echoed;
+        }
+      }
+    }
+  };
+
+  server();
+  client_coro();
+  scheduler.run_until([&] { return echoed == rounds; });
+  EXPECT_EQ(rounds, echoed);
+}
+
+
+TEST_F(net_async_coroutine, error)
+{
+  std::error_code error;
+  auto done = false;
+  auto coro = [&]() -> task_t
+  {
+    auto io = co_await async_receive_from(socket, queue.make_io());
+    (void)io->get_if<socket_t::receive_from_t>(error);
+    done = true;
+  };
+
+  coro();
+  socket.close();
+  scheduler.run_until([&] { return done; });
+  EXPECT_EQ(std::errc::operation_canceled, error);
+}
+
+
+TEST_F(net_async_coroutine, timer)
+{
+  auto start = std::chrono::steady_clock::now();
+  auto done = false;
+  auto coro = [&]() -> task_t
+  {
+    auto io = co_await async_timer(service, queue.make_io(), 5ms);
+    done = io->get_if<sal::net::async::service_t::timer_t>() != nullptr;
+  };
+
+  coro();
+  scheduler.run_until([&] { return done; });
+  EXPECT_LE(start + 5ms, std::chrono::steady_clock::now());
+}
+
+
+TEST_F(net_async_coroutine, resolve)
+{
+  sal::net::ip::udp_t::resolver_t resolver;
+  size_t size = 0;
+  auto done = false;
+  auto coro = [&]() -> task_t
+  {
+    auto io = co_await async_resolve(resolver, queue, queue.make_io(),
+      "localhost",
+      "echo"
+    );
+    using resolve_t = sal::net::ip::udp_t::resolver_t::resolve_t;
+    if (auto result = io->get_if<resolve_t>())
+    {
+      size = result->size;
+    }
+    done = true;
+  };
+
+  coro();
+  scheduler.run_until([&] { return done; });
+  EXPECT_LT(0U, size);
+}
+
+
+TEST_F(net_async_coroutine, accept_and_connect)
+{
+  using tcp_t = sal::net::ip::tcp_t;
+  tcp_t::endpoint_t tcp_endpoint{sal::net::ip::address_v4_t::loopback, 8195};
+
+  tcp_t::acceptor_t acceptor{tcp_endpoint};
+  acceptor.non_blocking(true);
+  acceptor.associate(service);
+
+  tcp_t::socket_t client{tcp_t::v4};
+  client.associate(service);
+
+  auto accepted = false, connected = false;
+  auto server = [&]() -> task_t
+  {
+    auto io = co_await async_accept(acceptor, queue.make_io());
+    if (auto result = io->get_if<tcp_t::acceptor_t::accept_t>())
+    {
+      accepted = result->accepted_socket().is_open();
+    }
+  };
+  auto client_coro = [&]() -> task_t
+  {
+    auto io = co_await async_connect(client, queue.make_io(), tcp_endpoint);
+    connected = io->get_if<tcp_t::socket_t::connect_t>() != nullptr;
+  };
+
+  server();
+  client_coro();
+  scheduler.run_until([&] { return accepted && connected; });
+  EXPECT_TRUE(accepted);
+  EXPECT_TRUE(connected);
+}
+
+
+TEST_F(net_async_coroutine, poll_unhandled)
+{
+  socket.start_receive_from(queue.make_io());
+  test_socket.send(case_name);
+
+  io_ptr unhandled;
+  while (!unhandled)
+  {
+    scheduler.run_for(1s, [&](io_ptr &&io) { unhandled = std::move(io); });
+  }
+
+  auto result = unhandled->get_if<socket_t::receive_from_t>();
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(case_name, to_view(unhandled, result));
+}
+
+
+TEST_F(net_async_coroutine, dispatch_unhandled)
+{
+  auto io = queue.make_io();
+  auto p = io.get();
+  EXPECT_EQ(p, scheduler.dispatch(std::move(io)).get());
+}
+
+
+} // namespace
+
+
+#endif // __sal_async_coroutine
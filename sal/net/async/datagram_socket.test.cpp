@@ -2,7 +2,9 @@
 #include <sal/net/async/service.hpp>
 #include <sal/net/ip/udp.hpp>
 #include <sal/net/common.test.hpp>
+#include <set>
 #include <thread>
+#include <vector>
 
 
 namespace {
@@ -208,6 +210,228 @@ TYPED_TEST(net_async_datagram_socket, start_receive_from_no_sender) //{{{1
 }
 
 
+TYPED_TEST(net_async_datagram_socket, start_receive_from_pool_completed_on_close) //{{{1
+{
+  constexpr size_t depth = 3;
+  int socket_ctx;
+  TestFixture::socket.context(&socket_ctx);
+  TestFixture::socket.start_receive_from_pool(
+    TestFixture::queue.make_io(),
+    depth,
+    depth
+  );
+
+  // with io_uring, receive may finish before close but it's completion is
+  // reaped after socket is gone
+  TestFixture::send(TestFixture::case_name);
+  TestFixture::socket.close();
+
+  for (auto i = 0U;  i != depth;  ++i)
+  {
+    auto io = TestFixture::wait();
+    ASSERT_NE(nullptr, io);
+
+    std::error_code error;
+    auto result = io->template get_if<socket_t::receive_from_t>(error);
+    ASSERT_NE(nullptr, result);
+    if (error)
+    {
+      EXPECT_EQ(std::errc::operation_canceled, error);
+    }
+    else
+    {
+      EXPECT_EQ(TestFixture::case_name, to_view(io, result));
+    }
+
+    if (sal::is_debug_build)
+    {
+      EXPECT_THROW(io->template socket_context<int>(), std::logic_error);
+    }
+  }
+
+  // receives are not replaced after close
+  EXPECT_EQ(nullptr, TestFixture::poll());
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_receive_from_cancel) //{{{1
+{
+  int first_ctx = 1, second_ctx = 2;
+  auto first = TestFixture::queue.make_io(&first_ctx);
+  auto first_io = first.get();
+  TestFixture::socket.start_receive_from(std::move(first));
+  TestFixture::socket.start_receive_from(TestFixture::queue.make_io(&second_ctx));
+
+  TestFixture::socket.cancel(first_io);
+  auto io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+  EXPECT_EQ(&first_ctx, io->template context<int>());
+
+  std::error_code error;
+  auto result = io->template get_if<socket_t::receive_from_t>(error);
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(std::errc::operation_canceled, error);
+
+  // second is still pending
+  TestFixture::send(TestFixture::case_name);
+  io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+  EXPECT_EQ(&second_ctx, io->template context<int>());
+  result = io->template get_if<socket_t::receive_from_t>(error);
+  ASSERT_NE(nullptr, result);
+  EXPECT_TRUE(!error);
+  EXPECT_EQ(TestFixture::case_name, to_view(io, result));
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_receive_from_cancel_completed) //{{{1
+{
+  TestFixture::socket.start_receive_from(TestFixture::queue.make_io());
+  TestFixture::send(TestFixture::case_name);
+  auto io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+
+  TestFixture::socket.cancel(io.get());
+  EXPECT_EQ(nullptr, TestFixture::poll());
+
+  auto result = io->template get_if<socket_t::receive_from_t>();
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(TestFixture::case_name, to_view(io, result));
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_receive_from_cancel_all) //{{{1
+{
+  constexpr size_t count = 3;
+  for (auto i = 0U;  i != count;  ++i)
+  {
+    TestFixture::socket.start_receive_from(TestFixture::queue.make_io());
+  }
+  TestFixture::socket.cancel_all();
+
+  for (auto i = 0U;  i != count;  ++i)
+  {
+    auto io = TestFixture::wait();
+    ASSERT_NE(nullptr, io);
+
+    std::error_code error;
+    auto result = io->template get_if<socket_t::receive_from_t>(error);
+    ASSERT_NE(nullptr, result);
+    EXPECT_EQ(std::errc::operation_canceled, error);
+  }
+
+  // socket is still usable
+  TestFixture::socket.start_receive_from(TestFixture::queue.make_io());
+  TestFixture::send(TestFixture::case_name);
+  auto io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+  auto result = io->template get_if<socket_t::receive_from_t>();
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(TestFixture::case_name, to_view(io, result));
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_receive_from_pool) //{{{1
+{
+  int io_ctx = 1;
+  TestFixture::socket.start_receive_from_pool(
+    TestFixture::queue.make_io(&io_ctx),
+    2,
+    2
+  );
+
+  // each completed receive is replaced, no restart needed
+  for (auto i = 0U;  i != 5;  ++i)
+  {
+    auto data = TestFixture::case_name + std::to_string(i);
+    TestFixture::send(data);
+
+    auto io = TestFixture::wait();
+    ASSERT_NE(nullptr, io);
+    EXPECT_EQ(&io_ctx, io->template context<int>());
+
+    auto result = io->template get_if<socket_t::receive_from_t>();
+    ASSERT_NE(nullptr, result);
+    EXPECT_EQ(data, to_view(io, result));
+    EXPECT_EQ(TestFixture::test_socket.local_endpoint(), result->remote_endpoint);
+  }
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_receive_from_pool_burst) //{{{1
+{
+  TestFixture::socket.start_receive_from_pool(TestFixture::queue.make_io(), 1, 8);
+
+  std::set<std::string> expected, received;
+  for (auto i = 0U;  i != 64;  ++i)
+  {
+    auto data = std::to_string(i);
+    TestFixture::test_socket.send(data);
+    expected.emplace(std::move(data));
+  }
+
+  while (received.size() != expected.size())
+  {
+    auto io = TestFixture::wait();
+    ASSERT_NE(nullptr, io);
+    auto result = io->template get_if<socket_t::receive_from_t>();
+    ASSERT_NE(nullptr, result);
+    received.emplace(to_view(io, result));
+  }
+  EXPECT_EQ(expected, received);
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_receive_from_pool_cancel_all) //{{{1
+{
+  constexpr size_t depth = 3;
+  TestFixture::socket.start_receive_from_pool(
+    TestFixture::queue.make_io(),
+    depth,
+    depth
+  );
+  TestFixture::socket.cancel_all();
+
+  for (auto i = 0U;  i != depth;  ++i)
+  {
+    auto io = TestFixture::wait();
+    ASSERT_NE(nullptr, io);
+
+    std::error_code error;
+    auto result = io->template get_if<socket_t::receive_from_t>(error);
+    ASSERT_NE(nullptr, result);
+    EXPECT_EQ(std::errc::operation_canceled, error);
+  }
+
+  // canceled receives are not replaced
+  TestFixture::send(TestFixture::case_name);
+  EXPECT_EQ(nullptr, TestFixture::poll());
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_receive_from_pool_without_associate) //{{{1
+{
+  if (sal::is_debug_build)
+  {
+    socket_t s;
+    EXPECT_THROW(
+      s.start_receive_from_pool(TestFixture::queue.make_io(), 1, 1),
+      std::logic_error
+    );
+  }
+}
+
+
+TYPED_TEST(net_async_datagram_socket, cancel_without_associate) //{{{1
+{
+  if (sal::is_debug_build)
+  {
+    socket_t s;
+    EXPECT_THROW(s.cancel_all(), std::logic_error);
+  }
+}
+
+
 TYPED_TEST(net_async_datagram_socket, start_receive_from_peek) //{{{1
 {
   TestFixture::socket.start_receive_from(TestFixture::queue.make_io(), socket_t::peek);
@@ -425,6 +649,71 @@ TYPED_TEST(net_async_datagram_socket, start_receive_from_interleaved_after_send)
 }
 
 
+TYPED_TEST(net_async_datagram_socket, start_receive_from_concurrent) //{{{1
+{
+  constexpr size_t thread_count = 4, receives_per_thread = 8;
+  constexpr size_t receive_count = thread_count * receives_per_thread;
+
+  // start receives from multiple threads that exit afterwards
+  std::vector<std::thread> threads;
+  for (auto i = 0U;  i != thread_count;  ++i)
+  {
+    threads.emplace_back([this]
+    {
+      for (auto j = 0U;  j != receives_per_thread;  ++j)
+      {
+        TestFixture::socket.start_receive_from(TestFixture::service.make_io());
+      }
+    });
+  }
+  for (auto &thread: threads)
+  {
+    thread.join();
+  }
+
+  std::set<std::string> expected, received;
+  for (auto i = 0U;  i != receive_count;  ++i)
+  {
+    auto data = std::to_string(i);
+    TestFixture::test_socket.send(data);
+    expected.emplace(std::move(data));
+  }
+
+  size_t canceled = 0;
+  while (received.size() != expected.size())
+  {
+    auto io = TestFixture::wait();
+    ASSERT_NE(nullptr, io);
+
+    std::error_code error;
+    auto result = io->template get_if<socket_t::receive_from_t>(error);
+    ASSERT_NE(nullptr, result);
+
+#if __sal_io_uring
+    // with io_uring, operations started by exited thread are canceled
+    // (documented limitation) and data remains in socket: restart them from
+    // this thread
+    if (error == std::errc::operation_canceled)
+    {
+      ++canceled;
+      TestFixture::socket.start_receive_from(std::move(io));
+      continue;
+    }
+#endif
+
+    ASSERT_TRUE(!error) << error.message();
+    received.emplace(to_view(io, result));
+  }
+
+#if __sal_io_uring
+  EXPECT_LT(0U, canceled);
+#else
+  EXPECT_EQ(0U, canceled);
+#endif
+  EXPECT_EQ(expected, received);
+}
+
+
 //}}}1
 
 
@@ -493,6 +782,67 @@ TYPED_TEST(net_async_datagram_socket, start_receive_with_context) //{{{1
 }
 
 
+TYPED_TEST(net_async_datagram_socket, start_receive_deadline) //{{{1
+{
+  auto start = std::chrono::steady_clock::now();
+  TestFixture::socket.start_receive(TestFixture::queue.make_io(), start + 20ms);
+  EXPECT_FALSE(TestFixture::poll());
+
+  auto io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+  EXPECT_LE(start + 20ms, std::chrono::steady_clock::now());
+
+  std::error_code error;
+  auto result = io->template get_if<socket_t::receive_t>(error);
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(std::errc::timed_out, error);
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_receive_deadline_many) //{{{1
+{
+  // more than expired at once per batch
+  constexpr size_t count = 64;
+  auto deadline = std::chrono::steady_clock::now() + 20ms;
+  for (auto i = 0U;  i != count;  ++i)
+  {
+    TestFixture::socket.start_receive(TestFixture::queue.make_io(), deadline);
+  }
+  std::this_thread::sleep_for(30ms);
+
+  // all expired operations are canceled by first wait
+  ASSERT_TRUE(TestFixture::queue.wait_for(0ms));
+  for (auto i = 0U;  i != count;  ++i)
+  {
+    auto io = TestFixture::queue.try_get();
+    ASSERT_NE(nullptr, io) << i;
+
+    std::error_code error;
+    auto result = io->template get_if<socket_t::receive_t>(error);
+    ASSERT_NE(nullptr, result);
+    EXPECT_EQ(std::errc::timed_out, error);
+  }
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_receive_before_deadline) //{{{1
+{
+  TestFixture::socket.start_receive(TestFixture::queue.make_io(),
+    std::chrono::steady_clock::now() + 1s
+  );
+  TestFixture::send(TestFixture::case_name);
+
+  auto io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+
+  std::error_code error;
+  auto result = io->template get_if<socket_t::receive_t>(error);
+  ASSERT_NE(nullptr, result);
+  EXPECT_TRUE(!error) << error.message();
+  EXPECT_EQ(TestFixture::case_name, to_view(io, result));
+}
+
+
 TYPED_TEST(net_async_datagram_socket, start_receive_canceled_on_close) //{{{1
 {
   TestFixture::socket.start_receive(TestFixture::queue.make_io());
@@ -824,6 +1174,578 @@ TYPED_TEST(net_async_datagram_socket, start_send_to_empty_buf) //{{{1
 }
 
 
+TYPED_TEST(net_async_datagram_socket, start_send_to_chain) //{{{1
+{
+  auto io = TestFixture::queue.make_io(), body = TestFixture::queue.make_io();
+  TestFixture::fill(io, "head-");
+  TestFixture::fill(body, TestFixture::case_name);
+  io->chain(std::move(body));
+
+  TestFixture::socket.start_send_to(std::move(io),
+    TestFixture::test_socket.local_endpoint()
+  );
+  EXPECT_EQ("head-" + TestFixture::case_name, TestFixture::receive());
+
+  io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+  ASSERT_NE(nullptr, io->next());
+
+  auto result = io->template get_if<socket_t::send_to_t>();
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(5 + TestFixture::case_name.size(), result->transferred);
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_receive_from_chain) //{{{1
+{
+  auto io = TestFixture::queue.make_io();
+  io->resize(5);
+  io->chain(TestFixture::queue.make_io());
+
+  TestFixture::socket.start_receive_from(std::move(io));
+  TestFixture::send("head-" + TestFixture::case_name);
+
+  io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+
+  auto result = io->template get_if<socket_t::receive_from_t>();
+  ASSERT_NE(nullptr, result);
+  ASSERT_EQ(5 + TestFixture::case_name.size(), result->transferred);
+  EXPECT_EQ(TestFixture::test_socket.local_endpoint(), result->remote_endpoint);
+
+  auto body = io->unchain();
+  ASSERT_NE(nullptr, body);
+  EXPECT_EQ(nullptr, io->next());
+  EXPECT_EQ("head-", std::string(reinterpret_cast<char *>(io->data()), 5));
+  EXPECT_EQ(TestFixture::case_name,
+    std::string(
+      reinterpret_cast<char *>(body->data()),
+      result->transferred - 5
+    )
+  );
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_receive_from_chain_less_than_send) //{{{1
+{
+  auto io = TestFixture::queue.make_io();
+  io->resize(1);
+  auto body = TestFixture::queue.make_io();
+  body->resize(1);
+  io->chain(std::move(body));
+
+  TestFixture::socket.start_receive_from(std::move(io));
+  TestFixture::send(TestFixture::case_name);
+
+  io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+
+  std::error_code error;
+  auto result = io->template get_if<socket_t::receive_from_t>(error);
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(std::errc::message_size, error);
+}
+
+
+//}}}1
+
+
+TYPED_TEST(net_async_datagram_socket, start_receive_from_batch) //{{{1
+{
+  sal::net::async::io_ptr io[3] =
+  {
+    TestFixture::queue.make_io(),
+    TestFixture::queue.make_io(),
+    TestFixture::queue.make_io(),
+  };
+  TestFixture::socket.start_receive_from_batch(io, std::size(io));
+  for (auto &it: io)
+  {
+    EXPECT_EQ(nullptr, it);
+  }
+
+  TestFixture::send("one");
+  TestFixture::send("two");
+  TestFixture::send("three");
+
+  for (auto expected: {"one", "two", "three"})
+  {
+    auto io = TestFixture::wait();
+    ASSERT_NE(nullptr, io);
+    auto result = io->template get_if<socket_t::receive_from_t>();
+    ASSERT_NE(nullptr, result);
+    EXPECT_EQ(expected, to_view(io, result));
+    EXPECT_EQ(TestFixture::test_socket.local_endpoint(), result->remote_endpoint);
+  }
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_receive_from_batch_after_send) //{{{1
+{
+  TestFixture::send("one");
+  TestFixture::send("two");
+  TestFixture::send("three");
+
+  sal::net::async::io_ptr io[3] =
+  {
+    TestFixture::queue.make_io(),
+    TestFixture::queue.make_io(),
+    TestFixture::queue.make_io(),
+  };
+  TestFixture::socket.start_receive_from_batch(io, std::size(io));
+
+  for (auto expected: {"one", "two", "three"})
+  {
+    auto io = TestFixture::wait();
+    ASSERT_NE(nullptr, io);
+    auto result = io->template get_if<socket_t::receive_from_t>();
+    ASSERT_NE(nullptr, result);
+    EXPECT_EQ(expected, to_view(io, result));
+    EXPECT_EQ(TestFixture::test_socket.local_endpoint(), result->remote_endpoint);
+  }
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_receive_from_batch_partial) //{{{1
+{
+  TestFixture::send(TestFixture::case_name);
+
+  sal::net::async::io_ptr io[3] =
+  {
+    TestFixture::queue.make_io(),
+    TestFixture::queue.make_io(),
+    TestFixture::queue.make_io(),
+  };
+  TestFixture::socket.start_receive_from_batch(io, std::size(io));
+
+  auto completed = TestFixture::wait();
+  ASSERT_NE(nullptr, completed);
+  auto result = completed->template get_if<socket_t::receive_from_t>();
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(TestFixture::case_name, to_view(completed, result));
+  EXPECT_EQ(nullptr, TestFixture::poll());
+
+  // remaining are still pending
+  TestFixture::socket.close();
+  for (auto i = 0;  i != 2;  ++i)
+  {
+    completed = TestFixture::wait();
+    ASSERT_NE(nullptr, completed);
+    std::error_code error;
+    result = completed->template get_if<socket_t::receive_from_t>(error);
+    ASSERT_NE(nullptr, result);
+    EXPECT_EQ(std::errc::operation_canceled, error);
+  }
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_receive_from_batch_less_than_send) //{{{1
+{
+  std::string_view data{
+    TestFixture::case_name.data(),
+    TestFixture::case_name.size() / 2,
+  };
+
+  sal::net::async::io_ptr io[2] =
+  {
+    TestFixture::queue.make_io(),
+    TestFixture::queue.make_io(),
+  };
+  io[0]->resize(data.size());
+  TestFixture::socket.start_receive_from_batch(io, std::size(io));
+  TestFixture::send(TestFixture::case_name);
+  TestFixture::send(TestFixture::case_name);
+
+  // truncated datagram does not affect other in same batch
+  // (completion order is not guaranteed with io_uring)
+  for (auto i = 0;  i != 2;  ++i)
+  {
+    auto completed = TestFixture::wait();
+    ASSERT_NE(nullptr, completed);
+    std::error_code error;
+    auto result = completed->template get_if<socket_t::receive_from_t>(error);
+    ASSERT_NE(nullptr, result);
+    if (result->transferred == data.size())
+    {
+      EXPECT_EQ(std::errc::message_size, error);
+      EXPECT_EQ(data, to_view(completed, result));
+    }
+    else
+    {
+      EXPECT_FALSE(error);
+      EXPECT_EQ(TestFixture::case_name, to_view(completed, result));
+    }
+  }
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_receive_from_batch_more_than_max) //{{{1
+{
+  constexpr size_t count = 2 * sal::net::async::__bits::handler_t::max_batch_size + 1;
+  std::vector<sal::net::async::io_ptr> io;
+  while (io.size() != count)
+  {
+    io.emplace_back(TestFixture::queue.make_io());
+  }
+  TestFixture::socket.start_receive_from_batch(io.data(), io.size());
+
+  for (auto i = 0U;  i != count;  ++i)
+  {
+    TestFixture::test_socket.send(std::to_string(i));
+  }
+
+  for (auto i = 0U;  i != count;  ++i)
+  {
+    auto completed = TestFixture::wait();
+    ASSERT_NE(nullptr, completed);
+    auto result = completed->template get_if<socket_t::receive_from_t>();
+    ASSERT_NE(nullptr, result);
+    EXPECT_EQ(std::to_string(i), to_view(completed, result));
+  }
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_receive_from_batch_without_associate) //{{{1
+{
+  if (sal::is_debug_build)
+  {
+    socket_t s;
+    sal::net::async::io_ptr io[1] = { TestFixture::queue.make_io() };
+    EXPECT_THROW(
+      s.start_receive_from_batch(io, std::size(io)),
+      std::logic_error
+    );
+  }
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_send_to_batch) //{{{1
+{
+  sal::net::async::io_ptr io[3] =
+  {
+    TestFixture::queue.make_io(),
+    TestFixture::queue.make_io(),
+    TestFixture::queue.make_io(),
+  };
+  TestFixture::fill(io[0], "one");
+  TestFixture::fill(io[1], "two");
+  TestFixture::fill(io[2], "three");
+  TestFixture::socket.start_send_to_batch(io, std::size(io),
+    TestFixture::test_socket.local_endpoint()
+  );
+
+  for (auto expected: {"one", "two", "three"})
+  {
+    EXPECT_EQ(expected, TestFixture::receive());
+  }
+
+  for (auto expected: {"one", "two", "three"})
+  {
+    auto io = TestFixture::wait();
+    ASSERT_NE(nullptr, io);
+    auto result = io->template get_if<socket_t::send_to_t>();
+    ASSERT_NE(nullptr, result);
+    EXPECT_EQ(std::strlen(expected), result->transferred);
+  }
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_send_to_batch_without_associate) //{{{1
+{
+  if (sal::is_debug_build)
+  {
+    socket_t s;
+    sal::net::async::io_ptr io[1] = { TestFixture::queue.make_io() };
+    EXPECT_THROW(
+      s.start_send_to_batch(io, std::size(io), TestFixture::endpoint),
+      std::logic_error
+    );
+  }
+}
+
+
+//}}}1
+
+
+#if __sal_os_linux
+
+
+TYPED_TEST(net_async_datagram_socket, start_send_to_segmented) //{{{1
+{
+  auto data = std::string(100, 'a') + std::string(100, 'b') + "c";
+
+  auto io = TestFixture::queue.make_io();
+  TestFixture::fill(io, data);
+  TestFixture::socket.start_send_to_segmented(std::move(io),
+    TestFixture::test_socket.local_endpoint(),
+    100
+  );
+
+  EXPECT_EQ(data.substr(0, 100), TestFixture::receive());
+  EXPECT_EQ(data.substr(100, 100), TestFixture::receive());
+  EXPECT_EQ(data.substr(200), TestFixture::receive());
+
+  io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+
+  auto result = io->template get_if<socket_t::send_to_segmented_t>();
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(data.size(), result->transferred);
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_send_to_segmented_chain) //{{{1
+{
+  // segments span chained io_t data ranges
+  auto io = TestFixture::queue.make_io(), body = TestFixture::queue.make_io();
+  TestFixture::fill(io, std::string(50, 'a'));
+  TestFixture::fill(body, std::string(50, 'a') + std::string(100, 'b') + "c");
+  io->chain(std::move(body));
+
+  TestFixture::socket.start_send_to_segmented(std::move(io),
+    TestFixture::test_socket.local_endpoint(),
+    100
+  );
+
+  EXPECT_EQ(std::string(100, 'a'), TestFixture::receive());
+  EXPECT_EQ(std::string(100, 'b'), TestFixture::receive());
+  EXPECT_EQ("c", TestFixture::receive());
+
+  io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+  ASSERT_NE(nullptr, io->next());
+
+  auto result = io->template get_if<socket_t::send_to_segmented_t>();
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(201U, result->transferred);
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_send_to_segmented_invalid_size) //{{{1
+{
+  auto io = TestFixture::queue.make_io();
+  TestFixture::fill(io, std::string(1000, 'a'));
+  TestFixture::socket.start_send_to_segmented(std::move(io),
+    TestFixture::test_socket.local_endpoint(),
+    1
+  );
+
+  io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+
+  std::error_code error;
+  auto result = io->template get_if<socket_t::send_to_segmented_t>(error);
+  ASSERT_NE(nullptr, result);
+  EXPECT_TRUE(error);
+  EXPECT_EQ(0U, result->transferred);
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_receive_from_segmented) //{{{1
+{
+  TestFixture::socket.start_receive_from_segmented(TestFixture::queue.make_io());
+  TestFixture::send(TestFixture::case_name);
+
+  auto io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+
+  auto result = io->template get_if<socket_t::receive_from_segmented_t>();
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(TestFixture::case_name, to_view(io, result));
+  EXPECT_EQ(TestFixture::case_name.size(), result->segment_size);
+  EXPECT_EQ(TestFixture::test_socket.local_endpoint(), result->remote_endpoint);
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_receive_from_segmented_with_gro) //{{{1
+{
+  auto &socket = TestFixture::socket;
+  socket.set_option(sal::net::udp_gro(true));
+
+  // send to self, coalesced segments are delivered to GRO enabled socket
+  auto data = std::string(100, 'a') + std::string(100, 'b') + "c";
+  auto io = TestFixture::queue.make_io();
+  TestFixture::fill(io, data);
+  socket.start_send_to_segmented(std::move(io), socket.local_endpoint(), 100);
+
+  io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+  ASSERT_NE(nullptr, io->template get_if<socket_t::send_to_segmented_t>());
+
+  socket.start_receive_from_segmented(TestFixture::queue.make_io());
+  io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+
+  auto result = io->template get_if<socket_t::receive_from_segmented_t>();
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(data, to_view(io, result));
+  EXPECT_EQ(100U, result->segment_size);
+  EXPECT_EQ(socket.local_endpoint(), result->remote_endpoint);
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_receive_from_segmented_chain) //{{{1
+{
+  auto io = TestFixture::queue.make_io();
+  io->resize(5);
+  io->chain(TestFixture::queue.make_io());
+
+  TestFixture::socket.start_receive_from_segmented(std::move(io));
+  TestFixture::send("head-" + TestFixture::case_name);
+
+  io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+
+  auto result = io->template get_if<socket_t::receive_from_segmented_t>();
+  ASSERT_NE(nullptr, result);
+  ASSERT_EQ(5 + TestFixture::case_name.size(), result->transferred);
+  EXPECT_EQ(result->transferred, result->segment_size);
+  EXPECT_EQ(TestFixture::test_socket.local_endpoint(), result->remote_endpoint);
+
+  auto body = io->unchain();
+  ASSERT_NE(nullptr, body);
+  EXPECT_EQ("head-", std::string(reinterpret_cast<char *>(io->data()), 5));
+  EXPECT_EQ(TestFixture::case_name,
+    std::string(
+      reinterpret_cast<char *>(body->data()),
+      result->transferred - 5
+    )
+  );
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_receive_from_segmented_less_than_send) //{{{1
+{
+  auto io = TestFixture::queue.make_io();
+  io->resize(TestFixture::case_name.size() / 2);
+  TestFixture::socket.start_receive_from_segmented(std::move(io));
+  TestFixture::send(TestFixture::case_name);
+
+  io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+
+  std::error_code error;
+  auto result = io->template get_if<socket_t::receive_from_segmented_t>(error);
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(std::errc::message_size, error);
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_receive_from_segmented_without_associate) //{{{1
+{
+  if (sal::is_debug_build)
+  {
+    socket_t s;
+    EXPECT_THROW(
+      s.start_receive_from_segmented(TestFixture::queue.make_io()),
+      std::logic_error
+    );
+  }
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_receive_from_with_info) //{{{1
+{
+  auto started = std::chrono::system_clock::now();
+  TestFixture::socket.start_receive_from_with_info(TestFixture::queue.make_io());
+  TestFixture::send(TestFixture::case_name);
+
+  auto io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+
+  auto result = io->template get_if<socket_t::receive_from_with_info_t>();
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(TestFixture::case_name, to_view(io, result));
+  EXPECT_EQ(TestFixture::test_socket.local_endpoint(), result->remote_endpoint);
+  EXPECT_EQ(TestFixture::endpoint.address(), result->local_address);
+  EXPECT_NE(0U, result->interface_index);
+  EXPECT_LE(started - 1s, result->timestamp);
+  EXPECT_GE(std::chrono::system_clock::now(), result->timestamp);
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_receive_from_with_info_less_than_send) //{{{1
+{
+  auto io = TestFixture::queue.make_io();
+  io->resize(TestFixture::case_name.size() / 2);
+  TestFixture::socket.start_receive_from_with_info(std::move(io));
+  TestFixture::send(TestFixture::case_name);
+
+  io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+
+  std::error_code error;
+  auto result = io->template get_if<socket_t::receive_from_with_info_t>(error);
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(std::errc::message_size, error);
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_receive_from_with_info_without_associate) //{{{1
+{
+  if (sal::is_debug_build)
+  {
+    socket_t s;
+    EXPECT_THROW(
+      s.start_receive_from_with_info(TestFixture::queue.make_io()),
+      std::logic_error
+    );
+  }
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_send_to_segmented_without_associate) //{{{1
+{
+  if (sal::is_debug_build)
+  {
+    socket_t s;
+    EXPECT_THROW(
+      s.start_send_to_segmented(TestFixture::queue.make_io(),
+        TestFixture::endpoint,
+        100
+      ),
+      std::logic_error
+    );
+  }
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_send_to_zerocopy) //{{{1
+{
+  auto io = TestFixture::queue.make_io();
+  TestFixture::fill(io, TestFixture::case_name);
+  TestFixture::socket.start_send_to_zerocopy(std::move(io),
+    TestFixture::test_socket.local_endpoint()
+  );
+  EXPECT_EQ(TestFixture::case_name, TestFixture::receive());
+
+  io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+
+  auto result = io->template get_if<socket_t::send_to_t>();
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(TestFixture::case_name.size(), result->transferred);
+}
+
+
+TYPED_TEST(net_async_datagram_socket, start_send_to_zerocopy_without_associate) //{{{1
+{
+  if (sal::is_debug_build)
+  {
+    socket_t s;
+    EXPECT_THROW(
+      s.start_send_to_zerocopy(TestFixture::queue.make_io(),
+        TestFixture::endpoint
+      ),
+      std::logic_error
+    );
+  }
+}
+
+
+#endif // __sal_os_linux
+
+
 //}}}1
 
 
@@ -20,7 +20,11 @@ namespace net::async {
 
 
 /**
- * Asynchronous socket I/O operation handle and associated data for I/O (2kB).
+ * Asynchronous socket I/O operation handle and associated data for I/O.
+ *
+ * Data area size depends on size class chosen on allocation: small (512B),
+ * MTU (default, whole io_t fits into 2kB), jumbo frame (9kB) or maximum UDP
+ * datagram (64kB).
  *
  * This class is not meant to be instantiated directly but through
  * service_t::make_io(). It's lifecycle follows strict ownership:
@@ -74,7 +78,7 @@ public:
      */
     void operator() (io_t *io) noexcept
     {
-      io->impl_.service.free_list.push(&io->impl_);
+      io->impl_.service.release_io(&io->impl_);
     }
   };
 
@@ -86,7 +90,7 @@ public:
   void skip_completion_notification (bool skip) noexcept
   {
     impl_.completed_list = skip
-      ? &impl_.service.free_list
+      ? &impl_.free_list()
       : &impl_.service.completed_list
     ;
   }
@@ -98,7 +102,7 @@ public:
    */
   bool skip_completion_notification () const noexcept
   {
-    return impl_.completed_list == &impl_.service.free_list;
+    return impl_.completed_list == &impl_.free_list();
   }
 
 
@@ -107,8 +111,65 @@ public:
    */
   void reset () noexcept
   {
-    impl_.begin = impl_.data;
-    impl_.end = impl_.data + max_size();
+    impl_.begin = impl_.data();
+    impl_.end = impl_.data() + max_size();
+  }
+
+
+  /**
+   * Maximum number of I/O operations in scatter/gather chain (including
+   * chain head).
+   */
+  static constexpr size_t max_chain_size = __bits::io_t::max_chain_size;
+
+
+  /**
+   * Append \a io to end of scatter/gather chain started with this I/O
+   * operation. Send and receive operations (with or without endpoint,
+   * including segmented and with_info variants) started using chain head
+   * transfer data of ranges [begin(),end()) of each chained io_t in order,
+   * as single operation. Chain completes as unit: only head is returned
+   * through completion queue and result's transferred is total number of
+   * bytes over whole chain. Zerocopy sends, batched and pooled operations
+   * ignore chained io_t.
+   *
+   * Chained io_t objects are owned by head and released together with it.
+   *
+   * \throw std::logic_error if chain would exceed max_chain_size
+   */
+  void chain (std::unique_ptr<io_t, deleter_t> &&io)
+  {
+    auto tail = &impl_;
+    size_t size = 1;
+    while (tail->chain_next)
+    {
+      tail = tail->chain_next;
+      ++size;
+    }
+    sal_verify(size < max_chain_size);
+    tail->chain_next = &io.release()->impl_;
+  }
+
+
+  /**
+   * Return next I/O operation in chain or nullptr if this is last one.
+   * \see chain()
+   */
+  io_t *next () const noexcept
+  {
+    return reinterpret_cast<io_t *>(impl_.chain_next);
+  }
+
+
+  /**
+   * Detach and return rest of chain following this I/O operation.
+   * \see chain()
+   */
+  std::unique_ptr<io_t, deleter_t> unchain () noexcept
+  {
+    return std::unique_ptr<io_t, deleter_t>{
+      reinterpret_cast<io_t *>(std::exchange(impl_.chain_next, nullptr))
+    };
   }
 
 
@@ -166,7 +227,7 @@ public:
    */
   const std::byte *head () const noexcept
   {
-    return impl_.data;
+    return impl_.data();
   }
 
 
@@ -175,7 +236,7 @@ public:
    */
   const std::byte *tail () const noexcept
   {
-    return impl_.data + max_size();
+    return impl_.data() + max_size();
   }
 
 
@@ -215,7 +276,7 @@ public:
   void head_gap (size_t offset_from_head)
   {
     sal_assert(offset_from_head <= max_size());
-    impl_.begin = impl_.data + offset_from_head;
+    impl_.begin = impl_.data() + offset_from_head;
   }
 
 
@@ -270,11 +331,13 @@ public:
 
 
   /**
-   * Return data area size (in bytes).
+   * Return data area size (in bytes). It depends on size class that was
+   * chosen by size hint on allocation.
+   * \see service_t::make_io(size_t)
    */
-  static constexpr size_t max_size () noexcept
+  size_t max_size () const noexcept
   {
-    return sizeof(impl_.data);
+    return impl_.data_size;
   }
 
 
@@ -354,9 +417,12 @@ private:
 
 
   friend class service_t;
+  friend class completion_queue_t;
   template <typename Protocol> friend class net::basic_datagram_socket_t;
   template <typename Protocol> friend class net::basic_stream_socket_t;
   template <typename Protocol> friend class net::basic_socket_acceptor_t;
+  template <typename Socket> friend class secure_socket_t;
+  template <typename Protocol> friend class net::ip::basic_resolver_t;
 };
 
 
@@ -1,6 +1,7 @@
 #include <sal/net/async/io.hpp>
 #include <sal/net/async/service.hpp>
 #include <sal/common.test.hpp>
+#include <vector>
 
 
 namespace {
@@ -209,4 +210,110 @@ TEST_F(net_async_io, reset)
 }
 
 
+TEST_F(net_async_io, size_hint)
+{
+  auto default_io = service.make_io();
+  EXPECT_LE(1500U, default_io->max_size());
+
+  for (size_t size_hint: { 0U, 1U, 512U, 1500U, 9000U, 65535U, 65536U })
+  {
+    auto io = service.make_io(size_hint);
+    EXPECT_LE(size_hint, io->max_size());
+    EXPECT_EQ(io->max_size(), io->size());
+    EXPECT_EQ(io->head() + io->max_size(), io->tail());
+  }
+
+  EXPECT_GT(default_io->max_size(), service.make_io(0)->max_size());
+  EXPECT_EQ(default_io->max_size(), service.make_io(1500)->max_size());
+  EXPECT_LT(default_io->max_size(), service.make_io(9000)->max_size());
+}
+
+
+TEST_F(net_async_io, size_hint_too_big)
+{
+  EXPECT_THROW(service.make_io(65537), std::logic_error);
+}
+
+
+TEST_F(net_async_io, size_hint_gaps)
+{
+  auto io = service.make_io(65536);
+  io->head_gap(100);
+  io->tail_gap(100);
+  EXPECT_EQ(io->max_size() - 200, io->size());
+  EXPECT_THROW(io->head_gap(io->max_size() + 1), std::logic_error);
+
+  io->reset();
+  EXPECT_EQ(io->max_size(), io->size());
+}
+
+
+TEST_F(net_async_io, size_hint_skip_completion_notification)
+{
+  auto io = service.make_io(9000);
+  io->skip_completion_notification(true);
+  EXPECT_TRUE(io->skip_completion_notification());
+
+  auto small_io = service.make_io(0);
+  EXPECT_FALSE(small_io->skip_completion_notification());
+  small_io->skip_completion_notification(true);
+  EXPECT_TRUE(small_io->skip_completion_notification());
+}
+
+
+TEST_F(net_async_io, chain)
+{
+  auto io = service.make_io();
+  EXPECT_EQ(nullptr, io->next());
+
+  auto second = service.make_io(), third = service.make_io(0);
+  auto second_p = second.get(), third_p = third.get();
+  io->chain(std::move(second));
+  io->chain(std::move(third));
+  EXPECT_EQ(nullptr, second);
+  EXPECT_EQ(second_p, io->next());
+  EXPECT_EQ(third_p, io->next()->next());
+  EXPECT_EQ(nullptr, third_p->next());
+
+  auto rest = io->unchain();
+  EXPECT_EQ(second_p, rest.get());
+  EXPECT_EQ(nullptr, io->next());
+  EXPECT_EQ(third_p, rest->next());
+}
+
+
+TEST_F(net_async_io, chain_max_size)
+{
+  auto io = service.make_io(0);
+  for (auto i = 1U;  i != io->max_chain_size;  ++i)
+  {
+    io->chain(service.make_io(0));
+  }
+  EXPECT_THROW(io->chain(service.make_io(0)), std::logic_error);
+}
+
+
+TEST_F(net_async_io, chain_released_with_head)
+{
+  auto io = service.make_io();
+  auto chained = service.make_io();
+  auto chained_p = chained.get();
+  io->chain(std::move(chained));
+  io.reset();
+
+  // chained io is back in free list and reusable without stale chain
+  std::vector<sal::net::async::io_ptr> ios;
+  for (auto i = 0U;  i != 64;  ++i)
+  {
+    ios.emplace_back(service.make_io());
+    EXPECT_EQ(nullptr, ios.back()->next());
+    if (ios.back().get() == chained_p)
+    {
+      return;
+    }
+  }
+  FAIL() << "chained io not released";
+}
+
+
 } // namespace
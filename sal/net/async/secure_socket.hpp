@@ -0,0 +1,371 @@
+#pragma once
+
+/**
+ * \file sal/net/async/secure_socket.hpp
+ * Asynchronous TLS/DTLS channel over connected socket
+ */
+
+
+#include <sal/config.hpp>
+#include <sal/crypto/channel.hpp>
+#include <sal/net/async/io.hpp>
+#include <sal/net/async/service.hpp>
+#include <sal/span.hpp>
+#include <deque>
+#include <new>
+#include <vector>
+
+
+__sal_begin
+
+
+namespace net::async {
+
+
+/**
+ * Secure (TLS or DTLS) two-way channel over connected asynchronous \a Socket
+ * (stream or datagram). \a Socket must be associated with service_t and
+ * crypto::channel_t must be created by matching (stream or datagram) channel
+ * factory.
+ *
+ * Encrypted data is received into io_t started with start_receive().
+ * Application must pass completions of these to handle() that feeds received
+ * data to channel and restarts receive with same io_t. During handshake,
+ * generated messages are sent to peer automatically, i.e. handshake
+ * progresses with completions. After handshake, decrypted data is stored
+ * directly into new io_t allocated from service_t pool and returned by
+ * try_get().
+ *
+ * Data sent with start_send() and handshake messages are encrypted directly
+ * into new io_t(s) that are sent to peer. Completions of these must also be
+ * passed to handle() that releases them and reports send failures.
+ *
+ * On client side, handshake is initiated with start_handshake(). Handshake
+ * messages lost in network (DTLS) are not retransmitted.
+ *
+ * This class is not thread-safe: all calls must be made from single thread at
+ * time.
+ */
+template <typename Socket>
+class secure_socket_t
+  : private crypto::channel_t::buffer_manager_t
+{
+public:
+
+  /// Underlying socket type
+  using socket_t = Socket;
+
+
+  /**
+   * try_get() result type
+   */
+  struct receive_t
+  {
+    /// Number of decrypted bytes in [io.data(), io.data() + transferred)
+    size_t transferred;
+  };
+
+
+  /**
+   * Construct secure channel over \a socket using \a channel. New io_t for
+   * decrypted and encrypted data are allocated from \a service.
+   */
+  secure_socket_t (Socket &socket,
+      crypto::channel_t &&channel,
+      service_t &service) noexcept
+    : socket_(socket)
+    , channel_(std::move(channel))
+    , service_(service)
+  { }
+
+
+  secure_socket_t (const secure_socket_t &) = delete;
+  secure_socket_t &operator= (const secure_socket_t &) = delete;
+  secure_socket_t (secure_socket_t &&) = delete;
+  secure_socket_t &operator= (secure_socket_t &&) = delete;
+
+
+  /**
+   * Return true if handshake is successfully finished.
+   */
+  bool is_connected () const noexcept
+  {
+    return channel_.is_connected();
+  }
+
+
+  /**
+   * On client side, initiate handshake by sending first message to server.
+   * On failure, set \a error.
+   */
+  void start_handshake (std::error_code &error) noexcept
+  {
+    output_ = output_t::send;
+    (void)channel_.handshake(span_t<const uint8_t>{}, *this, error);
+  }
+
+
+  /**
+   * \see start_handshake(std::error_code &)
+   * \throws std::system_error on failure
+   */
+  void start_handshake ()
+  {
+    start_handshake(throw_on_error("secure_socket::start_handshake"));
+  }
+
+
+  /**
+   * Start receiving encrypted data into \a io. Completed \a io must be
+   * passed to handle().
+   */
+  void start_receive (io_ptr &&io) noexcept(!is_debug_build)
+  {
+    io->context(this);
+    socket_.start_receive(std::move(io));
+  }
+
+
+  /**
+   * If \a io is completed receive started with start_receive(), feed
+   * received data to channel and restart receive using same \a io. If \a io
+   * is completed send of encrypted data, release it. Returns false if \a io
+   * belongs to some other operation (it is not touched).
+   *
+   * On socket or channel failure (including failure to allocate memory for
+   * buffered data), set \a error and release \a io (receive is not
+   * restarted).
+   */
+  bool handle (io_ptr &io, std::error_code &error) noexcept
+  {
+    if (io->template context<secure_socket_t>() != this)
+    {
+      return false;
+    }
+
+    if (io->template get_if<typename Socket::send_t>(error))
+    {
+      io.reset();
+      return true;
+    }
+
+    auto result = io->template get_if<typename Socket::receive_t>(error);
+    if (result && !error)
+    {
+      process(
+        reinterpret_cast<const uint8_t *>(io->data()),
+        result->transferred,
+        error
+      );
+    }
+
+    if (!result || error)
+    {
+      io.reset();
+      return true;
+    }
+
+    io->reset();
+    start_receive(std::move(io));
+    return true;
+  }
+
+
+  /**
+   * \see handle(io_ptr &, std::error_code &)
+   * \throws std::system_error on failure
+   */
+  bool handle (io_ptr &io)
+  {
+    return handle(io, throw_on_error("secure_socket::handle"));
+  }
+
+
+  /**
+   * Return next io_t with decrypted data (result type receive_t) or nullptr
+   * if there is none.
+   */
+  io_ptr try_get () noexcept
+  {
+    io_ptr io{};
+    if (!decrypted_.empty())
+    {
+      io = std::move(decrypted_.front());
+      decrypted_.pop_front();
+    }
+    return io;
+  }
+
+
+  /**
+   * Encrypt data [io.begin(), io.end()) and start sending it. \a io is
+   * released. On failure, set \a error. Send completions are returned
+   * through completion queue and must be passed to handle().
+   */
+  void start_send (io_ptr &&io, std::error_code &error) noexcept
+  {
+    output_ = output_t::send;
+    channel_.encrypt(
+      span_t<const uint8_t>{
+        reinterpret_cast<const uint8_t *>(io->data()),
+        io->size()
+      },
+      *this,
+      error
+    );
+    io.reset();
+  }
+
+
+  /**
+   * \see start_send(io_ptr &&, std::error_code &)
+   * \throws std::system_error on failure
+   */
+  void start_send (io_ptr &&io)
+  {
+    start_send(std::move(io), throw_on_error("secure_socket::start_send"));
+  }
+
+
+private:
+
+  Socket &socket_;
+  crypto::channel_t channel_;
+  service_t &service_;
+
+  // where channel output goes: sent to peer or returned by try_get()
+  enum class output_t { send, receive } output_{};
+
+  std::deque<io_ptr> decrypted_{};
+
+  // stream: beginning of record not fully received yet
+  std::vector<uint8_t> partial_{};
+
+  // failure in ready() callback, reported by process()
+  std::error_code ready_error_{};
+
+
+  void process (const uint8_t *data, size_t size, std::error_code &error)
+    noexcept
+  {
+    try
+    {
+      process(data, data + size, error);
+    }
+    catch (const std::bad_alloc &)
+    {
+      partial_.clear();
+      error = std::make_error_code(std::errc::not_enough_memory);
+    }
+  }
+
+
+  void process (const uint8_t *first, const uint8_t *last,
+    std::error_code &error)
+  {
+    if (!partial_.empty())
+    {
+      partial_.insert(partial_.end(), first, last);
+      first = partial_.data();
+      last = first + partial_.size();
+    }
+
+    while (first != last)
+    {
+      span_t<const uint8_t> input{first, last};
+      size_t used;
+      if (!channel_.is_connected())
+      {
+        output_ = output_t::send;
+        used = channel_.handshake(input, *this, error);
+      }
+      else
+      {
+        output_ = output_t::receive;
+        used = channel_.decrypt(input, *this, error);
+      }
+
+      if (ready_error_)
+      {
+        error = ready_error_;
+        ready_error_.clear();
+      }
+
+      if (error || !used)
+      {
+        break;
+      }
+      first += used;
+    }
+
+    if (first == last || error)
+    {
+      partial_.clear();
+    }
+    else if (partial_.empty())
+    {
+      partial_.assign(first, last);
+    }
+    else
+    {
+      auto used = first - partial_.data();
+      partial_.erase(partial_.begin(), partial_.begin() + used);
+    }
+  }
+
+
+  uintptr_t alloc (uint8_t **buffer, size_t *buffer_size)
+    noexcept final override
+  {
+    io_t *io = nullptr;
+    try
+    {
+      io = service_.make_io().release();
+      *buffer = reinterpret_cast<uint8_t *>(io->data());
+      *buffer_size = io->size();
+    }
+    catch (...)
+    {
+      *buffer = nullptr;
+      *buffer_size = 0;
+    }
+    return reinterpret_cast<uintptr_t>(io);
+  }
+
+
+  void ready (uintptr_t user_data, uint8_t *, size_t size)
+    noexcept final override
+  {
+    io_ptr io{reinterpret_cast<io_t *>(user_data)};
+    if (!io || !size)
+    {
+      return;
+    }
+
+    io->resize(size);
+    if (output_ == output_t::receive)
+    {
+      io->template prepare<receive_t>()->transferred = size;
+      io->impl_.status.clear();
+      try
+      {
+        decrypted_.emplace_back(std::move(io));
+      }
+      catch (const std::bad_alloc &)
+      {
+        ready_error_ = std::make_error_code(std::errc::not_enough_memory);
+      }
+    }
+    else
+    {
+      io->context(this);
+      socket_.start_send(std::move(io));
+    }
+  }
+};
+
+
+} // namespace net::async
+
+
+__sal_end
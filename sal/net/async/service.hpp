@@ -65,6 +65,169 @@ public:
   }
 
 
+  /**
+   * Return highest io_pool_size() reached.
+   */
+  size_t io_pool_peak_size () const noexcept
+  {
+    return impl_->io_pool_peak_size;
+  }
+
+
+  /**
+   * Return number of I/O operation instances available in pool. Instances
+   * held by threads' local caches (see completion_queue_t::io_cache_hits())
+   * are not counted.
+   */
+  size_t io_pool_free_size () const noexcept
+  {
+    return impl_->io_pool_free_size();
+  }
+
+
+  /**
+   * Return number of bytes allocated for I/O operation instances (including
+   * their data areas).
+   */
+  size_t io_pool_memory () const noexcept
+  {
+    return impl_->io_pool_memory;
+  }
+
+
+  /**
+   * Return maximum number of bytes pool may allocate.
+   * \see io_pool_limit(size_t)
+   */
+  size_t io_pool_limit () const noexcept
+  {
+    return impl_->io_pool_limit.load(std::memory_order_relaxed);
+  }
+
+
+  /**
+   * Limit memory allocated by pool to \a max_memory bytes (by default
+   * unlimited). When pool has reached limit and there are no free instances
+   * of requested size class, make_io() throws std::bad_alloc, try_make_io()
+   * returns nullptr and try_make_io_for() waits for I/O operation to be
+   * released. Already allocated memory is not affected.
+   *
+   * Once pool can't grow anymore, threads stop caching released I/O
+   * operations (see completion_queue_t::io_cache_hits()) so that all free
+   * instances are available to every thread.
+   */
+  void io_pool_limit (size_t max_memory) noexcept
+  {
+    impl_->io_pool_limit.store(max_memory, std::memory_order_relaxed);
+    impl_->io_pool_capped.store(false, std::memory_order_relaxed);
+    impl_->io_released();
+  }
+
+
+  /**
+   * Return pool memory high water mark.
+   * \see io_pool_high_water(size_t)
+   */
+  size_t io_pool_high_water () const noexcept
+  {
+    return impl_->io_pool_high_water.load(std::memory_order_relaxed);
+  }
+
+
+  /**
+   * While pool memory is above \a memory bytes, pool allocation blocks whose
+   * I/O operations have all stayed free for io_pool_idle_timeout() are
+   * released back to OS (by default, pool never shrinks). Check is done
+   * from completion_queue_t::wait() at most once per idle timeout.
+   */
+  void io_pool_high_water (size_t memory) noexcept
+  {
+    impl_->io_pool_high_water.store(memory, std::memory_order_relaxed);
+  }
+
+
+  /**
+   * Return how long pool allocation block must stay free before it is
+   * released.
+   * \see io_pool_high_water(size_t)
+   */
+  std::chrono::milliseconds io_pool_idle_timeout () const noexcept
+  {
+    return std::chrono::milliseconds{
+      impl_->io_pool_idle_timeout.load(std::memory_order_relaxed)
+    };
+  }
+
+
+  /**
+   * Set how long pool allocation block must stay free before it is released
+   * (default 60s).
+   * \see io_pool_high_water(size_t)
+   */
+  void io_pool_idle_timeout (const std::chrono::milliseconds &timeout) noexcept
+  {
+    impl_->io_pool_idle_timeout.store(timeout.count(),
+      std::memory_order_relaxed
+    );
+  }
+
+
+  /**
+   * Memory allocation policy for I/O operation pool blocks:
+   *   - huge_pages: \c transparent advises kernel to back blocks with
+   *     transparent huge pages, \c reserved allocates blocks from reserved
+   *     huge pages (falling back to \c transparent if none are available)
+   *   - lock: lock blocks into memory (best effort, subject to
+   *     \c RLIMIT_MEMLOCK)
+   *   - numa_local: prefer NUMA node of CPU where block is allocated, i.e.
+   *     with completion_queue_t::pin_thread(), node of thread's CPU
+   *
+   * Policy is supported only on Linux and ignored elsewhere.
+   */
+  using io_pool_policy_t = __bits::io_pool_policy_t;
+
+
+  /**
+   * Return current pool memory allocation policy.
+   * \see io_pool_policy(const io_pool_policy_t &)
+   */
+  io_pool_policy_t io_pool_policy () const noexcept
+  {
+    std::lock_guard lock(impl_->io_pool_mutex);
+    return impl_->io_pool_policy;
+  }
+
+
+  /**
+   * Set memory allocation \a policy for pool blocks allocated from now on.
+   * Already allocated blocks are not affected.
+   */
+  void io_pool_policy (const io_pool_policy_t &policy) noexcept
+  {
+    std::lock_guard lock(impl_->io_pool_mutex);
+    impl_->io_pool_policy = policy;
+  }
+
+
+  /**
+   * Counters of service: completion_queue_t::stats_t counters summed over
+   * all queues of this service (including already destroyed ones) and
+   *   - io_pool_grows: number of pool blocks allocated
+   *   - io_pool_trims: number of pool blocks released back to OS
+   */
+  using stats_t = __bits::service_stats_t;
+
+
+  /**
+   * Return snapshot of service counters. Per-queue counters are aggregated
+   * on call, i.e. collecting them does not slow down I/O threads.
+   */
+  stats_t stats () const noexcept
+  {
+    return impl_->stats();
+  }
+
+
   /**
    * Allocate new I/O operation with associated \a context.
    */
@@ -86,6 +249,163 @@ public:
   }
 
 
+  /**
+   * Allocate new I/O operation with associated \a context and data area of
+   * at least \a size_hint bytes. I/O operations are pooled in size classes
+   * (see io_t) and smallest class fitting \a size_hint is used.
+   *
+   * \throw std::logic_error if \a size_hint is bigger than largest size
+   * class (64kB)
+   */
+  template <typename Context>
+  io_ptr make_io (size_t size_hint, Context *context)
+  {
+    auto io = reinterpret_cast<io_t *>(
+      impl_->make_io(__bits::io_t::size_class_for(size_hint))
+    );
+    io->context<Context>(context);
+    return io_ptr{io};
+  }
+
+
+  /**
+   * Allocate new I/O operation with data area of at least \a size_hint bytes.
+   * \see make_io(size_t, Context *)
+   */
+  io_ptr make_io (size_t size_hint)
+  {
+    return make_io<std::nullptr_t>(size_hint, nullptr);
+  }
+
+
+  /**
+   * Allocate new I/O operation with data area of at least \a size_hint bytes
+   * or return nullptr if pool has reached io_pool_limit().
+   * \see make_io(size_t, Context *)
+   */
+  io_ptr try_make_io (size_t size_hint)
+  {
+    auto io = reinterpret_cast<io_t *>(
+      impl_->try_make_io(&impl_->completed_list,
+        __bits::io_t::size_class_for(size_hint)
+      )
+    );
+    if (io)
+    {
+      io->context<std::nullptr_t>(nullptr);
+    }
+    return io_ptr{io};
+  }
+
+
+  /**
+   * Allocate new I/O operation or return nullptr if pool has reached
+   * io_pool_limit().
+   */
+  io_ptr try_make_io ()
+  {
+    auto io = reinterpret_cast<io_t *>(
+      impl_->try_make_io(&impl_->completed_list,
+        __bits::io_t::default_size_class
+      )
+    );
+    if (io)
+    {
+      io->context<std::nullptr_t>(nullptr);
+    }
+    return io_ptr{io};
+  }
+
+
+  /**
+   * Allocate new I/O operation with data area of at least \a size_hint bytes.
+   * If pool has reached io_pool_limit(), wait up to \a timeout for some
+   * I/O operation of same size class to be released. Returns nullptr on
+   * timeout.
+   */
+  template <typename Rep, typename Period>
+  io_ptr try_make_io_for (const std::chrono::duration<Rep, Period> &timeout,
+    size_t size_hint)
+  {
+    auto io = reinterpret_cast<io_t *>(
+      impl_->try_make_io_for(&impl_->completed_list,
+        __bits::io_t::size_class_for(size_hint),
+        std::chrono::ceil<std::chrono::milliseconds>(timeout)
+      )
+    );
+    if (io)
+    {
+      io->context<std::nullptr_t>(nullptr);
+    }
+    return io_ptr{io};
+  }
+
+
+  /**
+   * Allocate new I/O operation, waiting up to \a timeout if pool has reached
+   * io_pool_limit().
+   * \see try_make_io_for(const std::chrono::duration<Rep, Period> &, size_t)
+   */
+  template <typename Rep, typename Period>
+  io_ptr try_make_io_for (const std::chrono::duration<Rep, Period> &timeout)
+  {
+    auto io = reinterpret_cast<io_t *>(
+      impl_->try_make_io_for(&impl_->completed_list,
+        __bits::io_t::default_size_class,
+        std::chrono::ceil<std::chrono::milliseconds>(timeout)
+      )
+    );
+    if (io)
+    {
+      io->context<std::nullptr_t>(nullptr);
+    }
+    return io_ptr{io};
+  }
+
+
+  /**
+   * start_timer() result type
+   */
+  struct timer_t
+  {
+    /// Requested expiration time
+    std::chrono::steady_clock::time_point deadline;
+  };
+
+
+  /**
+   * Start timer using \a io that completes on or after \a deadline. Expired
+   * timer is returned through completion queue like any other I/O operation
+   * (with result type timer_t). If \a deadline is already passed, \a io is
+   * completed immediately.
+   *
+   * Timers are kept in hierarchical timing wheel with 1ms resolution and
+   * expired during completion_queue_t::wait() (which waits no longer than
+   * until next timer expiration).
+   */
+  void start_timer (io_ptr &&io,
+    const std::chrono::steady_clock::time_point &deadline) noexcept
+  {
+    io->prepare<timer_t>()->deadline = deadline;
+    impl_->start_timer(
+      reinterpret_cast<__bits::io_t *>(io.release()),
+      deadline
+    );
+  }
+
+
+  /**
+   * Start timer using \a io that completes after \a delay.
+   * \see start_timer(io_ptr &&, const std::chrono::steady_clock::time_point &)
+   */
+  template <typename Rep, typename Period>
+  void start_timer (io_ptr &&io,
+    const std::chrono::duration<Rep, Period> &delay) noexcept
+  {
+    start_timer(std::move(io), std::chrono::steady_clock::now() + delay);
+  }
+
+
 private:
 
   __bits::service_ptr impl_ = std::make_shared<__bits::service_t>();
@@ -1,6 +1,10 @@
 #include <sal/net/async/service.hpp>
+#include <sal/net/async/completion_queue.hpp>
 #include <sal/net/internet.hpp>
 #include <sal/common.test.hpp>
+#include <cstring>
+#include <future>
+#include <thread>
 
 
 namespace {
@@ -69,4 +73,442 @@ TEST_F(net_async_service, io_pool_size_remains_same_after_exhaustion_and_release
 }
 
 
+TEST_F(net_async_service, io_pool_size_per_size_class)
+{
+  auto small_io = service.make_io(0);
+  auto size_after_small_alloc = service.io_pool_size();
+  EXPECT_LT(0U, size_after_small_alloc);
+
+  // size classes have separate pools
+  auto big_io = service.make_io(65536);
+  auto size_after_big_alloc = service.io_pool_size();
+  EXPECT_LT(size_after_small_alloc, size_after_big_alloc);
+
+  // released io is reused for same size class
+  small_io.reset();
+  big_io.reset();
+  small_io = service.make_io(0);
+  big_io = service.make_io(65536);
+  EXPECT_EQ(size_after_big_alloc, service.io_pool_size());
+}
+
+
+using namespace std::chrono_literals;
+using timer_t = sal::net::async::service_t::timer_t;
+
+
+TEST_F(net_async_service, io_pool_peak_and_free_size)
+{
+  EXPECT_EQ(0U, service.io_pool_peak_size());
+  EXPECT_EQ(0U, service.io_pool_free_size());
+  EXPECT_EQ(0U, service.io_pool_memory());
+
+  auto io = service.make_io();
+  auto size = service.io_pool_size();
+  EXPECT_EQ(size, service.io_pool_peak_size());
+  EXPECT_EQ(size - 1, service.io_pool_free_size());
+  EXPECT_LT(0U, service.io_pool_memory());
+
+  io.reset();
+  EXPECT_EQ(size, service.io_pool_free_size());
+  EXPECT_EQ(size, service.io_pool_peak_size());
+}
+
+
+TEST_F(net_async_service, io_pool_limit)
+{
+  EXPECT_EQ((std::numeric_limits<size_t>::max)(), service.io_pool_limit());
+
+  // room for first allocation only
+  auto first = service.make_io();
+  service.io_pool_limit(service.io_pool_memory());
+  EXPECT_EQ(service.io_pool_memory(), service.io_pool_limit());
+
+  std::vector<sal::net::async::io_ptr> io_list;
+  io_list.emplace_back(std::move(first));
+  while (io_list.size() < service.io_pool_size())
+  {
+    io_list.emplace_back(service.make_io());
+  }
+
+  auto size = service.io_pool_size();
+  EXPECT_THROW(service.make_io(), std::bad_alloc);
+  EXPECT_EQ(nullptr, service.try_make_io());
+  EXPECT_EQ(nullptr, service.try_make_io_for(1ms));
+  EXPECT_EQ(size, service.io_pool_size());
+  EXPECT_EQ(0U, service.io_pool_free_size());
+
+  // other size classes are limited as well
+  EXPECT_EQ(nullptr, service.try_make_io(0));
+
+  // released io is reused
+  io_list.pop_back();
+  EXPECT_NE(nullptr, service.try_make_io());
+}
+
+
+TEST_F(net_async_service, io_pool_limit_wait)
+{
+  auto first = service.make_io();
+  service.io_pool_limit(service.io_pool_memory());
+
+  std::vector<sal::net::async::io_ptr> io_list;
+  io_list.emplace_back(std::move(first));
+  while (io_list.size() < service.io_pool_size())
+  {
+    io_list.emplace_back(service.make_io());
+  }
+
+  std::thread releaser([&io_list]
+  {
+    std::this_thread::sleep_for(10ms);
+    io_list.pop_back();
+  });
+  auto io = service.try_make_io_for(5s);
+  releaser.join();
+  EXPECT_NE(nullptr, io);
+}
+
+
+TEST_F(net_async_service, try_make_io_resets_context)
+{
+  // limit pool to first blocks of both used size classes
+  (void)service.make_io();
+  (void)service.make_io(0);
+  service.io_pool_limit(service.io_pool_memory());
+
+  // on return, every pooled io_t has stale context
+  int context = 1;
+  auto release_all_with_context = [&](auto try_make_io)
+  {
+    std::vector<sal::net::async::io_ptr> io_list;
+    while (auto io = try_make_io())
+    {
+      io->context(&context);
+      io_list.emplace_back(std::move(io));
+    }
+    EXPECT_FALSE(io_list.empty());
+  };
+
+  auto try_make_io = [this]
+  {
+    return service.try_make_io();
+  };
+  release_all_with_context(try_make_io);
+  auto io = try_make_io();
+  ASSERT_NE(nullptr, io);
+  EXPECT_EQ(nullptr, io->context<int>());
+  io.reset();
+
+  auto try_make_io_size = [this]
+  {
+    return service.try_make_io(0);
+  };
+  release_all_with_context(try_make_io_size);
+  io = try_make_io_size();
+  ASSERT_NE(nullptr, io);
+  EXPECT_EQ(nullptr, io->context<int>());
+  io.reset();
+
+  auto try_make_io_for = [this]
+  {
+    return service.try_make_io_for(1ms);
+  };
+  release_all_with_context(try_make_io_for);
+  io = try_make_io_for();
+  ASSERT_NE(nullptr, io);
+  EXPECT_EQ(nullptr, io->context<int>());
+  io.reset();
+
+  auto try_make_io_for_size = [this]
+  {
+    return service.try_make_io_for(1ms, 0);
+  };
+  release_all_with_context(try_make_io_for_size);
+  io = try_make_io_for_size();
+  ASSERT_NE(nullptr, io);
+  EXPECT_EQ(nullptr, io->context<int>());
+}
+
+
+TEST_F(net_async_service, io_pool_limit_other_thread_cache)
+{
+  auto first = service.make_io();
+  service.io_pool_limit(service.io_pool_memory());
+
+  std::vector<sal::net::async::io_ptr> io_list;
+  io_list.emplace_back(std::move(first));
+  while (io_list.size() < service.io_pool_size())
+  {
+    io_list.emplace_back(service.make_io());
+  }
+  EXPECT_EQ(nullptr, service.try_make_io());
+
+  // io released by thread with own cache are not hidden from others
+  std::promise<void> released, checked;
+  std::thread releaser([&]
+  {
+    sal::net::async::completion_queue_t queue{service};
+    (void)queue.try_get();
+    io_list.clear();
+    released.set_value();
+    checked.get_future().wait();
+  });
+
+  released.get_future().wait();
+  EXPECT_EQ(service.io_pool_size(), service.io_pool_free_size());
+  EXPECT_NE(nullptr, service.try_make_io());
+  checked.set_value();
+  releaser.join();
+}
+
+
+TEST_F(net_async_service, io_pool_limit_wait_other_thread_cache)
+{
+  auto first = service.make_io();
+  service.io_pool_limit(service.io_pool_memory());
+
+  std::vector<sal::net::async::io_ptr> io_list;
+  io_list.emplace_back(std::move(first));
+  while (io_list.size() < service.io_pool_size())
+  {
+    io_list.emplace_back(service.make_io());
+  }
+
+  // waiter is woken up by release instead of polling
+  std::promise<void> checked;
+  std::thread releaser([&]
+  {
+    sal::net::async::completion_queue_t queue{service};
+    (void)queue.try_get();
+    std::this_thread::sleep_for(10ms);
+    io_list.pop_back();
+    checked.get_future().wait();
+  });
+
+  auto start = std::chrono::steady_clock::now();
+  auto io = service.try_make_io_for(5s);
+  EXPECT_GT(start + 1s, std::chrono::steady_clock::now());
+  EXPECT_NE(nullptr, io);
+  checked.set_value();
+  releaser.join();
+}
+
+
+TEST_F(net_async_service, io_pool_high_water)
+{
+  EXPECT_EQ((std::numeric_limits<size_t>::max)(), service.io_pool_high_water());
+  EXPECT_EQ(60s, service.io_pool_idle_timeout());
+
+  service.io_pool_high_water(0);
+  service.io_pool_idle_timeout(0ms);
+  EXPECT_EQ(0U, service.io_pool_high_water());
+  EXPECT_EQ(0ms, service.io_pool_idle_timeout());
+
+  // queue is created after release (otherwise it's thread cache holds io)
+  (void)service.make_io(0);
+  (void)service.make_io();
+  auto peak = service.io_pool_size();
+  EXPECT_LT(0U, peak);
+
+  sal::net::async::completion_queue_t queue{service};
+
+  // first check finds blocks idle, second releases them
+  EXPECT_FALSE(queue.poll());
+  EXPECT_EQ(peak, service.io_pool_size());
+  EXPECT_FALSE(queue.poll());
+  EXPECT_EQ(0U, service.io_pool_size());
+  EXPECT_EQ(0U, service.io_pool_memory());
+  EXPECT_EQ(0U, service.io_pool_free_size());
+  EXPECT_EQ(peak, service.io_pool_peak_size());
+
+  // pool grows again on demand
+  EXPECT_NE(nullptr, service.make_io());
+  EXPECT_LT(0U, service.io_pool_size());
+}
+
+
+TEST_F(net_async_service, io_pool_high_water_keeps_used_blocks)
+{
+  service.io_pool_high_water(0);
+  service.io_pool_idle_timeout(0ms);
+
+  auto io = service.make_io();
+  auto size = service.io_pool_size();
+
+  sal::net::async::completion_queue_t queue{service};
+  EXPECT_FALSE(queue.poll());
+  EXPECT_FALSE(queue.poll());
+  EXPECT_EQ(size, service.io_pool_size());
+}
+
+
+TEST_F(net_async_service, io_pool_policy)
+{
+  auto policy = service.io_pool_policy();
+  EXPECT_EQ(decltype(policy)::huge_pages_t::none, policy.huge_pages);
+  EXPECT_FALSE(policy.lock);
+  EXPECT_FALSE(policy.numa_local);
+
+  policy.huge_pages = decltype(policy)::huge_pages_t::transparent;
+  policy.lock = true;
+  policy.numa_local = true;
+  service.io_pool_policy(policy);
+  EXPECT_EQ(policy.huge_pages, service.io_pool_policy().huge_pages);
+  EXPECT_TRUE(service.io_pool_policy().lock);
+  EXPECT_TRUE(service.io_pool_policy().numa_local);
+
+  auto io = service.make_io();
+  std::memset(io->data(), 0xaa, io->max_size());
+  EXPECT_EQ(std::byte{0xaa}, *io->data());
+}
+
+
+TEST_F(net_async_service, io_pool_policy_reserved_huge_pages)
+{
+  // without reserved huge pages, falls back to transparent ones
+  auto policy = service.io_pool_policy();
+  policy.huge_pages = decltype(policy)::huge_pages_t::reserved;
+  service.io_pool_policy(policy);
+
+  std::vector<sal::net::async::io_ptr> io_list;
+  io_list.emplace_back(service.make_io());
+  io_list.emplace_back(service.make_io(0));
+  for (auto &io: io_list)
+  {
+    std::memset(io->data(), 0xaa, io->max_size());
+    EXPECT_EQ(std::byte{0xaa}, *io->data());
+  }
+}
+
+
+TEST_F(net_async_service, start_timer)
+{
+  sal::net::async::completion_queue_t queue{service};
+
+  auto start = std::chrono::steady_clock::now();
+  service.start_timer(queue.make_io(), 10ms);
+  EXPECT_EQ(nullptr, queue.try_get());
+
+  sal::net::async::io_ptr io;
+  while (!io)
+  {
+    queue.wait();
+    io = queue.try_get();
+  }
+  EXPECT_LE(start + 10ms, std::chrono::steady_clock::now());
+
+  auto result = io->get_if<timer_t>();
+  ASSERT_NE(nullptr, result);
+  EXPECT_LE(start + 10ms, result->deadline);
+}
+
+
+TEST_F(net_async_service, start_timer_expired)
+{
+  sal::net::async::completion_queue_t queue{service};
+
+  auto deadline = std::chrono::steady_clock::now() - 1ms;
+  service.start_timer(queue.make_io(), deadline);
+
+  auto io = queue.try_get();
+  ASSERT_NE(nullptr, io);
+  auto result = io->get_if<timer_t>();
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(deadline, result->deadline);
+}
+
+
+TEST_F(net_async_service, start_timer_order)
+{
+  sal::net::async::completion_queue_t queue{service};
+
+  int context[] = { 30, 10, 20 };
+  for (auto &ms: context)
+  {
+    service.start_timer(queue.make_io(&ms), std::chrono::milliseconds(ms));
+  }
+
+  std::vector<int> expired;
+  while (expired.size() < std::size(context))
+  {
+    if (auto io = queue.try_get())
+    {
+      expired.push_back(*io->context<int>());
+    }
+    else
+    {
+      queue.wait();
+    }
+  }
+  EXPECT_EQ((std::vector<int>{10, 20, 30}), expired);
+}
+
+
+TEST_F(net_async_service, start_timer_wait_for_clamped)
+{
+  sal::net::async::completion_queue_t queue{service};
+  service.start_timer(queue.make_io(), 10ms);
+
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_TRUE(queue.wait_for(10s));
+  EXPECT_GT(start + 5s, std::chrono::steady_clock::now());
+  EXPECT_NE(nullptr, queue.try_get());
+}
+
+
+TEST_F(net_async_service, start_timer_skip_completion_notification)
+{
+  sal::net::async::completion_queue_t queue{service};
+
+  auto io = queue.make_io();
+  io->skip_completion_notification(true);
+  service.start_timer(std::move(io), 1ms);
+
+  std::this_thread::sleep_for(2ms);
+  EXPECT_FALSE(queue.poll());
+  EXPECT_EQ(nullptr, queue.try_get());
+}
+
+
+TEST_F(net_async_service, timer_wheel)
+{
+  using wheel_t = sal::net::async::__bits::timer_wheel_t;
+  const uint64_t ticks[] =
+  {
+    1, 2, 63, 64, 65, 127, 128, 4095, 4096, 4097, 5000,
+    262143, 262144, 300000,
+    wheel_t::max_delay, wheel_t::max_delay + 1, wheel_t::max_delay + 5000,
+  };
+
+  wheel_t wheel;
+  std::vector<sal::net::async::io_ptr> io_list;
+  for (auto tick: ticks)
+  {
+    auto &io = io_list.emplace_back(service.make_io());
+    auto impl = reinterpret_cast<sal::net::async::__bits::io_t *>(io.get());
+    impl->pending.timer.expires = tick;
+    wheel.insert(impl);
+  }
+  EXPECT_EQ(std::size(ticks), wheel.size);
+
+  // advance in uneven steps, checking each timer expires exactly on time
+  std::vector<uint64_t> expired;
+  while (wheel.size)
+  {
+    auto next = wheel.next_tick();
+    ASSERT_LT(wheel.now, next);
+
+    sal::net::async::__bits::io_t::pending_list_t list{};
+    wheel.advance(next, list);
+    while (auto io = list.try_pop())
+    {
+      EXPECT_EQ(wheel.now, io->pending.timer.expires);
+      expired.push_back(io->pending.timer.expires);
+    }
+  }
+  EXPECT_EQ(std::vector<uint64_t>(std::begin(ticks), std::end(ticks)), expired);
+}
+
+
 } // namespace
@@ -93,6 +93,32 @@ TYPED_TEST(net_async_socket_acceptor, start_accept_without_associate) //{{{1
 }
 
 
+TYPED_TEST(net_async_socket_acceptor, start_accept_cancel_all) //{{{1
+{
+  TestFixture::acceptor.start_accept(TestFixture::queue.make_io());
+  TestFixture::acceptor.cancel_all();
+
+  auto io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+
+  std::error_code error;
+  auto result = io->template get_if<acceptor_t::accept_t>(error);
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(std::errc::operation_canceled, error);
+
+  // acceptor is still listening
+  TestFixture::acceptor.start_accept(TestFixture::queue.make_io());
+  socket_t a;
+  a.connect(TestFixture::endpoint);
+
+  io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+  result = io->template get_if<acceptor_t::accept_t>();
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(a.local_endpoint(), result->accepted_socket().remote_endpoint());
+}
+
+
 TYPED_TEST(net_async_socket_acceptor, start_accept_with_context) //{{{1
 {
   int socket_ctx = 1, io_ctx = 2;
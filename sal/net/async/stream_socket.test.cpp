@@ -138,6 +138,27 @@ TYPED_TEST(net_async_stream_socket, start_connect) //{{{1
 }
 
 
+TYPED_TEST(net_async_stream_socket, start_connect_before_deadline) //{{{1
+{
+  TestFixture::socket.start_connect(
+    TestFixture::queue.make_io(),
+    TestFixture::endpoint,
+    std::chrono::steady_clock::now() + 1s
+  );
+
+  auto a = TestFixture::acceptor.accept();
+
+  auto io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+
+  std::error_code error;
+  auto result = io->template get_if<socket_t::connect_t>(error);
+  ASSERT_NE(nullptr, result);
+  EXPECT_TRUE(!error) << error.message();
+  EXPECT_EQ(a.remote_endpoint(), TestFixture::socket.local_endpoint());
+}
+
+
 TYPED_TEST(net_async_stream_socket, start_connect_without_associate) //{{{1
 {
   if (sal::is_debug_build)
@@ -517,6 +538,97 @@ TYPED_TEST(net_async_stream_socket, start_receive_no_sender) //{{{1
 }
 
 
+TYPED_TEST(net_async_stream_socket, start_receive_deadline) //{{{1
+{
+  TestFixture::connect();
+
+  auto start = std::chrono::steady_clock::now();
+  TestFixture::socket.start_receive(TestFixture::queue.make_io(), start + 20ms);
+  EXPECT_FALSE(TestFixture::poll());
+
+  auto io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+  EXPECT_LE(start + 20ms, std::chrono::steady_clock::now());
+
+  std::error_code error;
+  auto result = io->template get_if<socket_t::receive_t>(error);
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(std::errc::timed_out, error);
+
+  // socket remains usable
+  TestFixture::socket.start_receive(std::move(io));
+  TestFixture::send(TestFixture::case_name);
+  io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+  result = io->template get_if<socket_t::receive_t>(error);
+  ASSERT_NE(nullptr, result);
+  EXPECT_TRUE(!error) << error.message();
+  EXPECT_EQ(TestFixture::case_name, to_view(io, result));
+}
+
+
+TYPED_TEST(net_async_stream_socket, start_receive_before_deadline) //{{{1
+{
+  TestFixture::connect();
+
+  auto deadline = std::chrono::steady_clock::now() + 20ms;
+  TestFixture::socket.start_receive(TestFixture::queue.make_io(), deadline);
+  TestFixture::send(TestFixture::case_name);
+
+  auto io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+
+  std::error_code error;
+  auto result = io->template get_if<socket_t::receive_t>(error);
+  ASSERT_NE(nullptr, result);
+  EXPECT_TRUE(!error) << error.message();
+  EXPECT_EQ(TestFixture::case_name, to_view(io, result));
+
+  // expired deadline does not affect completed or restarted operation
+  TestFixture::socket.start_receive(std::move(io));
+  EXPECT_FALSE(TestFixture::queue.wait_for(50ms));
+  EXPECT_FALSE(TestFixture::queue.try_get());
+  EXPECT_LT(deadline, std::chrono::steady_clock::now());
+}
+
+
+TYPED_TEST(net_async_stream_socket, start_receive_deadline_passed) //{{{1
+{
+  TestFixture::connect();
+
+  TestFixture::socket.start_receive(TestFixture::queue.make_io(),
+    std::chrono::steady_clock::now() - 1ms
+  );
+
+  auto io = TestFixture::poll();
+  ASSERT_NE(nullptr, io);
+
+  std::error_code error;
+  auto result = io->template get_if<socket_t::receive_t>(error);
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(std::errc::timed_out, error);
+}
+
+
+TYPED_TEST(net_async_stream_socket, start_receive_deadline_canceled_on_close) //{{{1
+{
+  TestFixture::connect();
+
+  TestFixture::socket.start_receive(TestFixture::queue.make_io(),
+    std::chrono::steady_clock::now() + 1s
+  );
+  TestFixture::socket.close();
+
+  auto io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+
+  std::error_code error;
+  auto result = io->template get_if<socket_t::receive_t>(error);
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(std::errc::operation_canceled, error);
+}
+
+
 TYPED_TEST(net_async_stream_socket, start_receive_peek) //{{{1
 {
   TestFixture::connect();
@@ -662,7 +774,7 @@ TYPED_TEST(net_async_stream_socket, start_receive_before_shutdown) //{{{1
   auto result = io->template get_if<socket_t::receive_t>(error);
   ASSERT_NE(nullptr, result);
 
-#if __sal_os_macos
+#if __sal_os_macos || __sal_io_uring
   EXPECT_EQ(std::errc::broken_pipe, error);
 #else
   EXPECT_EQ(TestFixture::case_name, to_view(io, result));
@@ -806,6 +918,156 @@ TYPED_TEST(net_async_stream_socket, start_send_after_shutdown) //{{{1
 }
 
 
+TYPED_TEST(net_async_stream_socket, start_send_chain) //{{{1
+{
+  TestFixture::connect();
+
+  auto io = TestFixture::queue.make_io(), body = TestFixture::queue.make_io();
+  TestFixture::fill(io, "head-");
+  TestFixture::fill(body, TestFixture::case_name);
+  io->chain(std::move(body));
+  TestFixture::socket.start_send(std::move(io));
+
+  io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+
+  auto result = io->template get_if<socket_t::send_t>();
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(5 + TestFixture::case_name.size(), result->transferred);
+
+  std::string received;
+  while (received.size() < result->transferred)
+  {
+    received += TestFixture::receive();
+  }
+  EXPECT_EQ("head-" + TestFixture::case_name, received);
+}
+
+
+TYPED_TEST(net_async_stream_socket, start_receive_chain) //{{{1
+{
+  TestFixture::connect();
+
+  auto io = TestFixture::queue.make_io();
+  io->resize(5);
+  io->chain(TestFixture::queue.make_io());
+  TestFixture::send("head-" + TestFixture::case_name, true);
+  TestFixture::socket.start_receive(std::move(io));
+
+  io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+
+  auto result = io->template get_if<socket_t::receive_t>();
+  ASSERT_NE(nullptr, result);
+  ASSERT_EQ(5 + TestFixture::case_name.size(), result->transferred);
+  EXPECT_EQ("head-", std::string(reinterpret_cast<char *>(io->data()), 5));
+  EXPECT_EQ(TestFixture::case_name,
+    std::string(
+      reinterpret_cast<char *>(io->next()->data()),
+      result->transferred - 5
+    )
+  );
+}
+
+
+#if __sal_os_linux
+
+
+TYPED_TEST(net_async_stream_socket, start_send_zerocopy) //{{{1
+{
+  TestFixture::connect();
+
+  auto io = TestFixture::queue.make_io();
+  TestFixture::fill(io, TestFixture::case_name);
+  TestFixture::socket.start_send_zerocopy(std::move(io));
+  EXPECT_EQ(TestFixture::case_name, TestFixture::receive());
+
+  io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+
+  auto result = io->template get_if<socket_t::send_t>();
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(TestFixture::case_name.size(), result->transferred);
+}
+
+
+TYPED_TEST(net_async_stream_socket, start_send_zerocopy_many) //{{{1
+{
+  TestFixture::connect();
+
+  constexpr size_t count = 3, size = 65536;
+  for (auto i = 0U;  i != count;  ++i)
+  {
+    auto io = TestFixture::queue.make_io(size);
+    std::memset(io->data(), 'a' + i, io->size());
+    TestFixture::socket.start_send_zerocopy(std::move(io));
+  }
+
+  size_t received = 0;
+  char buf[1024];
+  while (received < count * size)
+  {
+    auto size = TestFixture::test_socket.receive(buf);
+    ASSERT_LT(0U, size);
+    EXPECT_EQ('a' + received / 65536, buf[0]);
+    received += size;
+  }
+  EXPECT_EQ(count * size, received);
+
+  size_t transferred = 0;
+  for (auto i = 0U;  i != count;  ++i)
+  {
+    auto io = TestFixture::wait();
+    ASSERT_NE(nullptr, io);
+    auto result = io->template get_if<socket_t::send_t>();
+    ASSERT_NE(nullptr, result);
+    transferred += result->transferred;
+  }
+  EXPECT_EQ(count * size, transferred);
+}
+
+
+TYPED_TEST(net_async_stream_socket, start_send_zerocopy_close) //{{{1
+{
+  TestFixture::connect();
+
+  auto io = TestFixture::queue.make_io();
+  TestFixture::fill(io, TestFixture::case_name);
+  TestFixture::socket.start_send_zerocopy(std::move(io));
+  TestFixture::socket.close();
+  EXPECT_EQ(TestFixture::case_name, TestFixture::receive());
+
+  // io is returned only after kernel has released it's data
+  io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+
+  std::error_code error;
+  auto result = io->template get_if<socket_t::send_t>(error);
+  ASSERT_NE(nullptr, result);
+  EXPECT_FALSE(error);
+  EXPECT_EQ(TestFixture::case_name.size(), result->transferred);
+}
+
+
+TYPED_TEST(net_async_stream_socket, start_send_zerocopy_not_connected) //{{{1
+{
+  auto io = TestFixture::queue.make_io();
+  TestFixture::fill(io, TestFixture::case_name);
+  TestFixture::socket.start_send_zerocopy(std::move(io));
+
+  io = TestFixture::wait();
+  ASSERT_NE(nullptr, io);
+
+  std::error_code error;
+  auto result = io->template get_if<socket_t::send_t>(error);
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(std::errc::broken_pipe, error);
+}
+
+
+#endif // __sal_os_linux
+
+
 //}}}1
 
 
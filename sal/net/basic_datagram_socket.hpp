@@ -10,6 +10,12 @@
 #include <sal/memory.hpp>
 #include <sal/net/basic_socket.hpp>
 #include <sal/net/async/io.hpp>
+#include <iterator>
+
+#if __sal_os_linux
+  #include <sal/net/ip/address.hpp>
+  #include <chrono>
+#endif
 
 
 __sal_begin
@@ -345,6 +351,9 @@ public:
 
   /**
    * Asynchronously start receive_from() operation using \a io with \a flags.
+   *
+   * \note With io_uring, operation is canceled if starting thread exits
+   * before it completes (see associate()).
    */
   void start_receive_from (async::io_ptr &&io, socket_base_t::message_flags_t flags)
     noexcept(!is_debug_build)
@@ -371,6 +380,97 @@ public:
   }
 
 
+  /**
+   * Asynchronously start receive_from() operation using \a io with \a flags
+   * and keep at least \a depth such operations outstanding. Whenever one
+   * completes, library starts new receive_from() (using io_t with same size
+   * class and context as \a io) before completed one is returned to
+   * application. Completions are reported with result type receive_from_t
+   * like with start_receive_from().
+   *
+   * If bursts of received datagrams use up all outstanding receives, number
+   * of these is doubled up to \a max_depth. If bursts use less than half of
+   * them for a while, number is halved down to \a depth again.
+   *
+   * Pool is stopped by cancel_all(). \a io must not be chained.
+   */
+  void start_receive_from_pool (async::io_ptr &&io,
+    size_t depth,
+    size_t max_depth,
+    socket_base_t::message_flags_t flags) noexcept(!is_debug_build)
+  {
+    auto result = io->prepare<receive_from_t>();
+    result->flags = flags;
+    sal_check_ptr(base_t::async_)->start_receive_from_pool(
+      reinterpret_cast<async::__bits::io_t *>(io.release()),
+      result->remote_endpoint.data(),
+      result->remote_endpoint.capacity(),
+      &result->transferred,
+      &result->flags,
+      depth,
+      max_depth
+    );
+  }
+
+
+  /**
+   * Asynchronously start receive_from_pool() operations using \a io with
+   * default flags.
+   */
+  void start_receive_from_pool (async::io_ptr &&io,
+    size_t depth,
+    size_t max_depth) noexcept(!is_debug_build)
+  {
+    start_receive_from_pool(std::move(io), depth, max_depth, {});
+  }
+
+
+  /**
+   * Asynchronously start receive_from() operations using \a count handles
+   * from array \a io with \a flags. Each started operation completes
+   * separately with result type receive_from_t. On Linux, pending operations
+   * started together are finished with single recvmmsg() call (on other
+   * platforms, this is same as starting each operation separately).
+   */
+  void start_receive_from_batch (async::io_ptr *io, size_t count,
+    socket_base_t::message_flags_t flags) noexcept(!is_debug_build)
+  {
+    auto &handler = *sal_check_ptr(base_t::async_);
+    async::__bits::io_t *batch[async::__bits::handler_t::max_batch_size];
+
+    while (count)
+    {
+      size_t batch_size = 0;
+      for (/**/;  count && batch_size != std::size(batch);  --count, ++io)
+      {
+        auto result = (*io)->prepare<receive_from_t>();
+        result->flags = flags;
+        auto impl = reinterpret_cast<async::__bits::io_t *>(io->release());
+        impl->setup_receive_from(
+          result->remote_endpoint.data(),
+          result->remote_endpoint.capacity(),
+          &result->transferred,
+          &result->flags
+        );
+        batch[batch_size++] = impl;
+      }
+      handler.start_receive_from_batch(batch, batch_size);
+    }
+  }
+
+
+  /**
+   * Asynchronously start receive_from() operations using \a count handles
+   * from array \a io with default flags.
+   * \see start_receive_from_batch(async::io_ptr *, size_t, socket_base_t::message_flags_t)
+   */
+  void start_receive_from_batch (async::io_ptr *io, size_t count)
+    noexcept(!is_debug_build)
+  {
+    start_receive_from_batch(io, count, {});
+  }
+
+
   /**
    * start_receive() result type
    */
@@ -386,6 +486,9 @@ public:
 
   /**
    * Asynchronously start receive() operation using \a io with \a flags.
+   *
+   * \note With io_uring, operation is canceled if starting thread exits
+   * before it completes (see associate()).
    */
   void start_receive (async::io_ptr &&io, socket_base_t::message_flags_t flags)
     noexcept(!is_debug_build)
@@ -405,7 +508,41 @@ public:
    */
   void start_receive (async::io_ptr &&io) noexcept(!is_debug_build)
   {
-    start_receive(std::move(io), {});
+    start_receive(std::move(io), socket_base_t::message_flags_t{});
+  }
+
+
+  /**
+   * Asynchronously start receive() operation using \a io with \a flags. If
+   * operation has not completed by \a deadline, it is canceled and \a io is
+   * completed with std::errc::timed_out.
+   */
+  void start_receive (async::io_ptr &&io,
+      socket_base_t::message_flags_t flags,
+      const std::chrono::steady_clock::time_point &deadline)
+    noexcept(!is_debug_build)
+  {
+    auto result = io->prepare<receive_t>();
+    result->flags = flags;
+    auto async = sal_check_ptr(base_t::async_);
+    auto io_impl = reinterpret_cast<async::__bits::io_t *>(io.release());
+    if (async->start_deadline(io_impl, deadline))
+    {
+      async->start_receive(io_impl, &result->transferred, &result->flags);
+    }
+  }
+
+
+  /**
+   * Asynchronously start receive() operation using \a io with default flags
+   * and \a deadline.
+   * \see start_receive(async::io_ptr &&, socket_base_t::message_flags_t, const std::chrono::steady_clock::time_point &)
+   */
+  void start_receive (async::io_ptr &&io,
+      const std::chrono::steady_clock::time_point &deadline)
+    noexcept(!is_debug_build)
+  {
+    start_receive(std::move(io), socket_base_t::message_flags_t{}, deadline);
   }
 
 
@@ -422,6 +559,9 @@ public:
   /**
    * Asynchronously start send_to() operation using \a io with \a flags.
    * Destination is \a remote_endpoint.
+   *
+   * \note With io_uring, operation is canceled if starting thread exits
+   * before it completes (see associate()).
    */
   void start_send_to (async::io_ptr &&io,
     const endpoint_t &remote_endpoint,
@@ -449,6 +589,256 @@ public:
   }
 
 
+  /**
+   * Asynchronously start send_to() operations using \a count handles from
+   * array \a io with \a flags. Destination for all is \a remote_endpoint.
+   * Each started operation completes separately with result type send_to_t.
+   * On Linux, pending operations started together are finished with single
+   * sendmmsg() call (on other platforms, this is same as starting each
+   * operation separately).
+   */
+  void start_send_to_batch (async::io_ptr *io, size_t count,
+    const endpoint_t &remote_endpoint,
+    socket_base_t::message_flags_t flags) noexcept(!is_debug_build)
+  {
+    auto &handler = *sal_check_ptr(base_t::async_);
+    async::__bits::io_t *batch[async::__bits::handler_t::max_batch_size];
+
+    while (count)
+    {
+      size_t batch_size = 0;
+      for (/**/;  count && batch_size != std::size(batch);  --count, ++io)
+      {
+        auto result = (*io)->prepare<send_to_t>();
+        auto impl = reinterpret_cast<async::__bits::io_t *>(io->release());
+        impl->setup_send_to(
+          remote_endpoint.data(),
+          remote_endpoint.size(),
+          &result->transferred,
+          flags
+        );
+        batch[batch_size++] = impl;
+      }
+      handler.start_send_to_batch(batch, batch_size);
+    }
+  }
+
+
+  /**
+   * Asynchronously start send_to() operations using \a count handles from
+   * array \a io with default flags. Destination for all is
+   * \a remote_endpoint.
+   */
+  void start_send_to_batch (async::io_ptr *io, size_t count,
+    const endpoint_t &remote_endpoint) noexcept(!is_debug_build)
+  {
+    start_send_to_batch(io, count, remote_endpoint, {});
+  }
+
+
+#if __sal_os_linux
+
+  /**
+   * start_receive_from_segmented() result type
+   */
+  struct receive_from_segmented_t
+  {
+    /// Number of bytes transferred
+    size_t transferred;
+
+    /// Sender endpoint
+    endpoint_t remote_endpoint;
+
+    /// Message receiving flags
+    socket_base_t::message_flags_t flags;
+
+    /// Size of each datagram coalesced into received data (last may be
+    /// shorter). If data was not coalesced, it is equal to transferred.
+    size_t segment_size;
+  };
+
+
+  /**
+   * Asynchronously start receive_from() operation using \a io with \a flags.
+   * If UDP generic receive offload is enabled for socket (see
+   * sal::net::udp_gro()), OS may coalesce multiple datagrams from same sender
+   * into \a io data area. On completion, receive_from_segmented_t::segment_size
+   * holds size of each coalesced datagram. If coalesced data does not fit into
+   * \a io, it is truncated and operation completes with
+   * std::errc::message_size.
+   */
+  void start_receive_from_segmented (async::io_ptr &&io,
+    socket_base_t::message_flags_t flags) noexcept(!is_debug_build)
+  {
+    auto result = io->prepare<receive_from_segmented_t>();
+    result->flags = flags;
+    sal_check_ptr(base_t::async_)->start_receive_from_segmented(
+      reinterpret_cast<async::__bits::io_t *>(io.release()),
+      result->remote_endpoint.data(),
+      result->remote_endpoint.capacity(),
+      &result->transferred,
+      &result->flags,
+      &result->segment_size
+    );
+  }
+
+
+  /**
+   * Asynchronously start receive_from_segmented() operation using \a io with
+   * default flags.
+   */
+  void start_receive_from_segmented (async::io_ptr &&io)
+    noexcept(!is_debug_build)
+  {
+    start_receive_from_segmented(std::move(io), {});
+  }
+
+
+  /**
+   * start_receive_from_with_info() result type
+   */
+  struct receive_from_with_info_t
+  {
+    /// Number of bytes transferred
+    size_t transferred;
+
+    /// Sender endpoint
+    endpoint_t remote_endpoint;
+
+    /// Message receiving flags
+    socket_base_t::message_flags_t flags;
+
+    /// Index of interface datagram was received on (0 if not known)
+    uint32_t interface_index;
+
+    /// Kernel receive timestamp (epoch if not known)
+    std::chrono::system_clock::time_point timestamp;
+
+    /// Destination address of datagram (unspecified if not known)
+    ip::address_t local_address;
+  };
+
+
+  /**
+   * Asynchronously start receive_from() operation using \a io with \a flags.
+   * In addition to sender, on completion receive_from_with_info_t holds
+   * kernel receive timestamp, receiving interface index and datagram's
+   * destination address (useful for sockets bound to wildcard address).
+   * Ancillary data is enabled on socket with first such operation.
+   */
+  void start_receive_from_with_info (async::io_ptr &&io,
+    socket_base_t::message_flags_t flags) noexcept(!is_debug_build)
+  {
+    auto result = io->prepare<receive_from_with_info_t>();
+    result->flags = flags;
+    sal_check_ptr(base_t::async_)->start_receive_from_with_info(
+      reinterpret_cast<async::__bits::io_t *>(io.release()),
+      result->remote_endpoint.data(),
+      result->remote_endpoint.capacity(),
+      &result->transferred,
+      &result->flags,
+      &result->interface_index,
+      &result->timestamp,
+      &result->local_address
+    );
+  }
+
+
+  /**
+   * Asynchronously start receive_from_with_info() operation using \a io
+   * with default flags.
+   */
+  void start_receive_from_with_info (async::io_ptr &&io)
+    noexcept(!is_debug_build)
+  {
+    start_receive_from_with_info(std::move(io), {});
+  }
+
+
+  /**
+   * start_send_to_segmented() result type
+   */
+  struct send_to_segmented_t
+  {
+    /// Number of bytes transferred
+    size_t transferred;
+  };
+
+
+  /**
+   * Asynchronously start send_to() operation using \a io with \a flags,
+   * letting OS (or NIC) split \a io data into datagrams of \a segment_size
+   * bytes (last may be shorter) using UDP generic segmentation offload.
+   * Destination is \a remote_endpoint.
+   */
+  void start_send_to_segmented (async::io_ptr &&io,
+    const endpoint_t &remote_endpoint,
+    size_t segment_size,
+    socket_base_t::message_flags_t flags) noexcept(!is_debug_build)
+  {
+    auto result = io->prepare<send_to_segmented_t>();
+    sal_check_ptr(base_t::async_)->start_send_to_segmented(
+      reinterpret_cast<async::__bits::io_t *>(io.release()),
+      remote_endpoint.data(),
+      remote_endpoint.size(),
+      segment_size,
+      &result->transferred,
+      flags
+    );
+  }
+
+
+  /**
+   * Asynchronously start send_to_segmented() operation using \a io with
+   * default flags.
+   */
+  void start_send_to_segmented (async::io_ptr &&io,
+    const endpoint_t &remote_endpoint,
+    size_t segment_size) noexcept(!is_debug_build)
+  {
+    start_send_to_segmented(std::move(io), remote_endpoint, segment_size, {});
+  }
+
+
+  /**
+   * Asynchronously start send_to() operation using \a io with \a flags
+   * without copying \a io data into kernel (MSG_ZEROCOPY). On first use,
+   * SO_ZEROCOPY is enabled for socket (if it fails, regular send_to is done
+   * instead). Destination is \a remote_endpoint.
+   *
+   * Operation completes with send_to_t result only after kernel notifies it
+   * has released \a io data (also if socket is closed meanwhile). It is
+   * worth using only for large payloads (see
+   * async::service_t::make_io(size_t)).
+   */
+  void start_send_to_zerocopy (async::io_ptr &&io,
+    const endpoint_t &remote_endpoint,
+    socket_base_t::message_flags_t flags) noexcept(!is_debug_build)
+  {
+    auto result = io->prepare<send_to_t>();
+    sal_check_ptr(base_t::async_)->start_send_zerocopy(
+      reinterpret_cast<async::__bits::io_t *>(io.release()),
+      remote_endpoint.data(),
+      remote_endpoint.size(),
+      &result->transferred,
+      flags
+    );
+  }
+
+
+  /**
+   * Asynchronously start send_to_zerocopy() operation using \a io with
+   * default flags.
+   */
+  void start_send_to_zerocopy (async::io_ptr &&io,
+    const endpoint_t &remote_endpoint) noexcept(!is_debug_build)
+  {
+    start_send_to_zerocopy(std::move(io), remote_endpoint, {});
+  }
+
+#endif // __sal_os_linux
+
+
   /**
    * start_send() result type
    */
@@ -461,6 +851,9 @@ public:
 
   /**
    * Asynchronously start send() operation using \a io with \a flags.
+   *
+   * \note With io_uring, operation is canceled if starting thread exits
+   * before it completes (see associate()).
    */
   void start_send (async::io_ptr &&io, socket_base_t::message_flags_t flags)
     noexcept(!is_debug_build)
@@ -10,6 +10,7 @@
 #include <sal/net/error.hpp>
 #include <sal/net/socket_base.hpp>
 #include <sal/net/socket_options.hpp>
+#include <sal/net/async/completion_queue.hpp>
 #include <sal/net/async/service.hpp>
 
 
@@ -128,8 +129,10 @@ public:
   {
     if (is_open())
     {
-      socket_.close(error);
+      // release handler first: it may need valid handle to cancel pending
+      // asynchronous operations
       async_.reset();
+      socket_.close(error);
     }
     else
     {
@@ -416,6 +419,14 @@ public:
    * undefined behaviour. Once socket is associated with specific service, it
    * will remain so until closed.
    *
+   * \note With io_uring (Linux, built with sal_io_uring), kernel ties pending
+   * operation to thread that started it. If that thread exits before
+   * operation completes, operation is returned with
+   * std::errc::operation_canceled (at thread exit or once it would have
+   * completed, depending on kernel version) and received data remains in
+   * socket. Start operations from threads that outlive them (i.e. worker
+   * threads that wait on completion queue).
+   *
    * On failure, set \a error.
    */
   void associate (async::service_t &service, std::error_code &error) noexcept
@@ -445,6 +456,89 @@ public:
   }
 
 
+  /**
+   * Associate this socket with \a queue's service and bind it's readiness
+   * events to \a queue. If \a queue has own reactor, only thread waiting on
+   * \a queue drains this socket's events. Otherwise it is same as
+   * associate(async::service_t &, std::error_code &).
+   *
+   * On failure, set \a error.
+   */
+  void associate (async::completion_queue_t &queue, std::error_code &error)
+    noexcept
+  {
+    if (!is_open())
+    {
+      error = std::make_error_code(std::errc::bad_file_descriptor);
+    }
+    else if (async_)
+    {
+      error = make_error_code(socket_errc::already_associated);
+    }
+    else
+    {
+      async_ = async::__bits::make_handler(queue.impl_, socket_, error);
+    }
+  }
+
+
+  /**
+   * \see associate (async::completion_queue_t &, std::error_code &)
+   * \throws std::system_error on failure
+   */
+  void associate (async::completion_queue_t &queue)
+  {
+    associate(queue, throw_on_error("basic_socket::associate"));
+  }
+
+
+  /**
+   * Cancel pending asynchronous operation \a io started on this socket.
+   * Canceled operation is completed with std::errc::operation_canceled
+   * (socket context is not available for it). If \a io has already
+   * completed, this method does nothing. Unlike close(), socket remains open
+   * and other pending operations continue.
+   */
+  void cancel (const async::io_t *io) noexcept(!is_debug_build)
+  {
+    sal_check_ptr(async_)->cancel(
+      reinterpret_cast<const async::__bits::io_t *>(io)
+    );
+  }
+
+
+  /**
+   * Cancel all pending asynchronous operations started on this socket.
+   * \see cancel (const async::io_t *)
+   */
+  void cancel_all () noexcept(!is_debug_build)
+  {
+    sal_check_ptr(async_)->cancel_all();
+  }
+
+
+  /**
+   * Asynchronous operation counters of socket:
+   *   - started: operations started
+   *   - completed: operations completed (including canceled ones; with
+   *     io_uring, when their completions are reaped)
+   *   - would_block: attempts to finish pending operation that had to wait
+   *     for readiness (epoll/kqueue only)
+   *
+   * Number of pending operations is started - completed.
+   */
+  using async_stats_t = async::__bits::handler_stats_t;
+
+
+  /**
+   * Return snapshot of socket's asynchronous operation counters.
+   */
+  async_stats_t async_stats () const noexcept(!is_debug_build)
+  {
+    return sal_check_ptr(async_)->stats();
+  }
+
+
   /**
    * Set application specific context for socket's asynchronous operations. On
    * asynchronous I/O operation completion it is passed back to application
@@ -503,7 +597,12 @@ protected:
    * If this is_open(), close() it and then move all internal resource from
    * \a that to \a this.
    */
-  basic_socket_t &operator= (basic_socket_t &&that) noexcept = default;
+  basic_socket_t &operator= (basic_socket_t &&that) noexcept
+  {
+    async_ = std::move(that.async_);
+    socket_ = std::move(that.socket_);
+    return *this;
+  }
 
 
   /**
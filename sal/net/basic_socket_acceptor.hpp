@@ -10,6 +10,8 @@
 #include <sal/net/error.hpp>
 #include <sal/net/socket_base.hpp>
 #include <sal/net/socket_options.hpp>
+#include <sal/net/async/completion_queue.hpp>
+#include <sal/net/async/service.hpp>
 
 
 __sal_begin
@@ -83,6 +85,26 @@ public:
   }
 
 
+  /**
+   * Move ownership of \a that handle to \a this and invalidate \a that.
+   */
+  basic_socket_acceptor_t (basic_socket_acceptor_t &&that) noexcept = default;
+
+
+  /**
+   * If this is_open(), close() it and then move all internal resource from
+   * \a that to \a this.
+   */
+  basic_socket_acceptor_t &operator= (basic_socket_acceptor_t &&that) noexcept
+  {
+    async_ = std::move(that.async_);
+    socket_ = std::move(that.socket_);
+    family_ = that.family_;
+    enable_connection_aborted_ = that.enable_connection_aborted_;
+    return *this;
+  }
+
+
   /**
    * Return native representation of this socket.
    */
@@ -169,8 +191,10 @@ public:
   {
     if (is_open())
     {
-      socket_.close(error);
+      // release handler first: it may need valid handle to cancel pending
+      // asynchronous operations
       async_.reset();
+      socket_.close(error);
     }
     else
     {
@@ -485,6 +509,67 @@ public:
   }
 
 
+  /**
+   * Associate this socket with \a queue's service and bind it's readiness
+   * events to \a queue. If \a queue has own reactor, only thread waiting on
+   * \a queue drains this socket's events. Otherwise it is same as
+   * associate(async::service_t &, std::error_code &).
+   *
+   * On failure, set \a error.
+   */
+  void associate (async::completion_queue_t &queue, std::error_code &error)
+    noexcept
+  {
+    if (!is_open())
+    {
+      error = std::make_error_code(std::errc::bad_file_descriptor);
+    }
+    else if (async_)
+    {
+      error = make_error_code(socket_errc::already_associated);
+    }
+    else
+    {
+      async_ = async::__bits::make_handler(queue.impl_, socket_, error);
+    }
+  }
+
+
+  /**
+   * \see associate (async::completion_queue_t &, std::error_code &)
+   * \throws std::system_error on failure
+   */
+  void associate (async::completion_queue_t &queue)
+  {
+    associate(queue, throw_on_error("basic_socket_acceptor::associate"));
+  }
+
+
+  /**
+   * Cancel pending asynchronous operation \a io started on this acceptor.
+   * Canceled operation is completed with std::errc::operation_canceled
+   * (socket context is not available for it). If \a io has already
+   * completed, this method does nothing. Unlike close(), acceptor remains
+   * listening and other pending operations continue.
+   */
+  void cancel (const async::io_t *io) noexcept(!is_debug_build)
+  {
+    sal_check_ptr(async_)->cancel(
+      reinterpret_cast<const async::__bits::io_t *>(io)
+    );
+  }
+
+
+  /**
+   * Cancel all pending asynchronous operations started on this acceptor.
+   * \see cancel (const async::io_t *)
+   */
+  void cancel_all () noexcept(!is_debug_build)
+  {
+    sal_check_ptr(async_)->cancel_all();
+  }
+
+
   /**
    * Set application specific context for socket's asynchronous operations. On
    * asynchronous I/O operation completion it is passed back to application
@@ -555,6 +640,9 @@ public:
 
   /**
    * Asynchronously start accept().
+   *
+   * \note With io_uring, operation is canceled if starting thread exits
+   * before it completes (see associate()).
    */
   void start_accept (async::io_ptr &&io) noexcept(!is_debug_build)
   {
@@ -193,6 +193,9 @@ public:
 
   /**
    * Asynchronously start connect() to \a endpoint using \a io.
+   *
+   * \note With io_uring, operation is canceled if starting thread exits
+   * before it completes (see associate()).
    */
   void start_connect (async::io_ptr &&io, const endpoint_t &endpoint)
     noexcept(!is_debug_build)
@@ -206,6 +209,26 @@ public:
   }
 
 
+  /**
+   * Asynchronously start connect() to \a endpoint using \a io. If connection
+   * is not established by \a deadline, connecting is canceled and \a io is
+   * completed with std::errc::timed_out.
+   */
+  void start_connect (async::io_ptr &&io,
+      const endpoint_t &endpoint,
+      const std::chrono::steady_clock::time_point &deadline)
+    noexcept(!is_debug_build)
+  {
+    (void)io->prepare<connect_t>();
+    auto async = sal_check_ptr(base_t::async_);
+    auto io_impl = reinterpret_cast<async::__bits::io_t *>(io.release());
+    if (async->start_deadline(io_impl, deadline))
+    {
+      async->start_connect(io_impl, endpoint.data(), endpoint.size());
+    }
+  }
+
+
   /**
    * start_receive() result type
    */
@@ -221,6 +244,9 @@ public:
 
   /**
    * Asynchronously start receive() operation using \a io with \a flags.
+   *
+   * \note With io_uring, operation is canceled if starting thread exits
+   * before it completes (see associate()).
    */
   void start_receive (async::io_ptr &&io, socket_base_t::message_flags_t flags)
     noexcept(!is_debug_build)
@@ -240,7 +266,41 @@ public:
    */
   void start_receive (async::io_ptr &&io) noexcept(!is_debug_build)
   {
-    start_receive(std::move(io), {});
+    start_receive(std::move(io), socket_base_t::message_flags_t{});
+  }
+
+
+  /**
+   * Asynchronously start receive() operation using \a io with \a flags. If
+   * operation has not completed by \a deadline, it is canceled and \a io is
+   * completed with std::errc::timed_out.
+   */
+  void start_receive (async::io_ptr &&io,
+      socket_base_t::message_flags_t flags,
+      const std::chrono::steady_clock::time_point &deadline)
+    noexcept(!is_debug_build)
+  {
+    auto result = io->prepare<receive_t>();
+    result->flags = flags;
+    auto async = sal_check_ptr(base_t::async_);
+    auto io_impl = reinterpret_cast<async::__bits::io_t *>(io.release());
+    if (async->start_deadline(io_impl, deadline))
+    {
+      async->start_receive(io_impl, &result->transferred, &result->flags);
+    }
+  }
+
+
+  /**
+   * Asynchronously start receive() operation using \a io with default flags
+   * and \a deadline.
+   * \see start_receive(async::io_ptr &&, socket_base_t::message_flags_t, const std::chrono::steady_clock::time_point &)
+   */
+  void start_receive (async::io_ptr &&io,
+      const std::chrono::steady_clock::time_point &deadline)
+    noexcept(!is_debug_build)
+  {
+    start_receive(std::move(io), socket_base_t::message_flags_t{}, deadline);
   }
 
 
@@ -256,6 +316,9 @@ public:
 
   /**
    * Asynchronously start send() operation using \a io with \a flags.
+   *
+   * \note With io_uring, operation is canceled if starting thread exits
+   * before it completes (see associate()).
    */
   void start_send (async::io_ptr &&io, socket_base_t::message_flags_t flags)
     noexcept(!is_debug_build)
@@ -276,6 +339,44 @@ public:
   {
     start_send(std::move(io), {});
   }
+
+
+#if __sal_os_linux
+
+  /**
+   * Asynchronously start send() operation using \a io with \a flags without
+   * copying \a io data into kernel (MSG_ZEROCOPY). On first use, SO_ZEROCOPY
+   * is enabled for socket (if it fails, regular send is done instead).
+   *
+   * Operation completes with send_t result only after kernel notifies it has
+   * released \a io data (i.e. possibly long after data was queued for
+   * sending, also if socket is closed meanwhile). It is worth using only for
+   * large payloads (10kB+).
+   */
+  void start_send_zerocopy (async::io_ptr &&io,
+    socket_base_t::message_flags_t flags) noexcept(!is_debug_build)
+  {
+    auto result = io->prepare<send_t>();
+    sal_check_ptr(base_t::async_)->start_send_zerocopy(
+      reinterpret_cast<async::__bits::io_t *>(io.release()),
+      nullptr,
+      0,
+      &result->transferred,
+      flags
+    );
+  }
+
+
+  /**
+   * Asynchronously start send_zerocopy() operation using \a io with default
+   * flags.
+   */
+  void start_send_zerocopy (async::io_ptr &&io) noexcept(!is_debug_build)
+  {
+    start_send_zerocopy(std::move(io), {});
+  }
+
+#endif // __sal_os_linux
 };
 
 
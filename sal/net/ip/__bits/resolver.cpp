@@ -0,0 +1,452 @@
+#include <sal/net/ip/__bits/resolver.hpp>
+#include <sal/net/error.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+
+__sal_begin
+
+
+namespace net::ip::__bits {
+
+
+namespace {
+
+
+// lookups are blocking, each concurrent one occupies thread
+constexpr size_t max_threads = 4;
+
+// on insert, expired answers are purged when cache grows beyond this
+constexpr size_t cache_purge_size = 1024;
+
+
+struct query_hash_t
+{
+  size_t operator() (const resolve_query_t &query) const noexcept
+  {
+    std::hash<std::string> hash;
+    return hash(query.host_name)
+      ^ (hash(query.service_name) << 1)
+      ^ (static_cast<size_t>(query.flags) << 2)
+      ^ (static_cast<size_t>(query.family) << 12)
+      ^ (static_cast<size_t>(query.socktype) << 20)
+      ^ (static_cast<size_t>(query.protocol) << 24)
+    ;
+  }
+};
+
+
+struct request_t
+{
+  async::__bits::completion_queue_t *queue;
+  async::__bits::io_t *io;
+  size_t *size;
+  resolve_query_t query;
+};
+
+
+struct answer_t
+{
+  std::chrono::steady_clock::time_point expires{};
+  int gai_error{};
+  std::vector<std::byte> slots{};
+};
+
+
+// negative answers worth caching: name does not exist (vs transient errors)
+bool is_negative (int gai_error) noexcept
+{
+#if defined(EAI_NODATA) && EAI_NODATA != EAI_NONAME
+  if (gai_error == EAI_NODATA)
+  {
+    return true;
+  }
+#endif
+  return gai_error == EAI_NONAME || gai_error == EAI_SERVICE;
+}
+
+
+// copy as many answer slots into io data area as fit there
+void assign (async::__bits::io_t *io, const std::vector<std::byte> &slots)
+  noexcept
+{
+  auto size = (std::min)(
+    slots.size(),
+    io->data_size - io->data_size % resolve_slot_size
+  );
+  io->begin = io->data();
+  io->end = std::uninitialized_copy_n(slots.data(), size, io->begin);
+}
+
+
+void complete (async::__bits::completion_queue_t &queue,
+  async::__bits::io_t *io,
+  size_t *size,
+  int gai_error) noexcept
+{
+  *size = (io->end - io->begin) / resolve_slot_size;
+  io->status.clear();
+  if (gai_error)
+  {
+    io->status.assign(gai_error, resolver_category());
+  }
+  queue.post(io);
+}
+
+
+class resolver_t
+{
+public:
+
+  std::atomic<size_t> cache_hits{}, cache_misses{};
+
+
+  resolver_t () = default;
+
+  resolver_t (const resolver_t &) = delete;
+  resolver_t &operator= (const resolver_t &) = delete;
+
+
+  bool start (request_t &&request);
+  bool try_complete_from_cache (request_t &request) noexcept;
+  void shutdown () noexcept;
+
+
+  void cache_ttl (const std::chrono::milliseconds &positive,
+    const std::chrono::milliseconds &negative) noexcept
+  {
+    std::lock_guard lock(cache_mutex_);
+    positive_ttl_ = positive;
+    negative_ttl_ = negative;
+    if (!positive_ttl_.count() && !negative_ttl_.count())
+    {
+      cache_.clear();
+    }
+  }
+
+
+  void cache_clear () noexcept
+  {
+    std::lock_guard lock(cache_mutex_);
+    cache_.clear();
+  }
+
+
+private:
+
+  std::mutex mutex_{};
+  std::condition_variable cv_{};
+  std::deque<request_t> requests_{};
+  size_t threads_ = 0, idle_ = 0;
+  bool stopping_ = false;
+
+  std::mutex cache_mutex_{};
+  std::chrono::milliseconds positive_ttl_{}, negative_ttl_{};
+  std::unordered_map<resolve_query_t, answer_t, query_hash_t> cache_{};
+
+  void run () noexcept;
+  void resolve (request_t &request) noexcept;
+  void cache (const resolve_query_t &query,
+    int gai_error,
+    std::vector<std::byte> &&slots
+  ) noexcept;
+};
+
+
+// workers are detached (lookup may block for long time) and resolver_t is
+// never destroyed. On process exit, shutdown() drops queued requests and
+// stops workers from posting lookups still in flight: their queues may be
+// already destroyed
+void resolver_t::shutdown () noexcept
+{
+  std::deque<request_t> dropped;
+  {
+    std::lock_guard lock(mutex_);
+    stopping_ = true;
+    dropped.swap(requests_);
+  }
+  cv_.notify_all();
+}
+
+
+// returns false if resolver is already shut down
+bool resolver_t::start (request_t &&request)
+{
+  std::unique_lock lock(mutex_);
+  if (stopping_)
+  {
+    return false;
+  }
+
+  requests_.emplace_back(std::move(request));
+
+  if (!idle_ && threads_ < max_threads)
+  {
+    try
+    {
+      std::thread(&resolver_t::run, this).detach();
+      ++threads_;
+    }
+    catch (...)
+    {
+      if (!threads_)
+      {
+        requests_.pop_back();
+        throw;
+      }
+      // existing threads will get to it
+    }
+  }
+
+  lock.unlock();
+  cv_.notify_one();
+  return true;
+}
+
+
+void resolver_t::run () noexcept
+{
+  std::unique_lock lock(mutex_);
+  for (;;)
+  {
+    ++idle_;
+    cv_.wait(lock, [this] { return stopping_ || !requests_.empty(); });
+    --idle_;
+
+    if (stopping_)
+    {
+      return;
+    }
+
+    auto request = std::move(requests_.front());
+    requests_.pop_front();
+
+    lock.unlock();
+    resolve(request);
+    lock.lock();
+  }
+}
+
+
+void resolver_t::resolve (request_t &request) noexcept
+{
+  auto &query = request.query;
+  auto host_name = query.host_name.empty()
+    ? nullptr
+    : query.host_name.c_str()
+  ;
+  auto service_name = query.service_name.empty()
+    ? nullptr
+    : query.service_name.c_str()
+  ;
+
+  addrinfo hints, *results{};
+  std::memset(&hints, 0, sizeof(hints));
+  hints.ai_flags = query.flags;
+  hints.ai_family = query.family;
+  hints.ai_socktype = query.socktype;
+  hints.ai_protocol = query.protocol;
+
+  auto gai_error = ::getaddrinfo(host_name, service_name, &hints, &results);
+  if (gai_error)
+  {
+    gai_error = to_gai_error(gai_error, host_name, service_name);
+  }
+
+  // whole answer is kept (and cached), each request gets as many entries as
+  // fit into it's io data area
+  std::vector<std::byte> slots;
+  try
+  {
+    for (auto ai = results;  ai;  ai = ai->ai_next)
+    {
+      if (ai->ai_addrlen <= resolve_slot_size)
+      {
+        auto slot = slots.size();
+        slots.resize(slot + resolve_slot_size);
+        std::memcpy(slots.data() + slot, ai->ai_addr, ai->ai_addrlen);
+      }
+    }
+  }
+  catch (...)
+  {
+    slots.clear();
+    gai_error = EAI_MEMORY;
+  }
+  if (results)
+  {
+    ::freeaddrinfo(results);
+  }
+
+  auto io = request.io;
+  assign(io, slots);
+  cache(query, gai_error, std::move(slots));
+
+  // posting is serialized with shutdown(): once it returns, no worker
+  // touches queues anymore
+  std::lock_guard lock(mutex_);
+  if (!stopping_)
+  {
+    complete(*request.queue, io, request.size, gai_error);
+  }
+}
+
+
+bool resolver_t::try_complete_from_cache (request_t &request) noexcept
+{
+  std::unique_lock lock(cache_mutex_);
+  if (!positive_ttl_.count() && !negative_ttl_.count())
+  {
+    return false;
+  }
+
+  auto it = cache_.find(request.query);
+  if (it == cache_.end()
+    || it->second.expires <= std::chrono::steady_clock::now())
+  {
+    cache_misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  auto &answer = it->second;
+  assign(request.io, answer.slots);
+  auto gai_error = answer.gai_error;
+  lock.unlock();
+
+  cache_hits.fetch_add(1, std::memory_order_relaxed);
+  complete(*request.queue, request.io, request.size, gai_error);
+  return true;
+}
+
+
+void resolver_t::cache (const resolve_query_t &query,
+  int gai_error,
+  std::vector<std::byte> &&slots) noexcept
+{
+  std::lock_guard lock(cache_mutex_);
+
+  auto ttl = gai_error ? negative_ttl_ : positive_ttl_;
+  if (!ttl.count() || (gai_error && !is_negative(gai_error)))
+  {
+    return;
+  }
+
+  auto now = std::chrono::steady_clock::now();
+  try
+  {
+    if (cache_.size() >= cache_purge_size)
+    {
+      for (auto it = cache_.begin();  it != cache_.end();  )
+      {
+        it = it->second.expires <= now ? cache_.erase(it) : std::next(it);
+      }
+    }
+
+    auto &answer = cache_[query];
+    answer.expires = now + ttl;
+    answer.gai_error = gai_error;
+    answer.slots = std::move(slots);
+  }
+  catch (...)
+  {
+    // caching is best effort
+    cache_.erase(query);
+  }
+}
+
+
+resolver_t &resolver () noexcept
+{
+  // intentionally never destroyed (see resolver_t::shutdown())
+  alignas(resolver_t) static std::byte storage[sizeof(resolver_t)];
+  static auto &instance = *new(storage) resolver_t;
+  static struct shutdown_t
+  {
+    ~shutdown_t () noexcept
+    {
+      instance.shutdown();
+    }
+  } guard;
+  return instance;
+}
+
+
+} // namespace
+
+
+void start_resolve (async::__bits::completion_queue_t &queue,
+  async::__bits::io_t *io,
+  const char *host_name,
+  const char *service_name,
+  int flags,
+  int family,
+  int socktype,
+  int protocol,
+  size_t *size) noexcept
+{
+  try
+  {
+    request_t request{&queue, io, size,
+      {
+        host_name ? host_name : "",
+        service_name ? service_name : "",
+        flags,
+        family,
+        socktype,
+        protocol,
+      }
+    };
+
+    if (!resolver().try_complete_from_cache(request)
+      && !resolver().start(std::move(request)))
+    {
+      // started during static destruction, after resolver shutdown
+      io->end = io->begin = io->data();
+      complete(queue, io, size, EAI_AGAIN);
+    }
+  }
+  catch (...)
+  {
+    io->end = io->begin = io->data();
+    complete(queue, io, size, EAI_MEMORY);
+  }
+}
+
+
+void resolve_cache_ttl (const std::chrono::milliseconds &positive,
+  const std::chrono::milliseconds &negative) noexcept
+{
+  resolver().cache_ttl(positive, negative);
+}
+
+
+void resolve_cache_clear () noexcept
+{
+  resolver().cache_clear();
+}
+
+
+size_t resolve_cache_hits () noexcept
+{
+  return resolver().cache_hits.load(std::memory_order_relaxed);
+}
+
+
+size_t resolve_cache_misses () noexcept
+{
+  return resolver().cache_misses.load(std::memory_order_relaxed);
+}
+
+
+} // namespace net::ip::__bits
+
+
+__sal_end
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <sal/config.hpp>
+#include <sal/net/ip/__bits/inet.hpp>
+#include <sal/net/async/__bits/async.hpp>
+#include <chrono>
+#include <string>
+
+
+__sal_begin
+
+
+namespace net::ip::__bits {
+
+
+// resolved endpoints are stored in io_t data area as array of
+// sockaddr_storage (same layout as basic_endpoint_t)
+constexpr size_t resolve_slot_size = sizeof(sockaddr_storage);
+
+
+struct resolve_query_t
+{
+  std::string host_name{}, service_name{};
+  int flags{}, family{}, socktype{}, protocol{};
+
+  bool operator== (const resolve_query_t &that) const noexcept
+  {
+    return flags == that.flags
+      && family == that.family
+      && socktype == that.socktype
+      && protocol == that.protocol
+      && host_name == that.host_name
+      && service_name == that.service_name
+    ;
+  }
+};
+
+
+// run getaddrinfo() for query on worker thread (or take answer from cache),
+// store resulting endpoints into io data area, number of those into *size
+// and post io to queue
+void start_resolve (async::__bits::completion_queue_t &queue,
+  async::__bits::io_t *io,
+  const char *host_name,
+  const char *service_name,
+  int flags,
+  int family,
+  int socktype,
+  int protocol,
+  size_t *size
+) noexcept;
+
+
+// zero ttl disables caching of positive or negative answers
+void resolve_cache_ttl (const std::chrono::milliseconds &positive,
+  const std::chrono::milliseconds &negative
+) noexcept;
+
+void resolve_cache_clear () noexcept;
+
+size_t resolve_cache_hits () noexcept;
+size_t resolve_cache_misses () noexcept;
+
+
+} // namespace net::ip::__bits
+
+
+__sal_end
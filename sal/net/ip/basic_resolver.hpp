@@ -8,7 +8,10 @@
 
 #include <sal/config.hpp>
 #include <sal/net/ip/__bits/inet.hpp>
+#include <sal/net/ip/__bits/resolver.hpp>
+#include <sal/net/async/completion_queue.hpp>
 #include <sal/net/error.hpp>
+#include <sal/net/ip/basic_endpoint.hpp>
 #include <sal/net/ip/basic_resolver_entry.hpp>
 #include <sal/net/ip/basic_resolver_results.hpp>
 #include <sal/net/ip/resolver_base.hpp>
@@ -157,10 +160,125 @@ public:
   }
 
 
+  //
+  // start_resolve
+  //
+
+  /**
+   * start_resolve() result type. Resolved endpoints are stored in completed
+   * io_t data area (endpoints not fitting there are dropped, default size
+   * class holds 11 endpoints).
+   */
+  struct resolve_t
+  {
+    /// Number of resolved endpoints
+    size_t size;
+
+    /// Resolved endpoints [endpoints, endpoints + size)
+    const endpoint_t *endpoints;
+
+    /// Return pointer to first resolved endpoint
+    const endpoint_t *begin () const noexcept
+    {
+      return endpoints;
+    }
+
+    /// Return pointer past last resolved endpoint
+    const endpoint_t *end () const noexcept
+    {
+      return endpoints + size;
+    }
+  };
+
+
+  /**
+   * Asynchronously translate \a host_name and/or \a service_name using
+   * specified \a flags. Blocking OS resolver is invoked on small internal
+   * pool of worker threads and completed \a io is returned through \a queue
+   * (with result type resolve_t). On failure, io_t::get_if() returns
+   * resolver error (see resolver_errc).
+   *
+   * If caching is enabled (see resolver_base_t::resolve_cache_ttl()),
+   * repeated queries are answered from cache without involving worker
+   * threads (still returned through \a queue). Cached answer holds all
+   * resolved endpoints, each request receives as many of those as fit into
+   * it's \a io data area.
+   *
+   * \a queue must outlive pending resolve operations. Operations still
+   * pending on process exit (static destruction) are dropped and not
+   * returned through their queues anymore.
+   */
+  void start_resolve (async::completion_queue_t &queue,
+    async::io_ptr &&io,
+    const char *host_name,
+    const char *service_name,
+    flags_t flags = flags_t()) noexcept
+  {
+    start_resolve(queue, std::move(io),
+      host_name,
+      service_name,
+      AF_UNSPEC,
+      socktype_,
+      protocol_,
+      flags
+    );
+  }
+
+
+  /**
+   * Asynchronously translate \a host_name and/or \a service_name using
+   * specified \a flags. Only entries with \a protocol are returned.
+   * \see start_resolve(async::completion_queue_t &, async::io_ptr &&,
+   * const char *, const char *, flags_t)
+   */
+  void start_resolve (async::completion_queue_t &queue,
+    async::io_ptr &&io,
+    const protocol_t &protocol,
+    const char *host_name,
+    const char *service_name,
+    flags_t flags = flags_t()) noexcept
+  {
+    start_resolve(queue, std::move(io),
+      host_name,
+      service_name,
+      protocol.family(),
+      protocol.type(),
+      protocol.protocol(),
+      flags
+    );
+  }
+
+
 private:
 
+  static_assert(sizeof(endpoint_t) == __bits::resolve_slot_size);
+
   const int socktype_ = endpoint_t().protocol().type();
   const int protocol_ = endpoint_t().protocol().protocol();
+
+
+  void start_resolve (async::completion_queue_t &queue,
+    async::io_ptr &&io,
+    const char *host_name,
+    const char *service_name,
+    int family,
+    int socktype,
+    int protocol,
+    flags_t flags) noexcept
+  {
+    auto result = io->prepare<resolve_t>();
+    result->endpoints = reinterpret_cast<const endpoint_t *>(io->head());
+    __bits::start_resolve(queue.impl_,
+      reinterpret_cast<async::__bits::io_t *>(io.release()),
+      host_name,
+      service_name,
+      static_cast<int>(flags),
+      family,
+      socktype,
+      protocol,
+      &result->size
+    );
+  }
 };
 
 
@@ -383,4 +383,63 @@ TEST_P(datagram_socket, send_do_not_route)
 }
 
 
+#if __sal_os_linux && defined(UDP_SEGMENT)
+
+
+TEST_P(datagram_socket, udp_segment)
+{
+  int value{};
+  receiver.get_option(sal::net::udp_segment(&value));
+  EXPECT_EQ(0, value);
+
+  receiver.set_option(sal::net::udp_segment(100));
+  receiver.get_option(sal::net::udp_segment(&value));
+  EXPECT_EQ(100, value);
+}
+
+
+TEST_P(datagram_socket, udp_gro)
+{
+  bool original, value;
+  receiver.get_option(sal::net::udp_gro(&original));
+  receiver.set_option(sal::net::udp_gro(!original));
+  receiver.get_option(sal::net::udp_gro(&value));
+  EXPECT_NE(original, value);
+}
+
+
+#endif // UDP_SEGMENT
+
+
+#if __sal_os_linux && defined(SO_BUSY_POLL)
+
+
+TEST_P(datagram_socket, busy_poll)
+{
+  // lowering doesn't require privileges
+  int value = -1;
+  receiver.set_option(sal::net::busy_poll(0));
+  receiver.get_option(sal::net::busy_poll(&value));
+  EXPECT_EQ(0, value);
+}
+
+
+#if defined(SO_PREFER_BUSY_POLL)
+
+
+TEST_P(datagram_socket, prefer_busy_poll)
+{
+  bool value = true;
+  receiver.set_option(sal::net::prefer_busy_poll(false));
+  receiver.get_option(sal::net::prefer_busy_poll(&value));
+  EXPECT_FALSE(value);
+}
+
+
+#endif // SO_PREFER_BUSY_POLL
+
+
+#endif // SO_BUSY_POLL
+
+
 } // namespace
@@ -1,6 +1,8 @@
 #include <sal/net/ip/tcp.hpp>
 #include <sal/net/ip/udp.hpp>
+#include <sal/net/async/completion_queue.hpp>
 #include <sal/net/common.test.hpp>
+#include <thread>
 
 
 namespace {
@@ -552,4 +554,237 @@ TYPED_TEST(net_ip_resolver, resolve_v6_host_invalid)
 }
 
 
+
+template <typename Protocol>
+struct net_ip_resolver_async
+  : public sal_test::with_type<Protocol>
+{
+  using resolver_t = typename Protocol::resolver_t;
+  using resolve_t = typename resolver_t::resolve_t;
+
+  sal::net::async::service_t service{};
+  sal::net::async::completion_queue_t queue{service};
+  resolver_t resolver{};
+
+
+  void TearDown ()
+  {
+    resolver_t::resolve_cache_ttl(std::chrono::milliseconds::zero(),
+      std::chrono::milliseconds::zero()
+    );
+  }
+
+
+  sal::net::async::io_ptr wait ()
+  {
+    using namespace std::chrono_literals;
+    auto io = queue.try_get();
+    for (auto i = 0;  !io && i < 50;  ++i)
+    {
+      queue.wait_for(100ms);
+      io = queue.try_get();
+    }
+    return io;
+  }
+};
+
+TYPED_TEST_CASE(net_ip_resolver_async,
+  sal_test::protocol_types,
+  sal_test::protocol_names
+);
+
+
+TYPED_TEST(net_ip_resolver_async, start_resolve)
+{
+  this->resolver.start_resolve(this->queue, this->queue.make_io(),
+    "localhost",
+    "echo"
+  );
+
+  auto io = this->wait();
+  ASSERT_NE(nullptr, io);
+
+  std::error_code error;
+  auto result = io->template get_if<typename TestFixture::resolve_t>(error);
+  ASSERT_NE(nullptr, result);
+  ASSERT_TRUE(!error) << error.message();
+  ASSERT_LT(0U, result->size);
+  for (auto &endpoint: *result)
+  {
+    EXPECT_TRUE(endpoint.address().is_loopback());
+    EXPECT_EQ(7U, endpoint.port());
+  }
+}
+
+
+TYPED_TEST(net_ip_resolver_async, start_resolve_protocol)
+{
+  this->resolver.start_resolve(this->queue, this->queue.make_io(),
+    TypeParam::v4,
+    "127.0.0.1",
+    "80",
+    this->resolver.numeric_host | this->resolver.numeric_service
+  );
+
+  auto io = this->wait();
+  ASSERT_NE(nullptr, io);
+
+  auto result = io->template get_if<typename TestFixture::resolve_t>();
+  ASSERT_NE(nullptr, result);
+  ASSERT_EQ(1U, result->size);
+  EXPECT_EQ(
+    typename TypeParam::endpoint_t(sal::net::ip::address_v4_t::loopback, 80),
+    *result->begin()
+  );
+}
+
+
+TYPED_TEST(net_ip_resolver_async, start_resolve_host_invalid)
+{
+  this->resolver.start_resolve(this->queue, this->queue.make_io(),
+    "localhost",
+    nullptr,
+    this->resolver.numeric_host
+  );
+
+  auto io = this->wait();
+  ASSERT_NE(nullptr, io);
+
+  std::error_code error;
+  auto result = io->template get_if<typename TestFixture::resolve_t>(error);
+  ASSERT_NE(nullptr, result);
+  EXPECT_EQ(sal::net::ip::resolver_errc::host_not_found, error);
+  EXPECT_EQ(0U, result->size);
+
+  EXPECT_THROW(
+    io->template get_if<typename TestFixture::resolve_t>(),
+    std::system_error
+  );
+}
+
+
+TYPED_TEST(net_ip_resolver_async, start_resolve_many)
+{
+  // more concurrent lookups than there are worker threads
+  constexpr size_t count = 16;
+  for (auto i = 0U;  i != count;  ++i)
+  {
+    this->resolver.start_resolve(this->queue, this->queue.make_io(),
+      "localhost",
+      "echo"
+    );
+  }
+
+  for (auto i = 0U;  i != count;  ++i)
+  {
+    auto io = this->wait();
+    ASSERT_NE(nullptr, io);
+    auto result = io->template get_if<typename TestFixture::resolve_t>();
+    ASSERT_NE(nullptr, result);
+    EXPECT_LT(0U, result->size);
+  }
+}
+
+
+TYPED_TEST(net_ip_resolver_async, resolve_cache_positive)
+{
+  using namespace std::chrono_literals;
+  TestFixture::resolver_t::resolve_cache_clear();
+  TestFixture::resolver_t::resolve_cache_ttl(1min, 1min);
+  auto hits = TestFixture::resolver_t::resolve_cache_hits();
+  auto misses = TestFixture::resolver_t::resolve_cache_misses();
+
+  std::vector<typename TypeParam::endpoint_t> endpoints[2];
+  for (auto &it: endpoints)
+  {
+    this->resolver.start_resolve(this->queue, this->queue.make_io(),
+      "localhost",
+      "echo"
+    );
+
+    auto io = this->wait();
+    ASSERT_NE(nullptr, io);
+    auto result = io->template get_if<typename TestFixture::resolve_t>();
+    ASSERT_NE(nullptr, result);
+    it.assign(result->begin(), result->end());
+  }
+
+  EXPECT_FALSE(endpoints[0].empty());
+  EXPECT_EQ(endpoints[0], endpoints[1]);
+  EXPECT_EQ(hits + 1, TestFixture::resolver_t::resolve_cache_hits());
+  EXPECT_EQ(misses + 1, TestFixture::resolver_t::resolve_cache_misses());
+}
+
+
+TYPED_TEST(net_ip_resolver_async, resolve_cache_negative)
+{
+  using namespace std::chrono_literals;
+  TestFixture::resolver_t::resolve_cache_clear();
+  TestFixture::resolver_t::resolve_cache_ttl(1min, 1min);
+  auto hits = TestFixture::resolver_t::resolve_cache_hits();
+
+  for (auto i = 0;  i != 2;  ++i)
+  {
+    this->resolver.start_resolve(this->queue, this->queue.make_io(),
+      "localhost",
+      nullptr,
+      this->resolver.numeric_host
+    );
+
+    auto io = this->wait();
+    ASSERT_NE(nullptr, io);
+    std::error_code error;
+    auto result = io->template get_if<typename TestFixture::resolve_t>(error);
+    ASSERT_NE(nullptr, result);
+    EXPECT_EQ(sal::net::ip::resolver_errc::host_not_found, error);
+  }
+
+  EXPECT_EQ(hits + 1, TestFixture::resolver_t::resolve_cache_hits());
+}
+
+
+TYPED_TEST(net_ip_resolver_async, resolve_cache_expired)
+{
+  using namespace std::chrono_literals;
+  TestFixture::resolver_t::resolve_cache_clear();
+  TestFixture::resolver_t::resolve_cache_ttl(1ms, 1ms);
+  auto hits = TestFixture::resolver_t::resolve_cache_hits();
+
+  for (auto i = 0;  i != 2;  ++i)
+  {
+    this->resolver.start_resolve(this->queue, this->queue.make_io(),
+      "localhost",
+      "echo"
+    );
+    auto io = this->wait();
+    ASSERT_NE(nullptr, io);
+    EXPECT_NE(nullptr, io->template get_if<typename TestFixture::resolve_t>());
+    std::this_thread::sleep_for(5ms);
+  }
+
+  EXPECT_EQ(hits, TestFixture::resolver_t::resolve_cache_hits());
+}
+
+
+TYPED_TEST(net_ip_resolver_async, resolve_cache_disabled)
+{
+  auto hits = TestFixture::resolver_t::resolve_cache_hits();
+  auto misses = TestFixture::resolver_t::resolve_cache_misses();
+
+  for (auto i = 0;  i != 2;  ++i)
+  {
+    this->resolver.start_resolve(this->queue, this->queue.make_io(),
+      "localhost",
+      "echo"
+    );
+    auto io = this->wait();
+    ASSERT_NE(nullptr, io);
+    EXPECT_NE(nullptr, io->template get_if<typename TestFixture::resolve_t>());
+  }
+
+  EXPECT_EQ(hits, TestFixture::resolver_t::resolve_cache_hits());
+  EXPECT_EQ(misses, TestFixture::resolver_t::resolve_cache_misses());
+}
+
+
 } // namespace
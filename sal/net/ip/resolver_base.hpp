@@ -8,6 +8,8 @@
 
 #include <sal/config.hpp>
 #include <sal/net/ip/__bits/inet.hpp>
+#include <sal/net/ip/__bits/resolver.hpp>
+#include <chrono>
 
 
 __sal_begin
@@ -72,6 +74,59 @@ public:
   static constexpr flags_t address_configured = AI_ADDRCONFIG;
 
 
+  /**
+   * Set time to live for answers of asynchronous resolve operations (see
+   * basic_resolver_t::start_resolve()) kept in process-wide cache. Queries
+   * with same parameters are answered from cache until answer expires.
+   * \a positive applies to successful answers and \a negative to answers
+   * about host or service that does not exist (other errors are not
+   * cached). Zero time to live disables caching of respective answers (both
+   * zero is default and clears cache).
+   *
+   * Note: OS resolver does not report record's DNS TTL, i.e. given value is
+   * used for all answers.
+   */
+  template <typename Rep, typename Period>
+  static void resolve_cache_ttl (
+    const std::chrono::duration<Rep, Period> &positive,
+    const std::chrono::duration<Rep, Period> &negative) noexcept
+  {
+    using namespace std::chrono;
+    __bits::resolve_cache_ttl(
+      duration_cast<milliseconds>(positive),
+      duration_cast<milliseconds>(negative)
+    );
+  }
+
+
+  /**
+   * Drop all answers from asynchronous resolve operations' cache.
+   */
+  static void resolve_cache_clear () noexcept
+  {
+    __bits::resolve_cache_clear();
+  }
+
+
+  /**
+   * Return number of asynchronous resolve operations answered from cache.
+   */
+  static size_t resolve_cache_hits () noexcept
+  {
+    return __bits::resolve_cache_hits();
+  }
+
+
+  /**
+   * Return number of asynchronous resolve operations not found in cache
+   * (while caching is enabled).
+   */
+  static size_t resolve_cache_misses () noexcept
+  {
+    return __bits::resolve_cache_misses();
+  }
+
+
 protected:
 
   ~resolver_base_t () noexcept
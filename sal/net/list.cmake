@@ -12,16 +12,21 @@ list(APPEND sal_sources
   sal/net/error.cpp
   sal/net/socket.hpp
   sal/net/socket_base.hpp
+  sal/net/socket_group.hpp
   sal/net/socket_options.hpp
 
   sal/net/async/__bits/async.hpp
   sal/net/async/__bits/async.cpp
   sal/net/async/completion_queue.hpp
+  sal/net/async/coroutine.hpp
   sal/net/async/io.hpp
+  sal/net/async/secure_socket.hpp
   sal/net/async/service.hpp
 
   sal/net/internet.hpp
   sal/net/ip/__bits/inet.hpp
+  sal/net/ip/__bits/resolver.hpp
+  sal/net/ip/__bits/resolver.cpp
   sal/net/ip/address.hpp
   sal/net/ip/address_v4.hpp
   sal/net/ip/address_v4.cpp
@@ -47,6 +52,7 @@ list(APPEND sal_unittests_sources
   sal/net/init.test.cpp
   sal/net/error.test.cpp
   sal/net/socket.test.cpp
+  sal/net/socket_group.test.cpp
 
   sal/net/async/io.test.cpp
   sal/net/async/completion_queue.test.cpp
@@ -55,6 +61,8 @@ list(APPEND sal_unittests_sources
   sal/net/async/datagram_socket.test.cpp
   sal/net/async/stream_socket.test.cpp
   sal/net/async/socket_acceptor.test.cpp
+  sal/net/async/coroutine.test.cpp
+  sal/net/async/secure_socket.test.cpp
 
   sal/net/ip/address.test.cpp
   sal/net/ip/address_v4.test.cpp
@@ -0,0 +1,143 @@
+#pragma once
+
+/**
+ * \file sal/net/socket_group.hpp
+ * Group of sockets sharing same local endpoint (SO_REUSEPORT)
+ */
+
+
+#include <sal/config.hpp>
+#include <sal/net/basic_socket_acceptor.hpp>
+#include <sal/net/error.hpp>
+#include <sal/net/socket_options.hpp>
+#include <type_traits>
+#include <vector>
+
+
+__sal_begin
+
+
+namespace net {
+
+
+#if SO_REUSEPORT
+
+
+/**
+ * Open \a size sockets of type \a Socket (basic_datagram_socket_t or
+ * basic_socket_acceptor_t), set reuse_port on each and bind all to
+ * \a endpoint. If \a endpoint has port 0, first socket is bound to ephemeral
+ * port and remaining ones to same port. Acceptors are also put into listening
+ * state.
+ *
+ * Incoming datagrams or connections are distributed among group sockets by
+ * OS. With \a steering other than reuse_port_steering_t::none, socket is
+ * selected by that policy (see reuse_port_steering()) which keeps each flow
+ * on same socket and allows application to keep flow's state local to thread
+ * handling that socket.
+ *
+ * On failure, set \a error and return empty group.
+ *
+ * \note Steering is supported only on Linux, on other platforms it fails
+ * with std::errc::operation_not_supported.
+ */
+template <typename Socket>
+std::vector<Socket> make_socket_group (size_t size,
+  const typename Socket::endpoint_t &endpoint,
+  reuse_port_steering_t steering,
+  std::error_code &error)
+{
+  constexpr bool is_acceptor = std::is_same_v<Socket,
+    basic_socket_acceptor_t<typename Socket::protocol_t>
+  >;
+
+  std::vector<Socket> group;
+  if (!size)
+  {
+    error = std::make_error_code(std::errc::invalid_argument);
+    return group;
+  }
+
+#if !__sal_os_linux || !defined(SO_ATTACH_REUSEPORT_CBPF)
+  if (steering != reuse_port_steering_t::none)
+  {
+    error = std::make_error_code(std::errc::operation_not_supported);
+    return group;
+  }
+#endif
+
+  group.reserve(size);
+  auto bind_endpoint = endpoint;
+  while (group.size() != size)
+  {
+    auto &socket = group.emplace_back();
+    socket.open(bind_endpoint.protocol(), error);
+    if (!error)
+    {
+      socket.set_option(reuse_port(true), error);
+    }
+    if (!error)
+    {
+      socket.bind(bind_endpoint, error);
+    }
+    if constexpr (is_acceptor)
+    {
+      if (!error)
+      {
+        socket.listen(socket_base_t::max_listen_connections, error);
+      }
+    }
+    if (!error && group.size() == 1)
+    {
+      bind_endpoint = socket.local_endpoint(error);
+    }
+    if (error)
+    {
+      group.clear();
+      return group;
+    }
+  }
+
+#if __sal_os_linux && defined(SO_ATTACH_REUSEPORT_CBPF)
+  if (steering != reuse_port_steering_t::none)
+  {
+    group.front().set_option(
+      reuse_port_steering(steering, static_cast<uint32_t>(size)),
+      error
+    );
+    if (error)
+    {
+      group.clear();
+    }
+  }
+#endif
+
+  return group;
+}
+
+
+/**
+ * \see make_socket_group(size_t, const typename Socket::endpoint_t &,
+ * reuse_port_steering_t, std::error_code &)
+ * \throws std::system_error on failure
+ */
+template <typename Socket>
+std::vector<Socket> make_socket_group (size_t size,
+  const typename Socket::endpoint_t &endpoint,
+  reuse_port_steering_t steering = reuse_port_steering_t::none)
+{
+  return make_socket_group<Socket>(size,
+    endpoint,
+    steering,
+    throw_on_error("make_socket_group")
+  );
+}
+
+
+#endif // SO_REUSEPORT
+
+
+} // namespace net
+
+
+__sal_end
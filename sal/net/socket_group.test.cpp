@@ -0,0 +1,218 @@
+#include <sal/net/socket_group.hpp>
+#include <sal/net/ip/tcp.hpp>
+#include <sal/net/ip/udp.hpp>
+#include <sal/common.test.hpp>
+#include <algorithm>
+#include <thread>
+
+
+#if SO_REUSEPORT
+
+
+namespace {
+
+
+using namespace std::chrono_literals;
+
+using udp_socket_t = sal::net::ip::udp_t::socket_t;
+using tcp_acceptor_t = sal::net::ip::tcp_t::acceptor_t;
+using sal::net::reuse_port_steering_t;
+
+
+struct net_socket_group
+  : public sal_test::fixture
+{
+  const sal::net::ip::udp_t::endpoint_t udp_endpoint{
+    sal::net::ip::address_v4_t::loopback,
+    0
+  };
+
+  const sal::net::ip::tcp_t::endpoint_t tcp_endpoint{
+    sal::net::ip::address_v4_t::loopback,
+    0
+  };
+
+
+  // return index of group socket that received datagram or group size
+  size_t receive (std::vector<udp_socket_t> &group)
+  {
+    std::this_thread::sleep_for(1ms);
+    for (auto i = 0U;  i != group.size();  ++i)
+    {
+      if (group[i].available())
+      {
+        char buf[1024];
+        (void)group[i].receive(buf);
+        return i;
+      }
+    }
+    return group.size();
+  }
+};
+
+
+TEST_F(net_socket_group, datagram) //{{{1
+{
+  auto group = sal::net::make_socket_group<udp_socket_t>(4, udp_endpoint);
+  ASSERT_EQ(4U, group.size());
+
+  auto endpoint = group.front().local_endpoint();
+  EXPECT_NE(0U, endpoint.port());
+  for (auto &socket: group)
+  {
+    bool value = false;
+    socket.get_option(sal::net::reuse_port(&value));
+    EXPECT_TRUE(value);
+    EXPECT_EQ(endpoint, socket.local_endpoint());
+  }
+
+  udp_socket_t sender{sal::net::ip::udp_t::v4};
+  sender.send_to(case_name, endpoint);
+  EXPECT_NE(group.size(), receive(group));
+}
+
+
+TEST_F(net_socket_group, acceptor) //{{{1
+{
+  auto group = sal::net::make_socket_group<tcp_acceptor_t>(2, tcp_endpoint);
+  ASSERT_EQ(2U, group.size());
+
+  auto endpoint = group.front().local_endpoint();
+  EXPECT_EQ(endpoint, group.back().local_endpoint());
+
+  sal::net::ip::tcp_t::socket_t client;
+  client.connect(endpoint);
+  std::this_thread::sleep_for(1ms);
+
+  size_t accepted = 0;
+  for (auto &acceptor: group)
+  {
+    acceptor.non_blocking(true);
+    std::error_code error;
+    if (acceptor.accept(error).is_open())
+    {
+      ++accepted;
+    }
+  }
+  EXPECT_EQ(1U, accepted);
+}
+
+
+TEST_F(net_socket_group, empty) //{{{1
+{
+  std::error_code error;
+  auto group = sal::net::make_socket_group<udp_socket_t>(0,
+    udp_endpoint,
+    reuse_port_steering_t::none,
+    error
+  );
+  EXPECT_EQ(std::errc::invalid_argument, error);
+  EXPECT_TRUE(group.empty());
+
+  EXPECT_THROW(
+    sal::net::make_socket_group<udp_socket_t>(0, udp_endpoint),
+    std::system_error
+  );
+}
+
+
+TEST_F(net_socket_group, bind_conflict) //{{{1
+{
+  // without reuse_port, endpoint is taken
+  udp_socket_t socket{udp_endpoint};
+
+  std::error_code error;
+  auto group = sal::net::make_socket_group<udp_socket_t>(2,
+    socket.local_endpoint(),
+    reuse_port_steering_t::none,
+    error
+  );
+  EXPECT_EQ(std::errc::address_in_use, error);
+  EXPECT_TRUE(group.empty());
+}
+
+
+#if __sal_os_linux
+
+
+TEST_F(net_socket_group, steering_flow_hash) //{{{1
+{
+  auto group = sal::net::make_socket_group<udp_socket_t>(4,
+    udp_endpoint,
+    reuse_port_steering_t::flow_hash
+  );
+  ASSERT_EQ(4U, group.size());
+
+  // datagrams of same flow end up in same socket, different flows (source
+  // ports) are spread over group
+  std::vector<size_t> flows_per_socket(group.size());
+  for (auto flow = 0;  flow != 64;  ++flow)
+  {
+    udp_socket_t sender{sal::net::ip::udp_t::v4};
+    sender.connect(group.front().local_endpoint());
+    sender.send(case_name);
+    auto index = receive(group);
+    ASSERT_NE(group.size(), index);
+    sender.send(case_name);
+    EXPECT_EQ(index, receive(group));
+    flows_per_socket[index]++;
+  }
+
+  auto receiving_sockets = std::count_if(
+    flows_per_socket.begin(), flows_per_socket.end(),
+    [](auto flows) { return flows > 0; }
+  );
+  EXPECT_LT(1, receiving_sockets);
+}
+
+
+TEST_F(net_socket_group, steering_cpu) //{{{1
+{
+  auto group = sal::net::make_socket_group<udp_socket_t>(4,
+    udp_endpoint,
+    reuse_port_steering_t::cpu
+  );
+  ASSERT_EQ(4U, group.size());
+
+  udp_socket_t sender{sal::net::ip::udp_t::v4};
+  sender.send_to(case_name, group.front().local_endpoint());
+  EXPECT_NE(group.size(), receive(group));
+}
+
+
+TEST_F(net_socket_group, steering_acceptor) //{{{1
+{
+  auto group = sal::net::make_socket_group<tcp_acceptor_t>(2,
+    tcp_endpoint,
+    reuse_port_steering_t::flow_hash
+  );
+  ASSERT_EQ(2U, group.size());
+}
+
+
+#else
+
+
+TEST_F(net_socket_group, steering_not_supported) //{{{1
+{
+  std::error_code error;
+  auto group = sal::net::make_socket_group<udp_socket_t>(2,
+    udp_endpoint,
+    reuse_port_steering_t::flow_hash,
+    error
+  );
+  EXPECT_EQ(std::errc::operation_not_supported, error);
+  EXPECT_TRUE(group.empty());
+}
+
+
+#endif
+
+
+//}}}1
+
+
+} // namespace
+
+
+#endif // SO_REUSEPORT
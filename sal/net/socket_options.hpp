@@ -23,6 +23,11 @@
 #include <sal/net/__bits/socket.hpp>
 #include <chrono>
 
+#if __sal_os_linux
+  #include <linux/filter.h>
+  #include <linux/if_ether.h>
+#endif
+
 
 __sal_begin
 
@@ -237,6 +242,149 @@ inline auto reuse_port (bool *value) noexcept
 }
 
 
+/**
+ * Policy for selecting socket from group of sockets bound to same endpoint
+ * (with reuse_port set) for incoming datagram or connection.
+ * \see reuse_port_steering()
+ */
+enum class reuse_port_steering_t
+{
+  /// OS default
+  none,
+  /// Receiving CPU index modulo group size
+  cpu,
+  /// Flow hash (source and destination addresses and ports) modulo group
+  /// size
+  flow_hash,
+};
+
+
+#if __sal_os_linux && defined(SO_ATTACH_REUSEPORT_CBPF)
+
+
+namespace __bits {
+
+
+struct reuse_port_cbpf_setter_t
+{
+  static constexpr int level = SOL_SOCKET;
+  static constexpr int name = SO_ATTACH_REUSEPORT_CBPF;
+
+  using native_t = ::sock_fprog;
+  ::sock_filter program[48]{};
+  unsigned short program_size{};
+
+  reuse_port_cbpf_setter_t (reuse_port_steering_t steering,
+      uint32_t group_size) noexcept
+  {
+    if (steering == reuse_port_steering_t::none)
+    {
+      // out of range index makes kernel fall back to default selection
+      emit(BPF_STMT(BPF_RET | BPF_K, ~0U));
+    }
+    else if (steering == reuse_port_steering_t::cpu)
+    {
+      // A = cpu, A %= group_size, return A
+      emit(BPF_STMT(BPF_LD | BPF_W | BPF_ABS, ad + SKF_AD_CPU));
+      emit(BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, group_size));
+      emit(BPF_STMT(BPF_RET | BPF_A, 0));
+    }
+    else
+    {
+      flow_hash(group_size);
+    }
+  }
+
+  void store (native_t &value) const noexcept
+  {
+    value.len = program_size;
+    value.filter = const_cast<::sock_filter *>(program);
+  }
+
+private:
+
+  // ancillary data and IP header fields are loaded relative to negative
+  // special offsets (data offset points past transport header while
+  // reuseport program runs)
+  static constexpr uint32_t ad = static_cast<uint32_t>(SKF_AD_OFF);
+  static constexpr uint32_t net = static_cast<uint32_t>(SKF_NET_OFF);
+
+  void emit (const ::sock_filter &insn) noexcept
+  {
+    program[program_size++] = insn;
+  }
+
+  // A ^= 32bit word at network header + offset (X is clobbered)
+  void xor_net_word (uint32_t offset) noexcept
+  {
+    emit(BPF_STMT(BPF_MISC | BPF_TAX, 0));
+    emit(BPF_STMT(BPF_LD | BPF_W | BPF_ABS, net + offset));
+    emit(BPF_STMT(BPF_ALU | BPF_XOR | BPF_X, 0));
+  }
+
+  void flow_hash (uint32_t group_size) noexcept
+  {
+    // skb->hash (SKF_AD_RXHASH) is not set for local traffic and NICs
+    // without RSS, hash addresses and ports (4-tuple) from headers instead.
+    // Other than IPv4/IPv6 (without extension headers) traffic falls back
+    // to default selection.
+    emit(BPF_STMT(BPF_LD | BPF_W | BPF_ABS, ad + SKF_AD_PROTOCOL));
+    auto is_v4 = program_size;
+    emit(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, ETH_P_IP, 0, 0));
+
+    // IPv4: A = ports ^ saddr ^ daddr (ports follow variable length header)
+    emit(BPF_STMT(BPF_LDX | BPF_B | BPF_MSH, net));
+    emit(BPF_STMT(BPF_LD | BPF_W | BPF_IND, net));
+    xor_net_word(12);
+    xor_net_word(16);
+    auto v4_done = program_size;
+    emit(BPF_STMT(BPF_JMP | BPF_JA, 0));
+
+    program[is_v4].jf = program_size - is_v4 - 1;
+    auto is_v6 = program_size;
+    emit(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, ETH_P_IPV6, 0, 0));
+
+    // IPv6: A = ports ^ saddr[0..3] ^ daddr[0..3]
+    emit(BPF_STMT(BPF_LD | BPF_W | BPF_ABS, net + 40));
+    for (uint32_t offset = 8;  offset != 40;  offset += 4)
+    {
+      xor_net_word(offset);
+    }
+
+    // A = (A * golden ratio) >> 16, A %= group_size, return A
+    program[v4_done].k = program_size - v4_done - 1;
+    emit(BPF_STMT(BPF_ALU | BPF_MUL | BPF_K, 0x9e3779b1));
+    emit(BPF_STMT(BPF_ALU | BPF_RSH | BPF_K, 16));
+    emit(BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, group_size));
+    emit(BPF_STMT(BPF_RET | BPF_A, 0));
+
+    program[is_v6].jf = program_size - is_v6 - 1;
+    emit(BPF_STMT(BPF_RET | BPF_K, ~0U));
+  }
+};
+
+
+} // namespace __bits
+
+
+/**
+ * Attach classic BPF program to reuse_port group of socket that selects
+ * receiving socket by \a steering policy from \a group_size sockets (in
+ * order they were bound). Socket must be already bound.
+ *
+ * \note Linux only.
+ */
+inline auto reuse_port_steering (reuse_port_steering_t steering,
+  uint32_t group_size) noexcept
+  -> __bits::reuse_port_cbpf_setter_t
+{
+  return {steering, group_size};
+}
+
+
+#endif // SO_ATTACH_REUSEPORT_CBPF
+
+
 #endif // SO_REUSEPORT
 
 
@@ -325,6 +473,114 @@ inline auto send_low_watermark (int *value) noexcept
 }
 
 
+#if __sal_os_linux && defined(UDP_SEGMENT)
+
+
+/**
+ * Set UDP generic segmentation offload segment size. With non-zero \a value,
+ * each sent buffer is split by kernel (or NIC) into datagrams of \a value
+ * bytes (last may be shorter).
+ */
+inline auto udp_segment (int value) noexcept
+  -> __bits::socket_option_setter_t<SOL_UDP, UDP_SEGMENT, int>
+{
+  return value;
+}
+
+
+/**
+ * Query UDP generic segmentation offload segment size.
+ */
+inline auto udp_segment (int *value) noexcept
+  -> __bits::socket_option_getter_t<SOL_UDP, UDP_SEGMENT, int>
+{
+  return value;
+}
+
+
+/**
+ * Set whether kernel may coalesce received UDP datagrams from same sender
+ * into single buffer (generic receive offload).
+ */
+inline auto udp_gro (bool value) noexcept
+  -> __bits::socket_option_setter_t<SOL_UDP, UDP_GRO, bool>
+{
+  return value;
+}
+
+
+/**
+ * Query whether UDP generic receive offload is enabled.
+ */
+inline auto udp_gro (bool *value) noexcept
+  -> __bits::socket_option_getter_t<SOL_UDP, UDP_GRO, bool>
+{
+  return value;
+}
+
+
+#endif // UDP_SEGMENT
+
+
+#if __sal_os_linux && defined(SO_BUSY_POLL)
+
+
+/**
+ * Set approximate time in microseconds to busy poll device queue on blocking
+ * receive when there is no data.
+ *
+ * \note Linux only. Raising above net.core.busy_poll requires
+ * CAP_NET_ADMIN.
+ */
+inline auto busy_poll (int value) noexcept
+  -> __bits::socket_option_setter_t<SOL_SOCKET, SO_BUSY_POLL, int>
+{
+  return value;
+}
+
+
+/**
+ * Query busy polling time in microseconds.
+ */
+inline auto busy_poll (int *value) noexcept
+  -> __bits::socket_option_getter_t<SOL_SOCKET, SO_BUSY_POLL, int>
+{
+  return value;
+}
+
+
+#if defined(SO_PREFER_BUSY_POLL)
+
+
+/**
+ * Set whether device queue is processed only by busy polling (while
+ * application keeps polling), suppressing interrupts.
+ *
+ * \note Linux only.
+ */
+inline auto prefer_busy_poll (bool value) noexcept
+  -> __bits::socket_option_setter_t<SOL_SOCKET, SO_PREFER_BUSY_POLL, bool>
+{
+  return value;
+}
+
+
+/**
+ * Query whether busy polling is preferred.
+ */
+inline auto prefer_busy_poll (bool *value) noexcept
+  -> __bits::socket_option_getter_t<SOL_SOCKET, SO_PREFER_BUSY_POLL, bool>
+{
+  return value;
+}
+
+
+#endif // SO_PREFER_BUSY_POLL
+
+
+#endif // SO_BUSY_POLL
+
+
 namespace __bits {
 
 